@@ -15,6 +15,7 @@
 #include <libethereum/LastBlockHashesFace.h>
 #include <libethereum/StandardTrace.h>
 #include <libevm/VMFactory.h>
+#include <libevm/VMProfiler.h>
 
 #include <aleth/buildinfo.h>
 
@@ -134,6 +135,10 @@ int main(int argc, char** argv)
     addGeneralOption("version,v", "Show the version and exit.");
     addGeneralOption("help,h", "Show this help message and exit.");
     addGeneralOption("author", po::value<Address>(), "<a> Set author");
+    addGeneralOption("profile", po::value<string>()->implicit_value("-")->value_name("<path>"),
+        "Count executions, CPU cycles and gas per opcode and code hash. Write them to <path> "
+        "(default: stdout) as folded stacks for flamegraph.pl; the stats mode also prints them "
+        "as a table.");
     addGeneralOption("difficulty", po::value<u256>(), "<n> Set difficulty");
     addGeneralOption("number",
         po::value<int64_t>()->default_value(0)->value_name("<number>")->notifier([&](int64_t _n) {
@@ -325,12 +330,28 @@ int main(int argc, char** argv)
     else if (mode == Mode::Trace)
         onOp = st.onOp();
 
+    if (vm.count("profile"))
+        VMProfiler::instance().setEnabled(true);
+
     Timer timer;
     executive.go(onOp);
     double execTime = timer.elapsed();
     executive.finalize();
     bytes output = std::move(res.output);
 
+    if (vm.count("profile"))
+    {
+        VMProfiler::instance().setEnabled(false);
+        auto const profiles = VMProfiler::instance().profiles();
+        auto const profilePath = vm["profile"].as<string>();
+        if (profilePath == "-")
+            cout << foldedStacks(profiles);
+        else
+            writeFile(profilePath, asBytes(foldedStacks(profiles)));
+        if (mode == Mode::Statistics)
+            cout << "Profile:\n" << profileTable(profiles);
+    }
+
     if (mode == Mode::Statistics)
     {
         cout << "Gas used: " << res.gasUsed << " (+"
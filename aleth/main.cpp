@@ -21,6 +21,9 @@
 #include <libethashseal/GenesisInfo.h>
 #include <libethcore/Common.h>
 #include <libethcore/KeyManager.h>
+#include <libethereum/BlockChainCaches.h>
+#include <libethereum/ChainArchive.h>
+#include <libethereum/LogIndex.h>
 #include <libethereum/SnapshotImporter.h>
 #include <libethereum/SnapshotStorage.h>
 #include <libevm/VMFactory.h>
@@ -75,6 +78,7 @@ enum class OperationMode
 {
     Node,
     Import,
+    ImportBulk,
     ImportSnapshot,
     Export
 };
@@ -83,7 +87,8 @@ enum class Format
 {
     Binary,
     Hex,
-    Human
+    Human,
+    Archive
 };
 
 void stopSealingAfterXBlocks(eth::Client* _c, unsigned _start, unsigned& io_mining)
@@ -130,6 +135,9 @@ int main(int argc, char** argv)
     Format exportFormat = Format::Binary;
 
     bool ipc = true;
+    unsigned rpcCallThreads = 0;
+    CallLimits callLimits;
+    LogQueryLimits logQueryLimits;
 
     string jsonAdmin;
     ChainParams chainParams;
@@ -214,6 +222,23 @@ int main(int argc, char** argv)
     addClientOption("ipcpath", po::value<string>()->value_name("<path>"),
         "Set .ipc socket path (default: data directory)");
     addClientOption("no-ipc", "Disable IPC server");
+    addClientOption("rpc-call-threads", po::value<unsigned>()->value_name("<n>"),
+        "Number of threads executing eth_call and eth_estimateGas (default: number of CPU cores)");
+    addClientOption("rpc-call-gas-limit", po::value<u256>()->value_name("<gas>"),
+        ("Gas limit of eth_call and eth_estimateGas (default: " + toString(callLimits.gas) + ")")
+            .c_str());
+    addClientOption("rpc-call-timeout", po::value<unsigned>()->value_name("<ms>"),
+        ("Time limit of eth_call and eth_estimateGas in milliseconds, 0 for none (default: " +
+            toString(callLimits.time.count()) + ")")
+            .c_str());
+    addClientOption("rpc-logs-max-results", po::value<size_t>()->value_name("<n>"),
+        ("Maximum number of logs returned by eth_getLogs, 0 for none (default: " +
+            toString(logQueryLimits.maxResults) + ")")
+            .c_str());
+    addClientOption("rpc-logs-timeout", po::value<unsigned>()->value_name("<ms>"),
+        ("Time limit of eth_getLogs in milliseconds, 0 for none (default: " +
+            toString(logQueryLimits.time.count()) + ")")
+            .c_str());
     addClientOption("admin", po::value<string>()->value_name("<password>"),
         "Specify admin session key for JSON-RPC (default: auto-generated and printed at "
         "start-up)");
@@ -221,7 +246,13 @@ int main(int argc, char** argv)
     addClientOption("rebuild,R",
         "Rebuild the blockchain from the existing database. This involves reimporting all blocks "
         "and will probably take a while.");
-    addClientOption("rescue", "Attempt to rescue a corrupt database\n");
+    addClientOption("rescue", "Attempt to rescue a corrupt database");
+    addClientOption("reindex-extras",
+        "Recompute the block details, hashes, transaction addresses and blooms from the stored "
+        "blocks and receipts, without reimporting the blocks");
+    addClientOption("log-index",
+        "Keep an index of the addresses and topics of the logs, from the current block on, to "
+        "speed up log queries\n");
     addClientOption("import-presale", po::value<string>()->value_name("<file>"),
         "Import a pre-sale key; you'll need to specify the password to this key");
     addClientOption("import-secret,s", po::value<string>()->value_name("<secret>"),
@@ -306,6 +337,9 @@ int main(int argc, char** argv)
         "import,I", po::value<string>()->value_name("<file>"), "Import blocks from file");
     addImportExportOption(
         "export,E", po::value<string>()->value_name("<file>"), "Export blocks to file");
+    addImportExportOption("import-bulk", po::value<string>()->value_name("<file>"),
+        "Import blocks from file straight into the blockchain, checking them on all cores; an "
+        "interrupted import can be resumed with the same file");
     addImportExportOption("from", po::value<string>()->value_name("<n>"),
         "Export only from block n; n may be a decimal, a '0x' prefixed hash, or 'latest'");
     addImportExportOption("to", po::value<string>()->value_name("<n>"),
@@ -313,8 +347,9 @@ int main(int argc, char** argv)
         "'latest'");
     addImportExportOption("only", po::value<string>()->value_name("<n>"),
         "Equivalent to --export-from n --export-to n");
-    addImportExportOption(
-        "format", po::value<string>()->value_name("<binary/hex/human>"), "Set export format");
+    addImportExportOption("format", po::value<string>()->value_name("<binary/hex/human/archive>"),
+        "Set export format; archive writes compressed segments with an index, which --import-bulk "
+        "reads");
     addImportExportOption("dont-check",
         "Prevent checking some block aspects. Faster importing, but to apply only when the data is "
         "known to be valid");
@@ -345,6 +380,7 @@ int main(int argc, char** argv)
 
     po::options_description vmOptions = vmProgramOptions(c_lineWidth);
     po::options_description dbOptions = db::databaseProgramOptions(c_lineWidth);
+    po::options_description chainCacheOptions = blockChainCacheProgramOptions(c_lineWidth);
     po::options_description minerOptions = MinerCLI::createProgramOptions(c_lineWidth);
 
     po::options_description allowedOptions("Allowed options");
@@ -356,6 +392,7 @@ int main(int argc, char** argv)
         .add(importExportMode)
         .add(vmOptions)
         .add(dbOptions)
+        .add(chainCacheOptions)
         .add(loggingProgramOptions)
         .add(generalOptions);
 
@@ -440,6 +477,16 @@ int main(int argc, char** argv)
         ipc = true;
     if (vm.count("no-ipc"))
         ipc = false;
+    if (vm.count("rpc-call-threads"))
+        rpcCallThreads = vm["rpc-call-threads"].as<unsigned>();
+    if (vm.count("rpc-call-gas-limit"))
+        callLimits.gas = vm["rpc-call-gas-limit"].as<u256>();
+    if (vm.count("rpc-call-timeout"))
+        callLimits.time = chrono::milliseconds(vm["rpc-call-timeout"].as<unsigned>());
+    if (vm.count("rpc-logs-max-results"))
+        logQueryLimits.maxResults = vm["rpc-logs-max-results"].as<size_t>();
+    if (vm.count("rpc-logs-timeout"))
+        logQueryLimits.time = chrono::milliseconds(vm["rpc-logs-timeout"].as<unsigned>());
     if (vm.count("mining"))
     {
         string m = vm["mining"].as<string>();
@@ -570,6 +617,11 @@ int main(int argc, char** argv)
         mode = OperationMode::Import;
         filename = vm["import"].as<string>();
     }
+    if (vm.count("import-bulk"))
+    {
+        mode = OperationMode::ImportBulk;
+        filename = vm["import-bulk"].as<string>();
+    }
     if (vm.count("export"))
     {
         mode = OperationMode::Export;
@@ -593,6 +645,8 @@ int main(int argc, char** argv)
             exportFormat = Format::Hex;
         else if (m == "human")
             exportFormat = Format::Human;
+        else if (m == "archive")
+            exportFormat = Format::Archive;
         else
         {
             cerr << "Bad " << "--format" << " option: " << m << "\n";
@@ -634,8 +688,12 @@ int main(int argc, char** argv)
         withExisting = WithExisting::Kill;
     if (vm.count("rebuild"))
         withExisting = WithExisting::Verify;
+    if (vm.count("log-index"))
+        setLogIndexEnabled(true);
     if (vm.count("rescue"))
         withExisting = WithExisting::Rescue;
+    if (vm.count("reindex-extras"))
+        withExisting = WithExisting::ReindexExtras;
     if (vm.count("address"))
         try
         {
@@ -671,7 +729,7 @@ int main(int argc, char** argv)
         AccountManager::streamAccountHelp(cout);
         AccountManager::streamWalletHelp(cout);
         cout << clientDefaultMode << clientTransacting << clientNetworking << clientMining << minerOptions;
-        cout << importExportMode << dbOptions << vmOptions << loggingProgramOptions << generalOptions;
+        cout << importExportMode << dbOptions << chainCacheOptions << vmOptions << loggingProgramOptions << generalOptions;
         return AlethErrors::Success;
     }
 
@@ -761,6 +819,8 @@ int main(int argc, char** argv)
 
     if (!extraData.empty())
         web3.ethereum()->setExtraData(extraData);
+    web3.ethereum()->setCallLimits(callLimits);
+    web3.ethereum()->setLogQueryLimits(logQueryLimits);
 
     auto toNumber = [&](string const& s) -> unsigned {
         if (s == "latest")
@@ -784,6 +844,11 @@ int main(int argc, char** argv)
         ostream& out = (filename.empty() || filename == "--") ? cout : fout;
 
         unsigned last = toNumber(exportTo);
+        if (exportFormat == Format::Archive)
+        {
+            exportChainArchive(web3.ethereum()->blockChain(), toNumber(exportFrom), last, out);
+            return AlethErrors::Success;
+        }
         for (unsigned i = toNumber(exportFrom); i <= last; ++i)
         {
             bytes block = web3.ethereum()->blockChain().block(web3.ethereum()->blockChain().numberHash(i));
@@ -854,6 +919,28 @@ int main(int argc, char** argv)
         return AlethErrors::Success;
     }
 
+    if (mode == OperationMode::ImportBulk)
+    {
+        auto const report = [](BulkImportProgress const& _p) {
+            double const e = max(_p.seconds, 0.001);
+            cout << _p.imported << " imported, " << _p.alreadyKnown << " already known in "
+                 << (round(_p.seconds * 10) / 10) << " seconds at "
+                 << (round(_p.imported * 10 / e) / 10) << " blocks/s, "
+                 << (round(double(_p.gasUsed) / e / 1e5) / 10) << " Mgas/s (#" << _p.lastNumber
+                 << ")\n";
+        };
+        try
+        {
+            web3.ethereum()->importBulk(filename, 10000, report);
+        }
+        catch (...)
+        {
+            cerr << "Error during the bulk import: " << boost::current_exception_diagnostic_information() << endl;
+            return AlethErrors::BulkImportFailure;
+        }
+        return AlethErrors::Success;
+    }
+
     try
     {
         if (keyManager.exists())
@@ -984,7 +1071,7 @@ int main(int argc, char** argv)
 
         sessionManager.reset(new rpc::SessionManager());
         accountHolder.reset(new SimpleAccountHolder([&](){ return web3.ethereum(); }, getAccountPassword, keyManager, authenticator));
-        auto ethFace = new rpc::Eth(*web3.ethereum(), *accountHolder.get());
+        auto ethFace = new rpc::Eth(*web3.ethereum(), *accountHolder.get(), rpcCallThreads);
         rpc::TestFace* testEth = nullptr;
         if (testingMode)
             testEth = new rpc::Test(*web3.ethereum());
@@ -96,6 +96,8 @@ evmc_result execute(evmc_vm* _instance, const evmc_host_interface* _host,
         result.output_size = output.size();
         result.release = delete_output;
     }
+    // The output usually owns the memory of the frame, recycle it.
+    dev::eth::VMMemoryPool::local().release(output.takeBytes());
 
     return result;
 }
@@ -119,6 +121,72 @@ namespace dev
 {
 namespace eth
 {
+namespace
+{
+// Most of the values on the stack fit in a single 64-bit word. The helpers below allow the
+// arithmetic instructions to take a single-word fast path for them and fall back to full
+// 256-bit arithmetic only when an operand is wider or the result overflows the word.
+
+/// @returns true if the value fits in the lowest 64-bit word.
+inline bool fitsWord(intx::uint256 const& _v) noexcept
+{
+    return (_v.lo.hi | _v.hi.lo | _v.hi.hi) == 0;
+}
+
+/// @returns true if the sum of the words does not fit in a word.
+inline bool addOverflow(uint64_t _a, uint64_t _b, uint64_t& o_sum) noexcept
+{
+#if defined(__GNUC__)
+    return __builtin_add_overflow(_a, _b, &o_sum);
+#else
+    o_sum = _a + _b;
+    return o_sum < _a;
+#endif
+}
+
+/// @returns true if the product of the words may not fit in a word.
+inline bool mulOverflow(uint64_t _a, uint64_t _b, uint64_t& o_product) noexcept
+{
+#if defined(__GNUC__)
+    return __builtin_mul_overflow(_a, _b, &o_product);
+#else
+    // Without the builtin only products of 32-bit words are known to fit.
+    o_product = _a * _b;
+    return ((_a | _b) >> 32) != 0;
+#endif
+}
+
+/// Exponentiation by squaring in a single word.
+/// @returns false if the result may not fit in a word.
+inline bool expWord(uint64_t _base, uint64_t _exponent, uint64_t& o_result) noexcept
+{
+    uint64_t result = 1;
+    while (_exponent)
+    {
+        if ((_exponent & 1) && mulOverflow(result, _base, result))
+            return false;
+        _exponent >>= 1;
+        // If bits of the exponent remain, the square will be multiplied into the result, so
+        // its overflow means the result overflows too.
+        if (_exponent && mulOverflow(_base, _base, _base))
+            return false;
+    }
+    o_result = result;
+    return true;
+}
+}  // namespace
+
+VM::VM()
+  : m_mem{VMMemoryPool::local().acquire()}, m_returnData{VMMemoryPool::local().acquire()}
+{}
+
+VM::~VM()
+{
+    auto& pool = VMMemoryPool::local();
+    pool.release(std::move(m_mem));
+    pool.release(std::move(m_returnData));
+}
+
 uint64_t VM::memNeed(intx::uint256 const& _offset, intx::uint256 const& _size)
 {
     return toInt63(_size ? intx::uint512(_offset) + _size : intx::uint512(0));
@@ -199,7 +267,7 @@ void VM::updateMem(uint64_t _newMem)
     m_newMemSize = (_newMem + 31) / 32 * 32;
     updateGas();
     if (m_newMemSize > m_mem.size())
-        m_mem.resize(m_newMemSize);
+        VMMemoryPool::local().resize(m_mem, m_newMemSize);
 }
 
 void VM::logGasMem()
@@ -214,6 +282,8 @@ void VM::logGasMem()
 void VM::fetchInstruction()
 {
     m_OP = Instruction(m_code[m_PC]);
+    if (m_profiler)
+        m_profiler->step(static_cast<uint8_t>(m_OP));
     auto const metric = (*m_metrics)[static_cast<size_t>(m_OP)];
     adjustStack(metric.stack_height_required, metric.stack_height_change);
 
@@ -247,6 +317,11 @@ owning_bytes_ref VM::exec(const evmc_host_interface* _host, evmc_host_context* _
     m_PC = 0;
     m_pCode = _code;
     m_codeSize = _codeSize;
+    if (VMProfiler::instance().enabled())
+    {
+        auto const codeHash = ethash::keccak256(_code, _codeSize);
+        m_profiler.reset(new FrameProfiler{h256{codeHash.bytes, h256::ConstructFromPointer}, m_runGas});
+    }
 
     // trampoline to minimize depth of call stack when calling out
     m_bounce = &VM::initEntry;
@@ -543,7 +618,11 @@ void VM::interpretCases()
             updateIOGas();
 
             intx::uint256 base = m_SP[0];
-            m_SPP[0] = intx::exp(base, expon);
+            uint64_t result;
+            if (fitsWord(base) && fitsWord(expon) && expWord(base.lo.lo, expon.lo.lo, result))
+                m_SPP[0] = result;
+            else
+                m_SPP[0] = intx::exp(base, expon);
         }
         NEXT
 
@@ -557,7 +636,12 @@ void VM::interpretCases()
             updateIOGas();
 
             //pops two items and pushes their sum mod 2^256.
-            m_SPP[0] = m_SP[0] + m_SP[1];
+            uint64_t sum;
+            if (fitsWord(m_SP[0]) && fitsWord(m_SP[1]) &&
+                !addOverflow(m_SP[0].lo.lo, m_SP[1].lo.lo, sum))
+                m_SPP[0] = sum;
+            else
+                m_SPP[0] = m_SP[0] + m_SP[1];
         }
         NEXT
 
@@ -567,7 +651,12 @@ void VM::interpretCases()
             updateIOGas();
 
             //pops two items and pushes their product mod 2^256.
-            m_SPP[0] = m_SP[0] * m_SP[1];
+            uint64_t product;
+            if (fitsWord(m_SP[0]) && fitsWord(m_SP[1]) &&
+                !mulOverflow(m_SP[0].lo.lo, m_SP[1].lo.lo, product))
+                m_SPP[0] = product;
+            else
+                m_SPP[0] = m_SP[0] * m_SP[1];
         }
         NEXT
 
@@ -576,7 +665,10 @@ void VM::interpretCases()
             ON_OP();
             updateIOGas();
 
-            m_SPP[0] = m_SP[0] - m_SP[1];
+            if (fitsWord(m_SP[0]) && fitsWord(m_SP[1]) && m_SP[0].lo.lo >= m_SP[1].lo.lo)
+                m_SPP[0] = m_SP[0].lo.lo - m_SP[1].lo.lo;
+            else
+                m_SPP[0] = m_SP[0] - m_SP[1];
         }
         NEXT
 
@@ -585,7 +677,10 @@ void VM::interpretCases()
             ON_OP();
             updateIOGas();
 
-            m_SPP[0] = m_SP[1] ? m_SP[0] / m_SP[1] : 0;
+            if (fitsWord(m_SP[0]) && fitsWord(m_SP[1]))
+                m_SPP[0] = m_SP[1].lo.lo ? m_SP[0].lo.lo / m_SP[1].lo.lo : 0;
+            else
+                m_SPP[0] = m_SP[1] ? m_SP[0] / m_SP[1] : 0;
         }
         NEXT
 
@@ -604,7 +699,10 @@ void VM::interpretCases()
             ON_OP();
             updateIOGas();
 
-            m_SPP[0] = m_SP[1] ? m_SP[0] % m_SP[1] : 0;
+            if (fitsWord(m_SP[0]) && fitsWord(m_SP[1]))
+                m_SPP[0] = m_SP[1].lo.lo ? m_SP[0].lo.lo % m_SP[1].lo.lo : 0;
+            else
+                m_SPP[0] = m_SP[1] ? m_SP[0] % m_SP[1] : 0;
         }
         NEXT
 
@@ -731,6 +829,9 @@ void VM::interpretCases()
 
             if (m_SP[0] >= 256)
                 m_SPP[0] = 0;
+            else if (m_SP[0] < 64 && fitsWord(m_SP[1]) &&
+                     m_SP[1].lo.lo <= (~uint64_t{0} >> m_SP[0].lo.lo))
+                m_SPP[0] = m_SP[1].lo.lo << m_SP[0].lo.lo;
             else
                 m_SPP[0] = m_SP[1] << unsigned(m_SP[0]);
         }
@@ -747,6 +848,8 @@ void VM::interpretCases()
 
             if (m_SP[0] >= 256)
                 m_SPP[0] = 0;
+            else if (fitsWord(m_SP[1]))
+                m_SPP[0] = m_SP[0] < 64 ? m_SP[1].lo.lo >> m_SP[0].lo.lo : 0;
             else
                 m_SPP[0] = m_SP[1] >> unsigned(m_SP[0]);
         }
@@ -6,6 +6,8 @@
 #include "VMConfig.h"
 
 #include <libevm/VMFace.h>
+#include <libevm/VMMemoryPool.h>
+#include <libevm/VMProfiler.h>
 #include <intx/intx.hpp>
 
 #include <evmc/evmc.h>
@@ -51,7 +53,10 @@ class VM
 public:
     static bool initMetrics();
 
-    VM() = default;
+    VM();
+    ~VM();
+    VM(VM const&) = delete;
+    VM& operator=(VM const&) = delete;
 
     owning_bytes_ref exec(const evmc_host_interface* _host, evmc_host_context* _context,
         evmc_revision _rev, const evmc_message* _msg, uint8_t const* _code, size_t _codeSize);
@@ -145,6 +150,9 @@ private:
     uint64_t decodeJumpDest(const byte* const _code, uint64_t& _pc);
     uint64_t decodeJumpvDest(const byte* const _code, uint64_t& _pc, byte _voff);
 
+    /// Per-opcode counters of this frame, present only when profiling is enabled.
+    std::unique_ptr<FrameProfiler> m_profiler;
+
     template<class T> uint64_t toInt63(T v)
     {
         // check for overflow
@@ -147,7 +147,7 @@ void VM::caseCreate()
             m_SPP[0] = intx::be::load<intx::uint256>(result.create_address);
         else
             m_SPP[0] = 0;
-        m_returnData.assign(result.output_data, result.output_data + result.output_size);
+        VMMemoryPool::local().assign(m_returnData, result.output_data, result.output_size);
 
         m_io_gas -= (msg.gas - result.gas_left);
 
@@ -173,7 +173,7 @@ void VM::caseCall()
     {
         evmc_result result = m_host->call(m_context, &msg);
 
-        m_returnData.assign(result.output_data, result.output_data + result.output_size);
+        VMMemoryPool::local().assign(m_returnData, result.output_data, result.output_size);
         bytesConstRef{&m_returnData}.copyTo(output);
 
         m_SPP[0] = result.status_code == EVMC_SUCCESS ? 1 : 0;
@@ -249,6 +249,8 @@ bool VM::caseCallSetup(evmc_message& o_msg, bytesRef& o_output)
     }
 
     o_msg.gas = toInt63(callGas);
+    if (m_profiler)
+        m_profiler->setOwnGas(m_runGas);
     m_runGas = o_msg.gas;
     updateIOGas();
 
@@ -0,0 +1,164 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#include "BufferedDB.h"
+
+namespace dev
+{
+namespace db
+{
+void BufferedDBWriteBatch::insert(Slice _key, Slice _value)
+{
+    m_writes.emplace_back(_key.toString(), _value.toString());
+}
+
+void BufferedDBWriteBatch::kill(Slice _key)
+{
+    m_writes.emplace_back(_key.toString(), boost::none);
+}
+
+std::string BufferedDB::lookup(Slice _key) const
+{
+    if (m_buffering)
+    {
+        Guard l(x_writes);
+        auto const key = _key.toString();
+        auto const it = m_inserted.find(key);
+        if (it != m_inserted.end())
+            return it->second;
+        if (m_killed.count(key))
+            return {};
+    }
+    return m_db->lookup(_key);
+}
+
+bool BufferedDB::exists(Slice _key) const
+{
+    if (m_buffering)
+    {
+        Guard l(x_writes);
+        auto const key = _key.toString();
+        if (m_inserted.count(key))
+            return true;
+        if (m_killed.count(key))
+            return false;
+    }
+    return m_db->exists(_key);
+}
+
+void BufferedDB::insert(Slice _key, Slice _value)
+{
+    if (!m_buffering)
+    {
+        m_db->insert(_key, _value);
+        return;
+    }
+    Guard l(x_writes);
+    auto key = _key.toString();
+    m_killed.erase(key);
+    m_inserted[std::move(key)] = _value.toString();
+}
+
+void BufferedDB::kill(Slice _key)
+{
+    if (!m_buffering)
+    {
+        m_db->kill(_key);
+        return;
+    }
+    Guard l(x_writes);
+    auto key = _key.toString();
+    m_inserted.erase(key);
+    m_killed.insert(std::move(key));
+}
+
+std::unique_ptr<WriteBatchFace> BufferedDB::createWriteBatch() const
+{
+    if (!m_buffering)
+        return m_db->createWriteBatch();
+    return std::unique_ptr<WriteBatchFace>(new BufferedDBWriteBatch);
+}
+
+void BufferedDB::commit(std::unique_ptr<WriteBatchFace> _batch)
+{
+    if (!_batch)
+        BOOST_THROW_EXCEPTION(DatabaseError() << errinfo_comment("Cannot commit null batch"));
+
+    // A batch of the database, created before buffering, goes to the database.
+    auto* batchPtr = dynamic_cast<BufferedDBWriteBatch*>(_batch.get());
+    if (!batchPtr)
+    {
+        m_db->commit(std::move(_batch));
+        return;
+    }
+
+    Guard l(x_writes);
+    for (auto const& write : batchPtr->writes())
+        if (write.second)
+        {
+            m_killed.erase(write.first);
+            m_inserted[write.first] = *write.second;
+        }
+        else
+        {
+            m_inserted.erase(write.first);
+            m_killed.insert(write.first);
+        }
+}
+
+void BufferedDB::forEach(std::function<bool(Slice, Slice)> _f) const
+{
+    if (!m_buffering)
+    {
+        m_db->forEach(std::move(_f));
+        return;
+    }
+    Guard l(x_writes);
+    bool keepIterating = true;
+    m_db->forEach([&](Slice _key, Slice _value) {
+        auto const key = _key.toString();
+        if (!m_inserted.count(key) && !m_killed.count(key))
+            keepIterating = _f(_key, _value);
+        return keepIterating;
+    });
+    for (auto it = m_inserted.begin(); keepIterating && it != m_inserted.end(); ++it)
+        keepIterating = _f(Slice(it->first), Slice(it->second));
+}
+
+void BufferedDB::buffer()
+{
+    Guard l(x_writes);
+    m_buffering = true;
+}
+
+void BufferedDB::flush()
+{
+    Guard l(x_writes);
+    flushLocked();
+}
+
+void BufferedDB::unbuffer()
+{
+    Guard l(x_writes);
+    flushLocked();
+    m_buffering = false;
+}
+
+void BufferedDB::flushLocked()
+{
+    if (m_inserted.empty() && m_killed.empty())
+        return;
+
+    auto batch = m_db->createWriteBatch();
+    for (auto const& key : m_killed)
+        batch->kill(Slice(key));
+    for (auto const& e : m_inserted)
+        batch->insert(Slice(e.first), Slice(e.second));
+    m_db->commitSynced(std::move(batch));
+    m_inserted.clear();
+    m_killed.clear();
+}
+
+}  // namespace db
+}  // namespace dev
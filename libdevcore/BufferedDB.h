@@ -0,0 +1,82 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#pragma once
+
+#include "Common.h"
+#include "Guards.h"
+#include "db.h"
+
+#include <boost/optional.hpp>
+#include <atomic>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace dev
+{
+namespace db
+{
+class BufferedDBWriteBatch : public WriteBatchFace
+{
+public:
+    void insert(Slice _key, Slice _value) override;
+    void kill(Slice _key) override;
+
+    /// The writes in order, the value of a kill being none.
+    std::vector<std::pair<std::string, boost::optional<std::string>>> const& writes() const
+    {
+        return m_writes;
+    }
+
+private:
+    std::vector<std::pair<std::string, boost::optional<std::string>>> m_writes;
+};
+
+/**
+ * @brief A database which can keep the writes to another one in memory until they are flushed.
+ *
+ * Until buffer() is called, it passes everything to the database, without locking nor copying.
+ * From then on, the writes are kept, reads seeing them, and flush() writes them all to the
+ * database in a single batch synced to the disk: the database has either all of them or none after
+ * a crash, and the cost of syncing is paid once for the whole batch rather than for every commit.
+ * Reads are thread-safe. The writes, buffer() and unbuffer() must come from one thread at a time.
+ */
+class BufferedDB : public DatabaseFace
+{
+public:
+    explicit BufferedDB(std::shared_ptr<DatabaseFace> _db) : m_db(std::move(_db)) {}
+
+    std::string lookup(Slice _key) const override;
+    bool exists(Slice _key) const override;
+    void insert(Slice _key, Slice _value) override;
+    void kill(Slice _key) override;
+
+    std::unique_ptr<WriteBatchFace> createWriteBatch() const override;
+    void commit(std::unique_ptr<WriteBatchFace> _batch) override;
+
+    void forEach(std::function<bool(Slice, Slice)> _f) const override;
+
+    /// Keeps the writes from now on in memory.
+    void buffer();
+    /// Writes the writes kept to the database and forgets them. They are kept if the database
+    /// fails to write them.
+    void flush();
+    /// Flushes the writes kept and writes to the database directly again.
+    void unbuffer();
+
+private:
+    /// Writes the writes kept to the database, x_writes being locked.
+    void flushLocked();
+
+    std::shared_ptr<DatabaseFace> m_db;
+    /// Written under x_writes. Read without it, the writes kept being locked only when buffering.
+    std::atomic<bool> m_buffering{false};
+    std::unordered_map<std::string, std::string> m_inserted;
+    std::unordered_set<std::string> m_killed;
+    mutable Mutex x_writes;
+};
+
+}  // namespace db
+}  // namespace dev
@@ -276,7 +276,8 @@ enum class WithExisting: int
     Trust = 0,
     Verify,
     Rescue,
-    Kill
+    Kill,
+    ReindexExtras
 };
 
 /// Get the current time in seconds since the epoch in UTC
@@ -0,0 +1,42 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+// Built with -mavx2, called only after a runtime check of CPU support.
+
+#include "KeccakLanes.h"
+
+#include <immintrin.h>
+
+namespace
+{
+struct AVX2Lanes
+{
+    using Vector = __m256i;
+    static constexpr size_t width = 4;
+
+    static Vector load(uint64_t const* _p) noexcept
+    {
+        return _mm256_loadu_si256(reinterpret_cast<__m256i const*>(_p));
+    }
+    static void store(uint64_t* _p, Vector _v) noexcept
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(_p), _v);
+    }
+    static Vector broadcast(uint64_t _x) noexcept { return _mm256_set1_epi64x(static_cast<long long>(_x)); }
+    static Vector xor_(Vector _a, Vector _b) noexcept { return _mm256_xor_si256(_a, _b); }
+    static Vector rotl(Vector _v, unsigned _n) noexcept
+    {
+        return _mm256_or_si256(_mm256_slli_epi64(_v, _n), _mm256_srli_epi64(_v, 64 - _n));
+    }
+    static Vector chi(Vector _a, Vector _b, Vector _c) noexcept
+    {
+        return _mm256_xor_si256(_a, _mm256_andnot_si256(_b, _c));
+    }
+};
+}  // namespace
+
+void dev::keccak::keccakf1600x4(uint64_t* _state) noexcept
+{
+    keccakf1600Lanes<AVX2Lanes>(_state);
+}
@@ -0,0 +1,39 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+// Built with -mavx512f, called only after a runtime check of CPU support.
+
+#include "KeccakLanes.h"
+
+#include <immintrin.h>
+
+namespace
+{
+struct AVX512Lanes
+{
+    using Vector = __m512i;
+    static constexpr size_t width = 8;
+
+    static Vector load(uint64_t const* _p) noexcept { return _mm512_loadu_si512(_p); }
+    static void store(uint64_t* _p, Vector _v) noexcept { _mm512_storeu_si512(_p, _v); }
+    static Vector broadcast(uint64_t _x) noexcept { return _mm512_set1_epi64(static_cast<long long>(_x)); }
+    static Vector xor_(Vector _a, Vector _b) noexcept { return _mm512_xor_si512(_a, _b); }
+    static Vector rotl(Vector _v, unsigned _n) noexcept
+    {
+        // The zero-masking form with all lanes selected, the plain one trips GCC's
+        // -Wuninitialized on its undefined pass-through operand.
+        return _mm512_maskz_rolv_epi64(0xFF, _v, _mm512_set1_epi64(_n));
+    }
+    static Vector chi(Vector _a, Vector _b, Vector _c) noexcept
+    {
+        // 0xD2 is the truth table of a ^ (~b & c).
+        return _mm512_ternarylogic_epi64(_a, _b, _c, 0xD2);
+    }
+};
+}  // namespace
+
+void dev::keccak::keccakf1600x8(uint64_t* _state) noexcept
+{
+    keccakf1600Lanes<AVX512Lanes>(_state);
+}
@@ -0,0 +1,82 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+/// @file
+/// Keccak-f[1600] permutation of several interleaved states at once, the building block of
+/// sha3Batch(). Private to libdevcore.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dev
+{
+namespace keccak
+{
+/// The number of 64-bit words of a Keccak-f[1600] state.
+constexpr size_t c_stateWords = 25;
+
+/// Permutes 4 interleaved states, word i of state l being _state[i * 4 + l]. Requires AVX2.
+void keccakf1600x4(uint64_t* _state) noexcept;
+
+/// Permutes 8 interleaved states, word i of state l being _state[i * 8 + l]. Requires AVX-512F.
+void keccakf1600x8(uint64_t* _state) noexcept;
+
+/// Keccak-f[1600] on a vector type holding the same word of Lanes::width independent states.
+/// Lanes provides load(), store(), broadcast(), xor_(), rotl() and chi(a, b, c) = a ^ (~b & c).
+template <class Lanes>
+inline void keccakf1600Lanes(uint64_t* _state) noexcept
+{
+    using Vector = typename Lanes::Vector;
+
+    static constexpr uint64_t c_roundConstants[24] = {0x0000000000000001, 0x0000000000008082,
+        0x800000000000808a, 0x8000000080008000, 0x000000000000808b, 0x0000000080000001,
+        0x8000000080008081, 0x8000000000008009, 0x000000000000008a, 0x0000000000000088,
+        0x0000000080008009, 0x000000008000000a, 0x000000008000808b, 0x800000000000008b,
+        0x8000000000008089, 0x8000000000008003, 0x8000000000008002, 0x8000000000000080,
+        0x000000000000800a, 0x800000008000000a, 0x8000000080008081, 0x8000000000008080,
+        0x0000000080000001, 0x8000000080008008};
+
+    // Rotation offsets of the rho step, indexed by x + 5 * y.
+    static constexpr unsigned c_rho[c_stateWords] = {0, 1, 62, 28, 27, 36, 44, 6, 55, 20, 3, 10,
+        43, 25, 39, 41, 45, 15, 21, 8, 18, 2, 61, 56, 14};
+
+    Vector a[c_stateWords];
+    for (size_t i = 0; i < c_stateWords; ++i)
+        a[i] = Lanes::load(_state + i * Lanes::width);
+
+    for (size_t round = 0; round < 24; ++round)
+    {
+        // Theta.
+        Vector c[5];
+        for (size_t x = 0; x < 5; ++x)
+            c[x] = Lanes::xor_(Lanes::xor_(Lanes::xor_(a[x], a[x + 5]), Lanes::xor_(a[x + 10], a[x + 15])),
+                a[x + 20]);
+        for (size_t x = 0; x < 5; ++x)
+        {
+            Vector const d = Lanes::xor_(c[(x + 4) % 5], Lanes::rotl(c[(x + 1) % 5], 1));
+            for (size_t y = 0; y < 25; y += 5)
+                a[x + y] = Lanes::xor_(a[x + y], d);
+        }
+
+        // Rho and pi.
+        Vector b[c_stateWords];
+        for (size_t x = 0; x < 5; ++x)
+            for (size_t y = 0; y < 5; ++y)
+                b[y + 5 * ((2 * x + 3 * y) % 5)] = Lanes::rotl(a[x + 5 * y], c_rho[x + 5 * y]);
+
+        // Chi.
+        for (size_t y = 0; y < 25; y += 5)
+            for (size_t x = 0; x < 5; ++x)
+                a[x + y] = Lanes::chi(b[x + y], b[(x + 1) % 5 + y], b[(x + 2) % 5 + y]);
+
+        // Iota.
+        a[0] = Lanes::xor_(a[0], Lanes::broadcast(c_roundConstants[round]));
+    }
+
+    for (size_t i = 0; i < c_stateWords; ++i)
+        Lanes::store(_state + i * Lanes::width, a[i]);
+}
+}  // namespace keccak
+}  // namespace dev
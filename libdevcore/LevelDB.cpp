@@ -143,6 +143,18 @@ std::unique_ptr<WriteBatchFace> LevelDB::createWriteBatch() const
 }
 
 void LevelDB::commit(std::unique_ptr<WriteBatchFace> _batch)
+{
+    write(m_writeOptions, std::move(_batch));
+}
+
+void LevelDB::commitSynced(std::unique_ptr<WriteBatchFace> _batch)
+{
+    leveldb::WriteOptions options = m_writeOptions;
+    options.sync = true;
+    write(options, std::move(_batch));
+}
+
+void LevelDB::write(leveldb::WriteOptions const& _options, std::unique_ptr<WriteBatchFace> _batch)
 {
     if (!_batch)
     {
@@ -154,7 +166,7 @@ void LevelDB::commit(std::unique_ptr<WriteBatchFace> _batch)
         BOOST_THROW_EXCEPTION(
             DatabaseError() << errinfo_comment("Invalid batch type passed to LevelDB::commit"));
     }
-    auto const status = m_db->Write(m_writeOptions, &batchPtr->writeBatch());
+    auto const status = m_db->Write(_options, &batchPtr->writeBatch());
     checkStatus(status);
 }
 
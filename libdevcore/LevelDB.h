@@ -33,10 +33,13 @@ public:
 
     std::unique_ptr<WriteBatchFace> createWriteBatch() const override;
     void commit(std::unique_ptr<WriteBatchFace> _batch) override;
+    void commitSynced(std::unique_ptr<WriteBatchFace> _batch) override;
 
     void forEach(std::function<bool(Slice, Slice)> _f) const override;
 
 private:
+    void write(leveldb::WriteOptions const& _options, std::unique_ptr<WriteBatchFace> _batch);
+
     std::unique_ptr<leveldb::DB> m_db;
     leveldb::ReadOptions const m_readOptions;
     leveldb::WriteOptions const m_writeOptions;
@@ -63,6 +63,16 @@ public:
         return false;
     }
 
+    /// @returns the cached value, making it the most recently used, or nullptr if there is none.
+    value_type const* find(key_type const& _key)
+    {
+        auto const cIter = m_index.find(_key);
+        if (cIter == m_index.cend())
+            return nullptr;
+        m_data.splice(m_data.begin(), m_data, cIter->second);
+        return &cIter->second->second;
+    }
+
     bool contains(key_type const& _key) const { return m_index.find(_key) != m_index.cend(); }
 
     bool contains(key_type const& _key, value_type const& _value) const
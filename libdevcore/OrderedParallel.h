@@ -0,0 +1,108 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#pragma once
+
+#include "Guards.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <map>
+#include <thread>
+#include <vector>
+
+namespace dev
+{
+/// Produces the values from 0 to @a _count - 1 on @a _threads threads, a window ahead of the value
+/// consumed, and consumes them in order on the calling thread.
+/// @throws the error of producing or consuming the first value which fails, once the values
+/// before are consumed.
+template <class T>
+void forEachInOrder(size_t _count, unsigned _threads, char const* _threadName,
+    std::function<T(size_t)> const& _produce, std::function<void(T&)> const& _consume)
+{
+    struct Result
+    {
+        T value;
+        std::exception_ptr error;
+    };
+
+    size_t const window = 4 * _threads;
+    Mutex x_results;
+    std::condition_variable resultsChanged;
+    std::map<size_t, Result> results;
+    size_t next = 0;
+    size_t consumed = 0;
+    bool stopped = false;
+
+    auto const produce = [&] {
+        setThreadName(_threadName);
+        while (true)
+        {
+            size_t i;
+            {
+                std::unique_lock<Mutex> l(x_results);
+                resultsChanged.wait(
+                    l, [&] { return stopped || next >= _count || next < consumed + window; });
+                if (stopped || next >= _count)
+                    return;
+                i = next++;
+            }
+
+            Result result;
+            try
+            {
+                result.value = _produce(i);
+            }
+            catch (...)
+            {
+                result.error = std::current_exception();
+            }
+            DEV_GUARDED(x_results)
+                results.emplace(i, std::move(result));
+            resultsChanged.notify_all();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < std::min<size_t>(_threads, _count); ++i)
+        workers.emplace_back(produce);
+    auto const stop = [&] {
+        DEV_GUARDED(x_results)
+            stopped = true;
+        resultsChanged.notify_all();
+        for (auto& worker : workers)
+            worker.join();
+    };
+
+    try
+    {
+        while (consumed < _count)
+        {
+            Result result;
+            {
+                std::unique_lock<Mutex> l(x_results);
+                resultsChanged.wait(l, [&] { return results.count(consumed) != 0; });
+                result = std::move(results[consumed]);
+                results.erase(consumed++);
+            }
+            resultsChanged.notify_all();
+
+            if (result.error)
+                std::rethrow_exception(result.error);
+            _consume(result.value);
+        }
+    }
+    catch (...)
+    {
+        stop();
+        throw;
+    }
+    stop();
+}
+
+}  // namespace dev
@@ -4,6 +4,7 @@
 #include <thread>
 #include <libdevcore/db.h>
 #include <libdevcore/Common.h>
+#include "BufferedDB.h"
 #include "SHA3.h"
 #include "OverlayDB.h"
 #include "TrieDB.h"
@@ -41,12 +42,10 @@ void OverlayDB::commit()
         DEV_READ_GUARDED(x_this)
 #endif
         {
-            for (auto const& i: m_main)
-            {
-                if (i.second.second)
-                    writeBatch->insert(toSlice(i.first), toSlice(i.second.first));
-//              cnote << i.first << "#" << m_main[i.first].second;
-            }
+            forEachEntry([&](h256 const& _h, Entry const& _e) {
+                if (_e.second)
+                    writeBatch->insert(toSlice(_h), toSlice(_e.first));
+            });
             for (auto const& i: m_aux)
                 if (i.second.second)
                 {
@@ -81,6 +80,7 @@ void OverlayDB::commit()
         {
             m_aux.clear();
             m_main.clear();
+            m_layers.clear();
         }
     }
 }
@@ -100,12 +100,33 @@ bytes OverlayDB::lookupAux(h256 const& _h) const
     return asBytes(v);
 }
 
+void OverlayDB::bufferWrites()
+{
+    if (!m_db)
+        return;
+
+    auto buffered = std::dynamic_pointer_cast<db::BufferedDB>(m_db);
+    if (!buffered)
+    {
+        buffered = std::make_shared<db::BufferedDB>(m_db);
+        m_db = buffered;
+    }
+    buffered->buffer();
+}
+
+void OverlayDB::flushWrites()
+{
+    if (auto buffered = dynamic_cast<db::BufferedDB*>(m_db.get()))
+        buffered->flush();
+}
+
 void OverlayDB::rollback()
 {
 #if DEV_GUARDED_DB
     WriteGuard l(x_this);
 #endif
     m_main.clear();
+    m_layers.clear();
 }
 
 std::string OverlayDB::lookup(h256 const& _h) const
@@ -41,6 +41,12 @@ public:
 
 	bytes lookupAux(h256 const& _h) const;
 
+    /// Keeps the writes of commit() in memory until flushWrites(). The copies made afterwards
+    /// share the writes kept, the copies made before still write to the disk database directly.
+    void bufferWrites();
+    /// Writes the writes kept by bufferWrites() to the disk database in one synced batch.
+    void flushWrites();
+
 private:
 	using StateCacheDB::clear;
 
@@ -160,6 +160,18 @@ std::unique_ptr<WriteBatchFace> RocksDB::createWriteBatch() const
 }
 
 void RocksDB::commit(std::unique_ptr<WriteBatchFace> _batch)
+{
+    write(m_writeOptions, std::move(_batch));
+}
+
+void RocksDB::commitSynced(std::unique_ptr<WriteBatchFace> _batch)
+{
+    rocksdb::WriteOptions options = m_writeOptions;
+    options.sync = true;
+    write(options, std::move(_batch));
+}
+
+void RocksDB::write(rocksdb::WriteOptions const& _options, std::unique_ptr<WriteBatchFace> _batch)
 {
     if (!_batch)
         BOOST_THROW_EXCEPTION(DatabaseError() << errinfo_comment("Cannot commit null batch"));
@@ -168,7 +180,7 @@ void RocksDB::commit(std::unique_ptr<WriteBatchFace> _batch)
     if (!batchPtr)
         BOOST_THROW_EXCEPTION(DatabaseError() << errinfo_comment("Invalid batch type passed to rocksdb::commit"));
 
-    auto const status = m_db->Write(m_writeOptions, &batchPtr->writeBatch());
+    auto const status = m_db->Write(_options, &batchPtr->writeBatch());
     checkStatus(status);
 }
 
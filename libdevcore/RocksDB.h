@@ -32,10 +32,13 @@ public:
 
     std::unique_ptr<WriteBatchFace> createWriteBatch() const override;
     void commit(std::unique_ptr<WriteBatchFace> _batch) override;
+    void commitSynced(std::unique_ptr<WriteBatchFace> _batch) override;
 
     void forEach(std::function<bool(Slice, Slice)> f) const override;
 
 private:
+    void write(rocksdb::WriteOptions const& _options, std::unique_ptr<WriteBatchFace> _batch);
+
     std::unique_ptr<rocksdb::DB> m_db;
     rocksdb::ReadOptions const m_readOptions;
     rocksdb::WriteOptions const m_writeOptions;
@@ -3,10 +3,14 @@
 // Licensed under the GNU General Public License, Version 3.
 
 #include "SHA3.h"
+#include "KeccakLanes.h"
 #include "RLP.h"
 
 #include <ethash/keccak.hpp>
 
+#include <algorithm>
+#include <cstring>
+
 namespace dev
 {
 h256 const EmptySHA3 = sha3(bytesConstRef());
@@ -20,4 +24,100 @@ bool sha3(bytesConstRef _input, bytesRef o_output) noexcept
     bytesConstRef{h.bytes, 32}.copyTo(o_output);
     return true;
 }
+
+namespace
+{
+#if ALETH_KECCAK_SIMD
+/// The number of bytes absorbed per permutation by Keccak-256.
+constexpr size_t c_rate = 136;
+
+inline uint64_t loadLE(byte const* _p) noexcept
+{
+    uint64_t ret = 0;
+    for (size_t i = 0; i < 8; ++i)
+        ret |= uint64_t{_p[i]} << (8 * i);
+    return ret;
+}
+
+/// Hashes up to Width inputs in the interleaved lanes of a multi-state permutation.
+/// Shorter inputs finish early and idle in their lanes until the longest one is absorbed.
+template <size_t Width, void (*Permute)(uint64_t*)>
+void sha3Lanes(bytesConstRef const* _inputs, size_t _count, h256* o_outputs) noexcept
+{
+    uint64_t state[keccak::c_stateWords * Width] = {};
+    size_t blocks[Width] = {};
+    size_t maxBlocks = 0;
+    for (size_t l = 0; l < _count; ++l)
+    {
+        // The padding always takes a block of its own or a part of the last one.
+        blocks[l] = _inputs[l].size() / c_rate + 1;
+        maxBlocks = std::max(maxBlocks, blocks[l]);
+    }
+
+    for (size_t b = 0; b < maxBlocks; ++b)
+    {
+        for (size_t l = 0; l < _count; ++l)
+        {
+            if (b >= blocks[l])
+                continue;
+
+            byte const* data = _inputs[l].data() + b * c_rate;
+            byte last[c_rate];
+            if (b + 1 == blocks[l])
+            {
+                size_t const rest = _inputs[l].size() - b * c_rate;
+                std::memset(last, 0, c_rate);
+                if (rest)
+                    std::memcpy(last, data, rest);
+                last[rest] ^= 0x01;
+                last[c_rate - 1] ^= 0x80;
+                data = last;
+            }
+            for (size_t w = 0; w < c_rate / 8; ++w)
+                state[w * Width + l] ^= loadLE(data + w * 8);
+        }
+
+        Permute(state);
+
+        for (size_t l = 0; l < _count; ++l)
+            if (b + 1 == blocks[l])
+                for (size_t w = 0; w < 4; ++w)
+                    for (size_t i = 0; i < 8; ++i)
+                        o_outputs[l][w * 8 + i] = static_cast<byte>(state[w * Width + l] >> (8 * i));
+    }
+}
+
+bool hasAVX2() noexcept
+{
+    static bool const s_has = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+    return s_has;
+}
+
+bool hasAVX512() noexcept
+{
+    static bool const s_has = (__builtin_cpu_init(), __builtin_cpu_supports("avx512f"));
+    return s_has;
+}
+#endif
+}  // namespace
+
+void sha3Batch(bytesConstRef const* _inputs, size_t _count, h256* o_outputs) noexcept
+{
+    size_t i = 0;
+#if ALETH_KECCAK_SIMD
+    if (hasAVX512())
+        for (; _count - i >= 8; i += 8)
+            sha3Lanes<8, keccak::keccakf1600x8>(&_inputs[i], 8, &o_outputs[i]);
+    // Even a partially filled 4-way permutation beats hashing 2 inputs one by one.
+    if (hasAVX2())
+        while (_count - i >= 2)
+        {
+            size_t const count = std::min<size_t>(4, _count - i);
+            sha3Lanes<4, keccak::keccakf1600x4>(&_inputs[i], count, &o_outputs[i]);
+            i += count;
+        }
+#endif
+    for (; i < _count; ++i)
+        sha3(_inputs[i], o_outputs[i].ref());
+}
 }  // namespace dev
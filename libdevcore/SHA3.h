@@ -28,6 +28,19 @@ inline h256 sha3(bytesConstRef _input) noexcept
     return ret;
 }
 
+/// Calculate SHA3-256 hashes of _count independent inputs, o_outputs[i] = sha3(_inputs[i]).
+/// On CPUs supporting AVX2 or AVX-512 the inputs are hashed 4 or 8 at a time, which gives the
+/// best throughput for many inputs of similar size.
+void sha3Batch(bytesConstRef const* _inputs, size_t _count, h256* o_outputs) noexcept;
+
+/// Calculate SHA3-256 hashes of several independent inputs.
+inline h256s sha3Batch(std::vector<bytesConstRef> const& _inputs)
+{
+    h256s ret(_inputs.size());
+    sha3Batch(_inputs.data(), _inputs.size(), ret.data());
+    return ret;
+}
+
 inline SecureFixedHash<32> sha3Secure(bytesConstRef _input) noexcept
 {
     SecureFixedHash<32> ret;
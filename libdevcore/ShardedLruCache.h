@@ -0,0 +1,244 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#pragma once
+
+#include "Guards.h"
+
+#include <boost/optional.hpp>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <unordered_map>
+
+namespace dev
+{
+/// Counters of a ShardedLruCache.
+struct LruCacheStats
+{
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t entries = 0;
+    size_t bytes = 0;  ///< Total size of the cached entries as given by the sizer.
+
+    LruCacheStats& operator+=(LruCacheStats const& _s)
+    {
+        hits += _s.hits;
+        misses += _s.misses;
+        evictions += _s.evictions;
+        entries += _s.entries;
+        bytes += _s.bytes;
+        return *this;
+    }
+};
+
+/**
+ * @brief Thread-safe LRU cache with a budget in bytes.
+ *
+ * The keys are spread over shards, each with its own lock and an equal part of the budget, so
+ * concurrent users of different keys rarely wait for each other. Each insertion evicts the least
+ * recently used entries of its shard until the shard is within its budget again, so the cost of
+ * eviction is spread over the insertions.
+ */
+template <class Key, class Value, class Hash = std::hash<Key>>
+class ShardedLruCache
+{
+public:
+    /// @returns the number of bytes an entry takes.
+    using Sizer = std::function<size_t(Value const&)>;
+
+    ShardedLruCache(size_t _budget, Sizer _sizer) : m_sizer(std::move(_sizer))
+    {
+        setBudget(_budget);
+    }
+
+    /// @returns a copy of the cached value, making it the most recently used, or none.
+    boost::optional<Value> find(Key const& _key) const
+    {
+        Shard& shard = shardOf(_key);
+        Guard l(shard.x_shard);
+        auto const it = shard.index.find(_key);
+        if (it == shard.index.end())
+        {
+            ++shard.stats.misses;
+            return boost::none;
+        }
+        ++shard.stats.hits;
+        shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+        return it->second->value;
+    }
+
+    bool contains(Key const& _key) const
+    {
+        Shard& shard = shardOf(_key);
+        Guard l(shard.x_shard);
+        return shard.index.count(_key);
+    }
+
+    /// Sets the value of the key, making it the most recently used.
+    void insert(Key const& _key, Value _value)
+    {
+        Shard& shard = shardOf(_key);
+        Guard l(shard.x_shard);
+        auto const it = shard.index.find(_key);
+        if (it != shard.index.end())
+        {
+            shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+            it->second->value = std::move(_value);
+        }
+        else
+        {
+            shard.entries.push_front(Entry{_key, std::move(_value), 0});
+            shard.index.emplace(_key, shard.entries.begin());
+        }
+        resize_WITH_LOCK(shard, shard.entries.front());
+    }
+
+    /// Sets the value of the key unless it is cached already. @returns the cached value.
+    Value emplace(Key const& _key, Value _value)
+    {
+        Shard& shard = shardOf(_key);
+        Guard l(shard.x_shard);
+        bool added = false;
+        Entry& entry = entry_WITH_LOCK(shard, _key, [&] {
+            added = true;
+            return std::move(_value);
+        });
+        Value ret = entry.value;
+        if (added)
+            resize_WITH_LOCK(shard, entry);
+        return ret;
+    }
+
+    /// Changes the value of the key in place by calling @a _modify with it. A key that is not
+    /// cached first gets the value returned by @a _load.
+    template <class Load, class Modify>
+    void modify(Key const& _key, Load&& _load, Modify&& _modify)
+    {
+        Shard& shard = shardOf(_key);
+        Guard l(shard.x_shard);
+        Entry& entry = entry_WITH_LOCK(shard, _key, std::forward<Load>(_load));
+        _modify(entry.value);
+        resize_WITH_LOCK(shard, entry);
+    }
+
+    void remove(Key const& _key)
+    {
+        Shard& shard = shardOf(_key);
+        Guard l(shard.x_shard);
+        auto const it = shard.index.find(_key);
+        if (it == shard.index.end())
+            return;
+        shard.stats.bytes -= it->second->size;
+        shard.entries.erase(it->second);
+        shard.index.erase(it);
+    }
+
+    void clear()
+    {
+        for (Shard& shard : m_shards)
+        {
+            Guard l(shard.x_shard);
+            shard.index.clear();
+            shard.entries.clear();
+            shard.stats.bytes = 0;
+        }
+    }
+
+    void setBudget(size_t _budget)
+    {
+        for (Shard& shard : m_shards)
+        {
+            Guard l(shard.x_shard);
+            shard.budget = _budget / c_shards;
+            evict_WITH_LOCK(shard);
+        }
+    }
+
+    LruCacheStats stats() const
+    {
+        LruCacheStats ret;
+        for (Shard& shard : m_shards)
+        {
+            Guard l(shard.x_shard);
+            LruCacheStats s = shard.stats;
+            s.entries = shard.index.size();
+            ret += s;
+        }
+        return ret;
+    }
+
+private:
+    static constexpr size_t c_shards = 16;
+
+    struct Entry
+    {
+        Key key;
+        Value value;
+        size_t size;
+    };
+
+    struct Shard
+    {
+        Mutex x_shard;
+        std::list<Entry> entries;  ///< The most recently used first.
+        std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> index;
+        size_t budget = 0;
+        LruCacheStats stats;
+    };
+
+    Shard& shardOf(Key const& _key) const
+    {
+        // Mix the hash, as the low bits of some hashes of the keys, e.g. of block numbers, are
+        // the least random ones.
+        size_t const h = Hash{}(_key);
+        return m_shards[(h ^ (h >> 17) ^ (h >> 31)) % c_shards];
+    }
+
+    /// @returns the entry of the key, most recently used, adding it with the loaded value if
+    /// missing.
+    template <class Load>
+    Entry& entry_WITH_LOCK(Shard& _shard, Key const& _key, Load&& _load) const
+    {
+        auto const it = _shard.index.find(_key);
+        if (it != _shard.index.end())
+        {
+            _shard.entries.splice(_shard.entries.begin(), _shard.entries, it->second);
+            return *it->second;
+        }
+        _shard.entries.push_front(Entry{_key, _load(), 0});
+        _shard.index.emplace(_key, _shard.entries.begin());
+        return _shard.entries.front();
+    }
+
+    /// Accounts for the new size of the entry and brings the shard back within its budget.
+    void resize_WITH_LOCK(Shard& _shard, Entry& _entry) const
+    {
+        size_t const size = m_sizer(_entry.value);
+        _shard.stats.bytes = _shard.stats.bytes - _entry.size + size;
+        _entry.size = size;
+        evict_WITH_LOCK(_shard);
+    }
+
+    /// Drops the least recently used entries while the shard is over budget. The most recently
+    /// used entry always stays, so that a value bigger than the budget can still be modified.
+    void evict_WITH_LOCK(Shard& _shard) const
+    {
+        while (_shard.stats.bytes > _shard.budget && _shard.entries.size() > 1)
+        {
+            Entry const& last = _shard.entries.back();
+            _shard.stats.bytes -= last.size;
+            _shard.index.erase(last.key);
+            _shard.entries.pop_back();
+            ++_shard.stats.evictions;
+        }
+    }
+
+    Sizer m_sizer;
+    mutable std::array<Shard, c_shards> m_shards;
+};
+
+}  // namespace dev
@@ -0,0 +1,94 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace dev
+{
+/**
+ * @brief Persistent stack of immutable hash maps, shared between copies.
+ *
+ * Copying costs a reference count increment. Lookups search the layers from the newest to the
+ * oldest, so a newer layer shadows the entries of the older ones. A pushed layer absorbs the
+ * layers below it as long as they are at most twice its size, which keeps the number of layers
+ * logarithmic in the number of entries and the cost of pushing amortised logarithmic per entry.
+ */
+template <class Key, class Value>
+class SharedLayers
+{
+public:
+    using Map = std::unordered_map<Key, Value>;
+
+    /// @returns the newest value of the key or nullptr if no layer has it.
+    Value const* find(Key const& _key) const
+    {
+        for (Layer const* layer = m_top.get(); layer; layer = layer->below.get())
+        {
+            auto const it = layer->map.find(_key);
+            if (it != layer->map.end())
+                return &it->second;
+        }
+        return nullptr;
+    }
+
+    /// Adds the entries as the newest layer.
+    void push(Map&& _map)
+    {
+        if (_map.empty())
+            return;
+
+        auto layer = std::make_shared<Layer>();
+        layer->map = std::move(_map);
+        std::shared_ptr<Layer const> below = m_top;
+        while (below && below->map.size() <= 2 * layer->map.size())
+        {
+            // emplace() keeps the newer value of the keys present in both layers.
+            for (auto const& entry : below->map)
+                layer->map.emplace(entry);
+            below = below->below;
+        }
+        layer->depth = below ? below->depth + 1 : 1;
+        layer->below = std::move(below);
+        m_top = std::move(layer);
+    }
+
+    void clear() { m_top.reset(); }
+    bool empty() const { return !m_top; }
+    size_t depth() const { return m_top ? m_top->depth : 0; }
+
+    /// Calls @a _f with every key and its newest value.
+    template <class F>
+    void forEach(F&& _f) const
+    {
+        if (depth() == 1)
+        {
+            for (auto const& entry : m_top->map)
+                _f(entry.first, entry.second);
+            return;
+        }
+
+        std::unordered_set<Key> seen;
+        for (Layer const* layer = m_top.get(); layer; layer = layer->below.get())
+            for (auto const& entry : layer->map)
+                if (seen.insert(entry.first).second)
+                    _f(entry.first, entry.second);
+    }
+
+private:
+    struct Layer
+    {
+        Map map;
+        std::shared_ptr<Layer const> below;
+        size_t depth = 1;
+    };
+
+    std::shared_ptr<Layer const> m_top;
+};
+
+}  // namespace dev
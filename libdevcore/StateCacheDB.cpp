@@ -16,9 +16,10 @@ std::unordered_map<h256, std::string> StateCacheDB::get() const
     ReadGuard l(x_this);
 #endif
     std::unordered_map<h256, std::string> ret;
-    for (auto const& i: m_main)
-        if (!m_enforceRefs || i.second.second > 0)
-            ret.insert(make_pair(i.first, i.second.first));
+    forEachEntry([&](h256 const& _h, Entry const& _e) {
+        if (!m_enforceRefs || _e.second > 0)
+            ret.insert(make_pair(_h, _e.first));
+    });
     return ret;
 }
 
@@ -31,20 +32,39 @@ StateCacheDB& StateCacheDB::operator=(StateCacheDB const& _c)
     WriteGuard l2(x_this);
 #endif
     m_main = _c.m_main;
+    m_layers = _c.m_layers;
     m_aux = _c.m_aux;
     return *this;
 }
 
-std::string StateCacheDB::lookup(h256 const& _h) const
+void StateCacheDB::freeze()
 {
 #if DEV_GUARDED_DB
-    ReadGuard l(x_this);
+    WriteGuard l(x_this);
 #endif
+    if (m_main.empty())
+        return;
+    m_layers.push(std::move(m_main));
+    m_main.clear();
+}
+
+StateCacheDB::Entry const* StateCacheDB::entry(h256 const& _h) const
+{
     auto it = m_main.find(_h);
     if (it != m_main.end())
+        return &it->second;
+    return m_layers.find(_h);
+}
+
+std::string StateCacheDB::lookup(h256 const& _h) const
+{
+#if DEV_GUARDED_DB
+    ReadGuard l(x_this);
+#endif
+    if (Entry const* e = entry(_h))
     {
-        if (!m_enforceRefs || it->second.second > 0)
-            return it->second.first;
+        if (!m_enforceRefs || e->second > 0)
+            return e->first;
         else
             cwarn << "Lookup required for value with refcount == 0. This is probably a critical trie issue" << _h;
     }
@@ -56,10 +76,8 @@ bool StateCacheDB::exists(h256 const& _h) const
 #if DEV_GUARDED_DB
     ReadGuard l(x_this);
 #endif
-    auto it = m_main.find(_h);
-    if (it != m_main.end() && (!m_enforceRefs || it->second.second > 0))
-        return true;
-    return false;
+    Entry const* e = entry(_h);
+    return e && (!m_enforceRefs || e->second > 0);
 }
 
 void StateCacheDB::insert(h256 const& _h, bytesConstRef _v)
@@ -73,6 +91,8 @@ void StateCacheDB::insert(h256 const& _h, bytesConstRef _v)
         it->second.first = _v.toString();
         it->second.second++;
     }
+    else if (Entry const* e = m_layers.find(_h))
+        m_main[_h] = make_pair(_v.toString(), e->second + 1);
     else
         m_main[_h] = make_pair(_v.toString(), 1);
 }
@@ -82,11 +102,21 @@ bool StateCacheDB::kill(h256 const& _h)
 #if DEV_GUARDED_DB
     ReadGuard l(x_this);
 #endif
-    if (m_main.count(_h))
+    auto it = m_main.find(_h);
+    if (it != m_main.end())
     {
-        if (m_main[_h].second > 0)
+        if (it->second.second > 0)
         {
-            m_main[_h].second--;
+            it->second.second--;
+            return true;
+        }
+    }
+    else if (Entry const* e = m_layers.find(_h))
+    {
+        // Shadow the shared node with a private one of decreased refcount.
+        if (e->second > 0)
+        {
+            m_main.emplace(_h, make_pair(e->first, e->second - 1));
             return true;
         }
     }
@@ -125,9 +155,9 @@ void StateCacheDB::purge()
 #if DEV_GUARDED_DB
     WriteGuard l(x_this);
 #endif
-    // purge m_main
+    // purge m_main, keeping the dead nodes which shadow live shared ones
     for (auto it = m_main.begin(); it != m_main.end(); )
-        if (it->second.second)
+        if (it->second.second || m_layers.find(it->first))
             ++it;
         else
             it = m_main.erase(it);
@@ -146,9 +176,10 @@ h256Hash StateCacheDB::keys() const
     ReadGuard l(x_this);
 #endif
     h256Hash ret;
-    for (auto const& i: m_main)
-        if (i.second.second)
-            ret.insert(i.first);
+    forEachEntry([&](h256 const& _h, Entry const& _e) {
+        if (_e.second)
+            ret.insert(_h);
+    });
     return ret;
 }
 
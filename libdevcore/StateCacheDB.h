@@ -4,8 +4,10 @@
 #pragma once
 
 #include "Common.h"
+#include "Guards.h"
 #include "Log.h"
 #include "RLP.h"
+#include "SharedLayers.h"
 
 namespace dev
 {
@@ -25,6 +27,7 @@ public:
     {
         m_main.clear();
         m_aux.clear();
+        m_layers.clear();
     }  // WARNING !!!! didn't originally clear m_refCount!!!
     std::unordered_map<h256, std::string> get() const;
 
@@ -40,11 +43,36 @@ public:
 
     h256Hash keys() const;
 
+    /// Moves the nodes written since the last call into the layers shared with copies, so that
+    /// copying costs O(1) until the next write. Copying itself only reads the source, which may
+    /// be shared by concurrent readers.
+    void freeze();
+
 protected:
+    using Entry = std::pair<std::string, unsigned>;
+
+    /// @returns the newest value and reference count of the node or nullptr.
+    Entry const* entry(h256 const& _h) const;
+
+    /// Calls @a _f with every node and its newest value and reference count.
+    template <class F>
+    void forEachEntry(F&& _f) const
+    {
+        for (auto const& i : m_main)
+            _f(i.first, i.second);
+        m_layers.forEach([&](h256 const& _h, Entry const& _e) {
+            if (!m_main.count(_h))
+                _f(_h, _e);
+        });
+    }
+
 #if DEV_GUARDED_DB
     mutable SharedMutex x_this;
 #endif
-    std::unordered_map<h256, std::pair<std::string, unsigned>> m_main;
+    /// Nodes written since the last freeze(), copied with the object.
+    std::unordered_map<h256, Entry> m_main;
+    /// Older nodes, shared with the copies of this object and never modified.
+    SharedLayers<h256, Entry> m_layers;
     std::unordered_map<h256, std::pair<bytes, bool>> m_aux;
 
     mutable bool m_enforceRefs = false;
@@ -0,0 +1,124 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#include "ThreadPool.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+using namespace std;
+using namespace dev;
+
+ThreadPool::ThreadPool(string const& _name, unsigned _threads, size_t _maxQueued)
+  : m_maxQueued(_maxQueued)
+{
+    unsigned const threads = _threads ? _threads : max(thread::hardware_concurrency(), 1u);
+    m_workers.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i)
+        m_workers.emplace_back([this, _name] {
+            setThreadName(_name);
+            work();
+        });
+}
+
+ThreadPool::~ThreadPool()
+{
+    DEV_GUARDED(x_queue)
+        m_stopping = true;
+    m_queueChanged.notify_all();
+    for (auto& worker : m_workers)
+        worker.join();
+}
+
+void ThreadPool::post(function<void()> _job)
+{
+    if (!tryPost(move(_job)))
+        BOOST_THROW_EXCEPTION(ThreadPoolFull());
+}
+
+bool ThreadPool::tryPost(function<void()> _job)
+{
+    DEV_GUARDED(x_queue)
+    {
+        if (m_maxQueued && m_queue.size() >= m_maxQueued)
+            return false;
+        m_queue.push_back(move(_job));
+    }
+    m_queueChanged.notify_one();
+    return true;
+}
+
+void ThreadPool::runAll(vector<function<void()>> const& _jobs)
+{
+    struct Batch
+    {
+        explicit Batch(vector<function<void()>> const& _jobs) : jobs(_jobs), count(_jobs.size()) {}
+
+        void runJobs()
+        {
+            for (size_t i = next++; i < count; i = next++)
+            {
+                exception_ptr jobError;
+                try
+                {
+                    jobs[i]();
+                }
+                catch (...)
+                {
+                    jobError = current_exception();
+                }
+                DEV_GUARDED(x_batch)
+                {
+                    if (jobError && !error)
+                        error = jobError;
+                    ++done;
+                }
+                jobsDone.notify_all();
+            }
+        }
+
+        /// Only accessed for the jobs taken, as the caller returns once all are done.
+        vector<function<void()>> const& jobs;
+        size_t const count;
+        atomic<size_t> next{0};
+
+        Mutex x_batch;
+        condition_variable jobsDone;
+        size_t done = 0;
+        exception_ptr error;
+    };
+
+    // A worker which starts once all the jobs are taken has nothing to do.
+    auto const batch = make_shared<Batch>(_jobs);
+    for (size_t i = 1; i < min<size_t>(_jobs.size(), m_workers.size() + 1); ++i)
+        if (!tryPost([batch] { batch->runJobs(); }))
+            break;
+
+    batch->runJobs();
+    unique_lock<Mutex> l(batch->x_batch);
+    batch->jobsDone.wait(l, [&] { return batch->done == batch->count; });
+    if (batch->error)
+        rethrow_exception(batch->error);
+}
+
+void ThreadPool::work()
+{
+    while (true)
+    {
+        function<void()> job;
+        {
+            unique_lock<Mutex> l(x_queue);
+            m_queueChanged.wait(l, [this] { return m_stopping || !m_queue.empty(); });
+            // Callers may be waiting for the queued jobs, so they are run even when stopping.
+            if (m_queue.empty())
+                return;
+            job = move(m_queue.front());
+            m_queue.pop_front();
+        }
+        job();
+    }
+}
@@ -0,0 +1,77 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#pragma once
+
+#include "Exceptions.h"
+#include "Guards.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dev
+{
+DEV_SIMPLE_EXCEPTION(ThreadPoolFull);
+
+/**
+ * @brief Fixed set of threads running the jobs queued, in the order they are queued.
+ *
+ * The jobs still queued when the pool is destroyed are run before its threads are joined, as
+ * their callers may be waiting for them.
+ */
+class ThreadPool
+{
+public:
+    /// @param _name  Name of the worker threads.
+    /// @param _threads  Number of worker threads, the hardware concurrency if 0.
+    /// @param _maxQueued  Maximum number of jobs waiting for a worker, unlimited if 0.
+    explicit ThreadPool(std::string const& _name, unsigned _threads = 0, size_t _maxQueued = 0);
+    ~ThreadPool();
+
+    ThreadPool(ThreadPool const&) = delete;
+    ThreadPool& operator=(ThreadPool const&) = delete;
+
+    /// Queues the job.
+    /// @throws ThreadPoolFull if the queue is full.
+    void post(std::function<void()> _job);
+    /// Queues the job unless the queue is full.
+    /// @returns false if the queue is full.
+    bool tryPost(std::function<void()> _job);
+
+    /// Runs @a _f on a worker thread and waits for its result, rethrowing its exception.
+    /// @throws ThreadPoolFull if the queue is full.
+    template <class F>
+    auto run(F&& _f) -> decltype(_f())
+    {
+        std::packaged_task<decltype(_f())()> task(std::forward<F>(_f));
+        auto result = task.get_future();
+        post([&task] { task(); });
+        return result.get();
+    }
+
+    /// Runs the jobs on the workers and the calling thread and returns once all are done. The
+    /// calling thread takes the jobs no worker has taken yet, so it never waits for a busy pool.
+    /// @throws the exception of the first job that failed.
+    void runAll(std::vector<std::function<void()>> const& _jobs);
+
+    unsigned threads() const { return static_cast<unsigned>(m_workers.size()); }
+
+private:
+    void work();
+
+    size_t const m_maxQueued;
+    std::vector<std::thread> m_workers;
+
+    Mutex x_queue;
+    std::condition_variable m_queueChanged;
+    std::deque<std::function<void()>> m_queue;
+    bool m_stopping = false;
+};
+
+}  // namespace dev
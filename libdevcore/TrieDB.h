@@ -376,6 +376,10 @@ public:
     void insert(bytesConstRef _key, bytesConstRef _value) { Super::insert(sha3(_key), _value); }
     void remove(bytesConstRef _key) { Super::remove(sha3(_key)); }
 
+    /// Variants taking the precomputed sha3 of the key, for callers hashing many keys at once.
+    void insertHashed(h256 const& _hashedKey, bytesConstRef, bytesConstRef _value) { Super::insert(_hashedKey, _value); }
+    void removeHashed(h256 const& _hashedKey) { Super::remove(_hashedKey); }
+
     // empty from the PoV of the iterator interface; still need a basic iterator impl though.
     class iterator
     {
@@ -424,14 +428,16 @@ public:
 
     std::string at(bytesConstRef _key) const { return Super::at(sha3(_key)); }
     bool contains(bytesConstRef _key) const { return Super::contains(sha3(_key)); }
-    void insert(bytesConstRef _key, bytesConstRef _value)
+    void insert(bytesConstRef _key, bytesConstRef _value) { insertHashed(sha3(_key), _key, _value); }
+    void remove(bytesConstRef _key) { Super::remove(sha3(_key)); }
+
+    /// Variants taking the precomputed sha3 of the key, for callers hashing many keys at once.
+    void insertHashed(h256 const& _hashedKey, bytesConstRef _key, bytesConstRef _value)
     {
-        h256 hash = sha3(_key);
-        Super::insert(hash, _value);
-        Super::db()->insertAux(hash, _key);
+        Super::insert(_hashedKey, _value);
+        Super::db()->insertAux(_hashedKey, _key);
     }
-
-    void remove(bytesConstRef _key) { Super::remove(sha3(_key)); }
+    void removeHashed(h256 const& _hashedKey) { Super::remove(_hashedKey); }
 
     // iterates over <key, value> pairs
     class iterator: public GenericTrieDB<_DB>::iterator
@@ -45,6 +45,9 @@ public:
 
     virtual std::unique_ptr<WriteBatchFace> createWriteBatch() const = 0;
     virtual void commit(std::unique_ptr<WriteBatchFace> _batch) = 0;
+    // Commits the batch and only returns once it is synced to the disk, so that it survives a
+    // crash of the machine. The database commits it like `commit` if it has nothing to sync.
+    virtual void commitSynced(std::unique_ptr<WriteBatchFace> _batch) { commit(std::move(_batch)); }
 
     // A database must implement the `forEach` method that allows the caller
     // to pass in a function `f`, which will be called with the key and value
@@ -24,12 +24,32 @@ void LogEntry::streamRLP(RLPStream& _s) const
 	_s.appendList(3) << address << topics << data;
 }
 
+void LogEntry::bloomInputs(std::vector<bytesConstRef>& o_inputs) const
+{
+	o_inputs.push_back(address.ref());
+	for (auto const& t: topics)
+		o_inputs.push_back(t.ref());
+}
+
 LogBloom LogEntry::bloom() const
 {
+	std::vector<bytesConstRef> inputs;
+	bloomInputs(inputs);
+	LogBloom ret;
+	for (auto const& h: sha3Batch(inputs))
+		ret.shiftBloom<3>(h);
+	return ret;
+}
+
+LogBloom bloom(LogEntries const& _logs)
+{
+	// Hash the addresses and topics of all the logs in one batch.
+	std::vector<bytesConstRef> inputs;
+	for (auto const& l: _logs)
+		l.bloomInputs(inputs);
 	LogBloom ret;
-	ret.shiftBloom<3>(sha3(address.ref()));
-	for (auto t: topics)
-		ret.shiftBloom<3>(sha3(t.ref()));
+	for (auto const& h: sha3Batch(inputs))
+		ret.shiftBloom<3>(h);
 	return ret;
 }
 
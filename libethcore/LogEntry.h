@@ -28,6 +28,8 @@ struct LogEntry
 	void streamRLP(RLPStream& _s) const;
 
 	LogBloom bloom() const;
+	/// Appends the data hashed into the bloom filter: the address and the topics.
+	void bloomInputs(std::vector<bytesConstRef>& o_inputs) const;
 
 	Address address;
 	h256s topics;
@@ -79,13 +81,7 @@ struct LocalisedLogEntry: public LogEntry
 
 using LocalisedLogEntries = std::vector<LocalisedLogEntry>;
 
-inline LogBloom bloom(LogEntries const& _logs)
-{
-	LogBloom ret;
-	for (auto const& l: _logs)
-		ret |= l.bloom();
-	return ret;
-}
+LogBloom bloom(LogEntries const& _logs);
 
 }
 }
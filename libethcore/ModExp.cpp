@@ -0,0 +1,190 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#include "ModExp.h"
+
+#include <intx/intx.hpp>
+
+#include <array>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace
+{
+using intx::uint128;
+
+/// Little endian array of 64-bit words.
+template <size_t N>
+using Limbs = array<uint64_t, N>;
+
+/// @returns _a * _b + _c + _d, which always fits 128 bits.
+inline uint128 mulAdd(uint64_t _a, uint64_t _b, uint64_t _c, uint64_t _d) noexcept
+{
+    return intx::umul(_a, _b) + uint128{_c} + uint128{_d};
+}
+
+template <size_t N>
+Limbs<N> toLimbs(bigint const& _x)
+{
+    Limbs<N> ret{};
+    export_bits(_x, ret.begin(), 64, false);
+    return ret;
+}
+
+template <size_t N>
+bigint fromLimbs(Limbs<N> const& _x)
+{
+    bigint ret;
+    import_bits(ret, _x.begin(), _x.end(), 64, false);
+    return ret;
+}
+
+/// Montgomery multiplication modulo an odd number of N words, with R = 2^(64N).
+template <size_t N>
+class Montgomery
+{
+public:
+    explicit Montgomery(Limbs<N> const& _mod) : m_mod{_mod}, m_modInv{negInverse(_mod[0])} {}
+
+    /// @returns _a * _b / R mod m for _a, _b < m, computed by the CIOS method.
+    Limbs<N> mul(Limbs<N> const& _a, Limbs<N> const& _b) const noexcept
+    {
+        array<uint64_t, N + 2> t{};
+        for (size_t i = 0; i < N; ++i)
+        {
+            uint64_t carry = 0;
+            for (size_t j = 0; j < N; ++j)
+            {
+                auto const p = mulAdd(_a[j], _b[i], t[j], carry);
+                t[j] = p.lo;
+                carry = p.hi;
+            }
+            auto s = uint128{t[N]} + uint128{carry};
+            t[N] = s.lo;
+            t[N + 1] = s.hi;
+
+            // Add a multiple of m making the lowest word zero and shift it out.
+            uint64_t const q = t[0] * m_modInv;
+            carry = mulAdd(q, m_mod[0], t[0], 0).hi;
+            for (size_t j = 1; j < N; ++j)
+            {
+                auto const p = mulAdd(q, m_mod[j], t[j], carry);
+                t[j - 1] = p.lo;
+                carry = p.hi;
+            }
+            s = uint128{t[N]} + uint128{carry};
+            t[N - 1] = s.lo;
+            t[N] = t[N + 1] + s.hi;
+        }
+
+        Limbs<N> ret;
+        copy(t.begin(), t.begin() + N, ret.begin());
+        if (t[N] != 0 || !less(ret, m_mod))
+            subtract(ret, m_mod);
+        return ret;
+    }
+
+private:
+    /// @returns -_x^-1 mod 2^64 for odd _x.
+    static uint64_t negInverse(uint64_t _x) noexcept
+    {
+        // _x is its own inverse modulo 8, every Newton step doubles the number of correct bits.
+        uint64_t inv = _x;
+        for (int i = 0; i < 5; ++i)
+            inv *= 2 - _x * inv;
+        return 0 - inv;
+    }
+
+    static bool less(Limbs<N> const& _a, Limbs<N> const& _b) noexcept
+    {
+        for (size_t i = N; i-- > 0;)
+            if (_a[i] != _b[i])
+                return _a[i] < _b[i];
+        return false;
+    }
+
+    static void subtract(Limbs<N>& _a, Limbs<N> const& _b) noexcept
+    {
+        uint64_t borrow = 0;
+        for (size_t i = 0; i < N; ++i)
+        {
+            uint64_t const d = _a[i] - _b[i];
+            uint64_t const nextBorrow = (_a[i] < _b[i]) | (d < borrow);
+            _a[i] = d - borrow;
+            borrow = nextBorrow;
+        }
+    }
+
+    Limbs<N> m_mod;
+    uint64_t m_modInv;
+};
+
+/// Fixed window exponentiation in the Montgomery domain, for odd _mod < 2^(64N).
+template <size_t N>
+bigint powmMontgomery(bigint const& _base, bigint const& _exp, bigint const& _mod)
+{
+    Montgomery<N> const mont{toLimbs<N>(_mod)};
+    bigint const r = bigint{1} << (64 * N);
+
+    // Use the binary method for short exponents, where the table would not pay off.
+    size_t const expBits = _exp ? msb(_exp) + 1 : 0;
+    unsigned const window = expBits > 64 ? 4 : 1;
+
+    // table[i] = base^i * R mod m
+    array<Limbs<N>, 16> table;
+    table[0] = toLimbs<N>(r % _mod);
+    table[1] = toLimbs<N>(((_base % _mod) << (64 * N)) % _mod);
+    for (unsigned i = 2; i < (1u << window); ++i)
+        table[i] = mont.mul(table[i - 1], table[1]);
+
+    Limbs<N> acc = table[0];
+    bool started = false;
+    for (size_t bit = (expBits + window - 1) / window * window; bit > 0; bit -= window)
+    {
+        unsigned digit = 0;
+        for (unsigned i = 1; i <= window; ++i)
+            digit = (digit << 1) | (bit_test(_exp, bit - i) ? 1 : 0);
+
+        if (started)
+            for (unsigned i = 0; i < window; ++i)
+                acc = mont.mul(acc, acc);
+        if (digit != 0)
+        {
+            acc = started ? mont.mul(acc, table[digit]) : table[digit];
+            started = true;
+        }
+    }
+
+    // Leave the Montgomery domain.
+    Limbs<N> one{};
+    one[0] = 1;
+    return fromLimbs(mont.mul(acc, one));
+}
+}  // namespace
+
+bigint dev::eth::modexp(bigint const& _base, bigint const& _exp, bigint const& _mod)
+{
+    if (_mod == 0 || !bit_test(_mod, 0))
+        return modexpGeneric(_base, _exp, _mod);
+
+    size_t const modBits = msb(_mod) + 1;
+    if (modBits <= 256)
+        return powmMontgomery<4>(_base, _exp, _mod);
+    if (modBits <= 512)
+        return powmMontgomery<8>(_base, _exp, _mod);
+    if (modBits <= 1024)
+        return powmMontgomery<16>(_base, _exp, _mod);
+    if (modBits <= 2048)
+        return powmMontgomery<32>(_base, _exp, _mod);
+    if (modBits <= 4096)
+        return powmMontgomery<64>(_base, _exp, _mod);
+    return modexpGeneric(_base, _exp, _mod);
+}
+
+bigint dev::eth::modexpGeneric(bigint const& _base, bigint const& _exp, bigint const& _mod)
+{
+    return _mod != 0 ? boost::multiprecision::powm(_base, _exp, _mod) : bigint{0};
+}
@@ -0,0 +1,20 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+#pragma once
+
+#include <libdevcore/Common.h>
+
+namespace dev
+{
+namespace eth
+{
+/// @returns _base ^ _exp mod _mod or 0 if _mod is 0.
+/// Odd moduli of up to 4096 bits are handled by fixed width Montgomery multiplication kernels,
+/// the rest falls back to modexpGeneric().
+bigint modexp(bigint const& _base, bigint const& _exp, bigint const& _mod);
+
+/// @returns _base ^ _exp mod _mod or 0 if _mod is 0, computed by boost::multiprecision::powm.
+bigint modexpGeneric(bigint const& _base, bigint const& _exp, bigint const& _mod);
+}  // namespace eth
+}  // namespace dev
@@ -5,6 +5,7 @@
 
 #include "Precompiled.h"
 #include "ChainOperationParams.h"
+#include "ModExp.h"
 #include <libdevcore/Log.h>
 #include <libdevcore/SHA3.h>
 #include <libdevcrypto/Blake2.h>
@@ -152,7 +153,7 @@ ETH_REGISTER_PRECOMPILED(modexp)(bytesConstRef _in)
     bigint const exp(parseBigEndianRightPadded(_in, 96 + baseLength, expLength));
     bigint const mod(parseBigEndianRightPadded(_in, 96 + baseLength + expLength, modLength));
 
-    bigint const result = mod != 0 ? boost::multiprecision::powm(base, exp, mod) : bigint{0};
+    bigint const result = modexp(base, exp, mod);
 
     size_t const retLength(modLength);
     bytes ret(retLength);
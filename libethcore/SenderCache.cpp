@@ -0,0 +1,40 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#include "SenderCache.h"
+
+using namespace dev;
+using namespace dev::eth;
+
+SenderCache& SenderCache::instance()
+{
+    static SenderCache s_instance;
+    return s_instance;
+}
+
+boost::optional<Address> SenderCache::lookup(h256 const& _transactionHash)
+{
+    Guard l(x_cache);
+    if (auto const sender = m_cache.find(_transactionHash))
+        return *sender;
+    return boost::none;
+}
+
+void SenderCache::insert(h256 const& _transactionHash, Address const& _sender)
+{
+    Guard l(x_cache);
+    m_cache.insert(_transactionHash, _sender);
+}
+
+size_t SenderCache::size() const
+{
+    Guard l(x_cache);
+    return m_cache.size();
+}
+
+void SenderCache::clear()
+{
+    Guard l(x_cache);
+    m_cache.clear();
+}
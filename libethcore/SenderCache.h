@@ -0,0 +1,46 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+#pragma once
+
+#include <libdevcore/Guards.h>
+#include <libdevcore/LruCache.h>
+#include <libethcore/Common.h>
+
+#include <boost/optional.hpp>
+
+namespace dev
+{
+namespace eth
+{
+/**
+ * @brief Process-wide bounded cache of transaction senders keyed by the transaction hash.
+ *
+ * The hash covers the signature, so it determines the sender. TransactionBase::sender() consults
+ * the cache before recovering the public key from the signature, so a transaction recovered once,
+ * e.g. by the transaction queue, is not recovered again when the block including it is verified
+ * and executed.
+ */
+class SenderCache
+{
+public:
+    static SenderCache& instance();
+
+    /// @returns the sender of the transaction with the given hash if cached.
+    boost::optional<Address> lookup(h256 const& _transactionHash);
+    void insert(h256 const& _transactionHash, Address const& _sender);
+
+    size_t size() const;
+    void clear();
+
+private:
+    /// Enough for the transaction queue and a few blocks of transactions.
+    static constexpr size_t c_capacity = 64 * 1024;
+
+    SenderCache() : m_cache{c_capacity} {}
+
+    mutable Mutex x_cache;
+    LruCache<h256, Address> m_cache;
+};
+}  // namespace eth
+}  // namespace dev
@@ -8,6 +8,7 @@
 #include <libethcore/Exceptions.h>
 #include "TransactionBase.h"
 #include "EVMSchedule.h"
+#include "SenderCache.h"
 
 using namespace std;
 using namespace dev;
@@ -117,10 +118,17 @@ Address const& TransactionBase::sender() const
             if (!m_vrs)
                 BOOST_THROW_EXCEPTION(TransactionIsUnsigned());
 
-            auto p = recover(*m_vrs, sha3(WithoutSignature));
-            if (!p)
-                BOOST_THROW_EXCEPTION(InvalidSignature());
-            m_sender = right160(dev::sha3(bytesConstRef(p.data(), sizeof(p))));
+            auto& senderCache = SenderCache::instance();
+            h256 const hash = sha3(WithSignature);
+            m_sender = senderCache.lookup(hash);
+            if (!m_sender)
+            {
+                auto p = recover(*m_vrs, sha3(WithoutSignature));
+                if (!p)
+                    BOOST_THROW_EXCEPTION(InvalidSignature());
+                m_sender = right160(dev::sha3(bytesConstRef(p.data(), sizeof(p))));
+                senderCache.insert(hash, *m_sender);
+            }
         }
     }
     return *m_sender;
@@ -11,6 +11,7 @@
 #include <libethcore/Common.h>
 
 #include <boost/filesystem/path.hpp>
+#include <memory>
 
 namespace dev
 {
@@ -173,10 +174,18 @@ public:
 
     /// Specify to the object what the actual code is for the account. @a _code must have a SHA3
     /// equal to codeHash().
-    void noteCode(bytesConstRef _code) { assert(sha3(_code) == m_codeHash); m_codeCache = _code.toBytes(); }
+    void noteCode(std::shared_ptr<bytes const> _code)
+    {
+        assert(_code && sha3(*_code) == m_codeHash);
+        m_codeCache = std::move(_code);
+    }
 
     /// @returns the account's code.
-    bytes const& code() const { return m_codeCache; }
+    bytes const& code() const { return m_codeCache ? *m_codeCache : NullBytes; }
+
+    /// @returns the account's code as a buffer that stays valid after the account is changed or
+    /// dropped from the cache, or null if the code is not known.
+    std::shared_ptr<bytes const> const& sharedCode() const { return m_codeCache; }
 
     u256 version() const { return m_version; }
 
@@ -221,8 +230,9 @@ private:
     mutable std::unordered_map<u256, u256> m_storageOriginal;
 
     /// The associated code for this account. The SHA3 of this should be equal to m_codeHash unless
-    /// m_codeHash equals c_contractConceptionCodeHash.
-    bytes m_codeCache;
+    /// m_codeHash equals c_contractConceptionCodeHash. Immutable and shared between the copies of
+    /// the account and the VM frames executing it.
+    std::shared_ptr<bytes const> m_codeCache;
 
     /// Value for m_codeHash when this account is having its code determined.
     static const h256 c_contractConceptionCodeHash;
@@ -68,6 +68,7 @@ Block::Block(Block const& _s):
     m_transactions(_s.m_transactions),
     m_receipts(_s.m_receipts),
     m_transactionSet(_s.m_transactionSet),
+    m_transactionRoots(_s.m_transactionRoots),
     m_precommit(_s.m_state),
     m_previousBlock(_s.m_previousBlock),
     m_currentBlock(_s.m_currentBlock),
@@ -87,6 +88,7 @@ Block& Block::operator=(Block const& _s)
     m_transactions = _s.m_transactions;
     m_receipts = _s.m_receipts;
     m_transactionSet = _s.m_transactionSet;
+    m_transactionRoots = _s.m_transactionRoots;
     m_previousBlock = _s.m_previousBlock;
     m_currentBlock = _s.m_currentBlock;
     m_currentBytes = _s.m_currentBytes;
@@ -103,6 +105,7 @@ void Block::resetCurrent(int64_t _timestamp)
     m_transactions.clear();
     m_receipts.clear();
     m_transactionSet.clear();
+    m_transactionRoots.clear();
     m_currentBlock = BlockHeader();
     m_currentBlock.setAuthor(m_author);
     m_currentBlock.setTimestamp(max(m_previousBlock.timestamp() + 1, _timestamp));
@@ -181,6 +184,7 @@ void Block::populateFromChain(BlockChain const& _bc, h256 const& _h)
         m_transactionSet.insert(m_transactions.back().sha3());
     }
     m_receipts = _bc.receipts(_h).receipts;
+    m_transactionRoots.clear();
 
     m_author = blockHeader.author();
 
@@ -379,6 +383,28 @@ pair<TransactionReceipts, bool> Block::sync(BlockChain const& _bc, TransactionQu
     return ret;
 }
 
+bool Block::rollbackPending(unsigned _i)
+{
+    if (isSealed())
+        BOOST_THROW_EXCEPTION(InvalidOperationOnSealedBlock());
+
+    if (_i >= m_transactions.size())
+        return true;
+    // Transactions populated from the chain were not executed here.
+    if (m_transactionRoots.size() != m_transactions.size() ||
+        !m_state.db().exists(m_transactionRoots[_i]))
+        return false;
+
+    uncommitToSeal();
+    m_state.setRoot(m_transactionRoots[_i]);
+    for (unsigned i = _i; i < m_transactions.size(); ++i)
+        m_transactionSet.erase(m_transactions[i].sha3());
+    m_transactions.erase(m_transactions.begin() + _i, m_transactions.end());
+    m_receipts.erase(m_receipts.begin() + _i, m_receipts.end());
+    m_transactionRoots.erase(m_transactionRoots.begin() + _i, m_transactionRoots.end());
+    return true;
+}
+
 u256 Block::enactOn(VerifiedBlockRef const& _block, BlockChain const& _bc)
 {
     noteChain(_bc);
@@ -633,6 +659,7 @@ ExecutionResult Block::execute(
     uncommitToSeal();
 
     EnvInfo const envInfo{info(), _lh, gasUsed(), m_sealEngine->chainParams().chainID};
+    h256 const rootBefore = m_state.rootHash();
     std::pair<ExecutionResult, TransactionReceipt> resultReceipt =
         m_state.execute(envInfo, *m_sealEngine, _t, _p, _onOp);
 
@@ -642,6 +669,7 @@ ExecutionResult Block::execute(
         m_transactions.push_back(_t);
         m_receipts.push_back(resultReceipt.second);
         m_transactionSet.insert(_t.sha3());
+        m_transactionRoots.push_back(rootBefore);
     }
 
     return resultReceipt.first;
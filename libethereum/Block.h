@@ -152,11 +152,22 @@ public:
     /// normal sealable block, don't expect things to work right.
     State& mutableState() { return m_state; }
 
+    /// Get the state before the rewards were applied, which transactions executed in this block
+    /// see. Differs from state() only when the block is committed to seal.
+    State const& stateBeforeRewards() const { return m_committedToSeal ? m_precommit : m_state; }
+
+    /// Shares the caches of the states with the copies of this block made from now on.
+    /// @see State::shareCaches()
+    void shareCaches() { m_state.shareCaches(); m_precommit.shareCaches(); }
+
     // Information concerning ongoing transactions
 
     /// Get the remaining gas limit in this block.
     u256 gasLimitRemaining() const { return m_currentBlock.gasLimit() - gasUsed(); }
 
+    /// @returns gas used by transactions thus far executed.
+    u256 gasUsed() const { return m_receipts.size() ? m_receipts.back().cumulativeGasUsed() : 0; }
+
     /// Get the list of pending transactions.
     Transactions const& pending() const { return m_transactions; }
 
@@ -194,6 +205,12 @@ public:
     /// @returns a list of receipts one for each transaction placed from the queue into the state and bool, true iff there are more transactions to be processed.
     std::pair<TransactionReceipts, bool> sync(BlockChain const& _bc, TransactionQueue& _tq, GasPricer const& _gp, unsigned _msTimeout = 100);
 
+    /// Drop the pending transactions from the one at index @a _i on, restoring the state from
+    /// before it was executed. The transactions before it are kept without being re-executed.
+    /// @returns false if the state before transaction @a _i is not available any more, in which
+    /// case the block is left unchanged.
+    bool rollbackPending(unsigned _i);
+
     /// Sync our state with the block chain.
     /// This basically involves wiping ourselves if we've been superceded and rebuilding from the transaction queue.
     bool sync(BlockChain const& _bc);
@@ -263,9 +280,6 @@ private:
     /// Finalise the block, applying the earned rewards.
     void applyRewards(std::vector<BlockHeader> const& _uncleBlockHeaders, u256 const& _blockReward);
 
-    /// @returns gas used by transactions thus far executed.
-    u256 gasUsed() const { return m_receipts.size() ? m_receipts.back().cumulativeGasUsed() : 0; }
-
     /// Performs irregular modifications right after initialization, e.g. to implement a hard fork.
     void performIrregularModifications();
 
@@ -276,6 +290,7 @@ private:
     Transactions m_transactions;				///< The current list of transactions that we've included in the state.
     TransactionReceipts m_receipts;				///< The corresponding list of transaction receipts.
     h256Hash m_transactionSet;					///< The set of transaction hashes that we've included in the state.
+    h256s m_transactionRoots;					///< State root before each of the executed transactions.
     State m_precommit;							///< State at the point immediately prior to rewards.
 
     BlockHeader m_previousBlock;				///< The previous block's information.
@@ -13,6 +13,7 @@
 #include <libdevcore/DBFactory.h>
 #include <libdevcore/FileSystem.h>
 #include <libdevcore/FixedHash.h>
+#include <libdevcore/OrderedParallel.h>
 #include <libdevcore/RLP.h>
 #include <libdevcore/TrieHash.h>
 #include <libethcore/BlockHeader.h>
@@ -22,6 +23,8 @@
 #include <boost/exception/errinfo_nested_exception.hpp>
 #include <boost/filesystem.hpp>
 
+#include <thread>
+
 using namespace std;
 using namespace dev;
 using namespace dev::eth;
@@ -32,6 +35,53 @@ namespace fs = boost::filesystem;
 namespace {
 std::string const c_chainStart{"chainStart"};
 db::Slice const c_sliceChainStart{c_chainStart};
+
+/// The number of consecutive blocks a thread reindexes at once.
+constexpr unsigned c_reindexSegmentBlocks = 256;
+/// The number of blocks written to the extras database at once, a multiple of the blocks of the
+/// top level blooms chunks so that each batch completes those it writes.
+constexpr unsigned c_reindexBatchBlocks = 16 * c_reindexSegmentBlocks;
+
+/// What the extras of a canonical block are computed from.
+struct ReindexedBlock
+{
+    h256 hash;
+    h256 parentHash;
+    u256 difficulty;
+    size_t size = 0;
+    LogBloom bloom; ///< The bloom of the block and its author, as kept in the blocks blooms.
+    h256s transactionHashes;
+    BlockReceipts receipts;
+};
+
+/// Reads and decodes the canonical block @a _number.
+ReindexedBlock reindexedBlock(db::DatabaseFace const& _blocksDB, db::DatabaseFace const& _oldExtrasDB, unsigned _number) {
+    ReindexedBlock ret;
+    string const hash = _oldExtrasDB.lookup(toSlice(h256(_number), ExtraBlockHash));
+    if (hash.empty()) BOOST_THROW_EXCEPTION(DatabaseRebuildFailed() << errinfo_comment("No hash of block #" + toString(_number)));
+    ret.hash = BlockHash(RLP(hash)).value;
+
+    string const block = _blocksDB.lookup(toSlice(ret.hash));
+    if (block.empty()) BOOST_THROW_EXCEPTION(DatabaseRebuildFailed() << errinfo_comment("Missing block #" + toString(_number)));
+    RLP const blockRLP(block);
+    BlockHeader const header(blockRLP[0].data(), HeaderData, ret.hash);
+    ret.parentHash = header.parentHash();
+    ret.difficulty = header.difficulty();
+    ret.size = block.size();
+    ret.bloom = header.logBloom();
+    ret.bloom.shiftBloom<3>(sha3(header.author().ref()));
+
+    vector<bytesConstRef> transactions;
+    transactions.reserve(blockRLP[1].itemCount());
+    for (auto const& tr: blockRLP[1]) transactions.push_back(tr.data());
+    ret.transactionHashes = sha3Batch(transactions);
+
+    string const receipts = _oldExtrasDB.lookup(toSlice(ret.hash, ExtraReceipts));
+    if (receipts.empty()) BOOST_THROW_EXCEPTION(DatabaseRebuildFailed() << errinfo_comment("No receipts of block #" + toString(_number)));
+    ret.receipts = BlockReceipts(RLP(receipts));
+    if (ret.receipts.receipts.size() != transactions.size()) BOOST_THROW_EXCEPTION(DatabaseRebuildFailed() << errinfo_comment("Receipts do not match the transactions of block #" + toString(_number)));
+    return ret;
+}
 }
 
 std::ostream& dev::eth::operator<<(std::ostream& _out, BlockChain const& _bc) {
@@ -102,14 +152,36 @@ public:
     h256s precedingHashes(h256 const& _mostRecentHash) const override
     {
         Guard l(m_lastHashesMutex);
-        if (m_lastHashes.empty() || m_lastHashes.front() != _mostRecentHash)
+        if (!m_lastHashes.empty() && m_lastHashes.front() == _mostRecentHash)
+            return m_lastHashes;
+
+        h256s ret(256);
+        h256 hash = _mostRecentHash;
+        for (unsigned i = 0; i < ret.size() && hash; ++i)
         {
-            m_lastHashes.resize(256);
-            m_lastHashes[0] = _mostRecentHash;
-            for (unsigned i = 0; i < 255; ++i)
-                m_lastHashes[i + 1] = m_lastHashes[i] ? m_bc.info(m_lastHashes[i]).parentHash() : h256();
+            // Once on the canonical chain, the ancestors are read from the ring of the chain.
+            h256s const canonical = m_bc.canonicalAncestors(hash, static_cast<unsigned>(ret.size()) - i);
+            if (!canonical.empty())
+            {
+                copy(canonical.begin(), canonical.end(), ret.begin() + i);
+                break;
+            }
+            ret[i] = hash;
+            hash = m_bc.info(hash).parentHash();
         }
-        return m_lastHashes;
+        m_lastHashes = ret;
+        return ret;
+    }
+
+    h256 precedingHash(h256 const& _mostRecentHash, unsigned _distance) const override
+    {
+        unsigned const number = m_bc.number(_mostRecentHash);
+        if (_distance > number)
+            return h256();
+        h256s const canonical = m_bc.canonicalAncestors(_mostRecentHash, _distance + 1);
+        if (canonical.size() == _distance + 1)
+            return canonical.back();
+        return LastBlockHashesFace::precedingHash(_mostRecentHash, _distance);
     }
 
     void clear() override
@@ -135,12 +207,13 @@ void addBlockInfo(Exception& io_ex, BlockHeader const& _header, bytes&& _blockDa
         io_ex << errinfo_extraData(_header.extraData());
 }
 
+/// Opens a DB of the chain, which passes everything to the disk DB until buffered.
+std::unique_ptr<db::BufferedDB> openChainDB(fs::path const& _path)
+{
+    return std::unique_ptr<db::BufferedDB>(new db::BufferedDB(db::DBFactory::create(_path)));
 }
 
-static const chrono::system_clock::duration c_collectionDuration = chrono::seconds(60); /// Duration between flushes.
-static const unsigned c_collectionQueueSize = 20; /// Length of death row (total time in cache is multiple of this and collection duration).
-static const unsigned c_maxCacheSize = 1024 * 1024 * 64; /// Max size, above which we start forcing cache reduction.
-static const unsigned c_minCacheSize = 1024 * 1024 * 32; /// Min size, below which we don't bother flushing it.
+}
 
 BlockChain::BlockChain(ChainParams const& _p, fs::path const& _dbPath, WithExisting _we, ProgressCallback const& _pc) : m_lastBlockHashes(new LastBlockHashes(*this)) {
     init(_p);
@@ -165,10 +238,6 @@ BlockHeader const& BlockChain::genesis() const {
 }
 
 void BlockChain::init(ChainParams const& _p) {
-    // initialise deathrow.
-    m_cacheUsage.resize(c_collectionQueueSize);
-    m_lastCollection = chrono::system_clock::now();
-
     // Initialise with the genesis as the last block on the longest chain.
     m_params = _p;
     m_sealEngine.reset(m_params.createSealEngine());
@@ -208,8 +277,8 @@ bool BlockChain::open(fs::path const& _path, WithExisting _we) {
     }
 
     try {
-        m_blocksDB = db::DBFactory::create(m_dbPaths->blocksPath());
-        m_extrasDB = db::DBFactory::create(m_dbPaths->extrasPath());
+        m_blocksDB = openChainDB(m_dbPaths->blocksPath());
+        m_extrasDB = openChainDB(m_dbPaths->extrasPath());
     } catch (db::DatabaseError const& ex) { // Determine which database open call failed
         auto const dbPath = !m_blocksDB.get() ? m_dbPaths->blocksPath() : m_dbPaths->extrasPath();
         if (db::isDiskDatabase()) {
@@ -234,8 +303,9 @@ bool BlockChain::open(fs::path const& _path, WithExisting _we) {
         bytes const genesisBlockBytes = m_params.genesisBlock();
         BlockHeader const genesisHeader{genesisBlockBytes};
         // Insert details of genesis block.
-        m_details[m_genesisHash] = BlockDetails{0 /* number */, genesisHeader.difficulty(), h256{} /* parent */, {} /* children */, genesisBlockBytes.size()};
-        auto const genesisDetailsRlp = m_details[m_genesisHash].rlp();
+        BlockDetails const genesisDetails{0 /* number */, genesisHeader.difficulty(), h256{} /* parent */, {} /* children */, genesisBlockBytes.size()};
+        auto const genesisDetailsRlp = genesisDetails.rlp();
+        m_details.insert(m_genesisHash, genesisDetails);
         m_extrasDB->insert(toSlice(m_genesisHash, ExtraDetails), (db::Slice)dev::ref(genesisDetailsRlp));
         assert(isKnown(genesisHeader.hash()));
     }
@@ -243,6 +313,12 @@ bool BlockChain::open(fs::path const& _path, WithExisting _we) {
     // TODO: Implement ability to rebuild details map from DB.
     auto const l = m_blocksDB->lookup(db::Slice("best"));
     m_lastBlockNumber = info(m_lastBlockHash = l.empty() ? m_genesisHash : h256(l, h256::FromBinary)).number();
+    m_canonicalHashes.reset(m_lastBlockNumber, m_lastBlockHash);
+
+    if (isLogIndexEnabled())
+        m_logIndex.reset(new LogIndex(*m_extrasDB, m_lastBlockNumber + 1, blockChainCacheBudgets().logIndex));
+    else
+        LogIndex::forget(*m_extrasDB);
 
     LOG(m_loggerInfo) << "Opened blockchain database. Latest block hash: " << currentHash() << (!rebuildNeeded ? "(rebuild not needed)" : "*** REBUILD NEEDED ***");
     return rebuildNeeded;
@@ -250,6 +326,7 @@ bool BlockChain::open(fs::path const& _path, WithExisting _we) {
 
 void BlockChain::open(fs::path const& _path, WithExisting _we, ProgressCallback const& _pc) {
     if (open(_path, _we) || _we == WithExisting::Verify) rebuild(_path, _pc);
+    else if (_we == WithExisting::ReindexExtras) reindexExtras(_pc);
 }
 
 void BlockChain::reopen(ChainParams const& _p, WithExisting _we, ProgressCallback const& _pc) {
@@ -262,6 +339,9 @@ void BlockChain::close()
 {
     ctrace << "Closing blockchain DB";
     // Not thread safe...
+    if (m_blocksDB && m_extrasDB)
+        flushWrites();
+    m_logIndex.reset();
     m_extrasDB.reset();
     m_blocksDB.reset();
     DEV_WRITE_GUARDED(x_lastBlockHash)
@@ -276,8 +356,7 @@ void BlockChain::close()
     m_transactionAddresses.clear();
     m_blockHashes.clear();
     m_blocksBlooms.clear();
-    m_cacheUsage.clear();
-    m_inUse.clear();
+    m_canonicalHashes.reset(0, m_genesisHash);
     m_lastBlockHashes->clear();
 }
 
@@ -297,6 +376,7 @@ void BlockChain::rebuild(fs::path const& _path, std::function<void(unsigned, uns
     ///////////////////////////////
 
     // Keep extras DB around, but under a temp name
+    m_logIndex.reset();
     m_extrasDB.reset();
     LOG(m_loggerInfo) << "Renaming extras path " << m_dbPaths->extrasPath() << " to "  << m_dbPaths->extrasTemporaryPath();
     if (fs::exists(m_dbPaths->extrasTemporaryPath()))
@@ -312,7 +392,9 @@ void BlockChain::rebuild(fs::path const& _path, std::function<void(unsigned, uns
     fs::rename(m_dbPaths->extrasPath(), m_dbPaths->extrasTemporaryPath());
     std::unique_ptr<db::DatabaseFace> oldExtrasDB{
         db::DBFactory::create(m_dbPaths->extrasTemporaryPath())};
-    m_extrasDB = db::DBFactory::create(m_dbPaths->extrasPath());
+    m_extrasDB = openChainDB(m_dbPaths->extrasPath());
+    if (isLogIndexEnabled())
+        m_logIndex.reset(new LogIndex(*m_extrasDB, 1, blockChainCacheBudgets().logIndex));
 
     // Open a fresh state DB
     Block s = genesisBlock(State::openDB(m_dbPaths->rootPath(), m_genesisHash, WithExisting::Kill));
@@ -327,17 +409,21 @@ void BlockChain::rebuild(fs::path const& _path, std::function<void(unsigned, uns
     m_lastBlockHashes->clear();
     m_lastBlockHash = genesisHash();
     m_lastBlockNumber = 0;
+    m_canonicalHashes.reset(0, m_lastBlockHash);
 
-    m_details[m_lastBlockHash].totalDifficulty = s.info().difficulty();
+    bytes lastDetailsRlp;
+    m_details.modify(m_lastBlockHash, [] { return BlockDetails(); }, [&](BlockDetails& _d) {
+        _d.totalDifficulty = s.info().difficulty();
+        lastDetailsRlp = _d.rlp();
+    });
 
-    m_extrasDB->insert(toSlice(m_lastBlockHash, ExtraDetails),
-        (db::Slice)dev::ref(m_details[m_lastBlockHash].rlp()));
+    m_extrasDB->insert(toSlice(m_lastBlockHash, ExtraDetails), (db::Slice)dev::ref(lastDetailsRlp));
 
     // Manually insert the genesis block details so that they're available during import of the
     // first block.
     auto const genesisDetails = BlockDetails{0 /* block number */, s.info().difficulty(), h256{} /* parent */, {} /* children */, m_params.genesisBlock().size()};
-    m_details[m_genesisHash] = genesisDetails;
     auto const genesisDetailsRlp = genesisDetails.rlp();
+    m_details.insert(m_genesisHash, genesisDetails);
     m_extrasDB->insert(toSlice(m_genesisHash, ExtraDetails), (db::Slice)dev::ref(genesisDetailsRlp));
 
     LOG(m_loggerInfo) << "Rebuilding the extras and state databases by reimporting blocks 0 -> " << originalNumber << ", this will probably take a while";
@@ -351,7 +437,7 @@ void BlockChain::rebuild(fs::path const& _path, std::function<void(unsigned, uns
             t.restart();
         }
         try {
-            bytes b = block(queryExtras<BlockHash, uint64_t, ExtraBlockHash>(d, m_blockHashes, x_blockHashes, NullBlockHash, oldExtrasDB.get()).value);
+            bytes b = block(queryExtras<BlockHash, uint64_t, ExtraBlockHash>(d, m_blockHashes, NullBlockHash, oldExtrasDB.get()).value);
             BlockHeader bi(&b);
             if (bi.parentHash() != lastHash)
             {
@@ -391,6 +477,132 @@ void BlockChain::rebuild(fs::path const& _path, std::function<void(unsigned, uns
     }
 }
 
+void BlockChain::reindexExtras(ProgressCallback const& _progress) {
+    if (!db::isDiskDatabase()) {
+        LOG(m_loggerWarn) << "In-memory database detected, skipping reindex (since there's no existing database to reindex)";
+        return;
+    }
+
+    unsigned const lastNumber = m_lastBlockNumber;
+    h256 const lastHash = m_lastBlockHash;
+
+    // Keep the old extras DB, where the block hashes and receipts are read from, under a temp name.
+    m_logIndex.reset();
+    m_extrasDB.reset();
+    if (fs::exists(m_dbPaths->extrasTemporaryPath())) {
+        LOG(m_loggerError) << "Temporary extras path " << m_dbPaths->extrasTemporaryPath() << " already exists (this usually happens because an in-progress rebuild was prematurely terminated).";
+        BOOST_THROW_EXCEPTION(DatabaseExists());
+    }
+    fs::rename(m_dbPaths->extrasPath(), m_dbPaths->extrasTemporaryPath());
+    std::unique_ptr<db::DatabaseFace> oldExtrasDB{db::DBFactory::create(m_dbPaths->extrasTemporaryPath())};
+    m_extrasDB = openChainDB(m_dbPaths->extrasPath());
+    if (isLogIndexEnabled()) m_logIndex.reset(new LogIndex(*m_extrasDB, 1, blockChainCacheBudgets().logIndex));
+
+    m_details.clear();
+    m_logBlooms.clear();
+    m_receipts.clear();
+    m_transactionAddresses.clear();
+    m_blockHashes.clear();
+    m_blocksBlooms.clear();
+
+    unsigned const segments = (lastNumber + c_reindexSegmentBlocks - 1) / c_reindexSegmentBlocks;
+    unsigned const threads = max(thread::hardware_concurrency(), 1u);
+    LOG(m_loggerInfo) << "Reindexing the extras of blocks 0 -> " << lastNumber << " on " << threads << " threads";
+    Timer total;
+    Timer t;
+    try {
+        BlockHeader const genesis(m_params.genesisBlock());
+        BlockDetails previous{0, genesis.difficulty(), h256{}, {}, m_params.genesisBlock().size()};
+        h256 previousHash = m_genesisHash;
+        std::unique_ptr<db::WriteBatchFace> batch = m_extrasDB->createWriteBatch();
+        unordered_map<h256, BlocksBlooms> blooms; // The blocks blooms chunks of the batch.
+        vector<NumberedReceipts> logs;            // The receipts of the batch, for the log index.
+        unsigned written = 0;
+        auto const writeBatch = [&](unsigned _written) {
+            for (auto const& b: blooms) batch->insert(toSlice(b.first, ExtraBlocksBlooms), (db::Slice)dev::ref(b.second.rlp()));
+            blooms.clear();
+            LogIndex::ChunkChanges logIndexChanges;
+            if (m_logIndex) logIndexChanges = m_logIndex->update(*batch, {}, logs);
+            logs.clear();
+            m_extrasDB->commit(std::move(batch));
+            if (m_logIndex) m_logIndex->noteCommitted(logIndexChanges);
+            batch = m_extrasDB->createWriteBatch();
+
+            if (_written == written) return;
+            LOG(m_loggerInfo) << "Reindexed " << _written << "/" << lastNumber << " blocks, " << ((_written - written) / t.elapsed()) << " b/s";
+            written = _written;
+            t.restart();
+            if (_progress) _progress(_written, lastNumber);
+        };
+
+        // The workers decode segments of blocks ahead of the writer, which takes them in order.
+        unsigned number = 0;
+        forEachInOrder<vector<ReindexedBlock>>(segments, threads, "reindex", [&](size_t _segment) {
+            vector<ReindexedBlock> blocks;
+            unsigned const first = _segment * c_reindexSegmentBlocks + 1;
+            for (unsigned n = first; n < first + c_reindexSegmentBlocks && n <= lastNumber; ++n)
+                blocks.push_back(reindexedBlock(*m_blocksDB, *oldExtrasDB, n));
+            return blocks;
+        }, [&](vector<ReindexedBlock>& _blocks) {
+            for (ReindexedBlock& b: _blocks) {
+                ++number;
+                if (b.parentHash != previousHash) {
+                    LOG(m_loggerError) << "DISJOINT CHAIN DETECTED; " << b.hash << "#" << number << " -> parent is" << b.parentHash << "; expected" << previousHash << "#" << (number - 1);
+                    BOOST_THROW_EXCEPTION(DisjointChain());
+                }
+                previous.childHashes = {b.hash};
+                batch->insert(toSlice(previousHash, ExtraDetails), (db::Slice)dev::ref(previous.rlp()));
+                previous = BlockDetails{number, previous.totalDifficulty + b.difficulty, b.parentHash, {}, b.size};
+                previousHash = b.hash;
+
+                TransactionAddress ta;
+                ta.blockHash = b.hash;
+                for (ta.index = 0; ta.index < b.transactionHashes.size(); ++ta.index)
+                    batch->insert(toSlice(b.transactionHashes[ta.index], ExtraTransactionAddress), (db::Slice)dev::ref(ta.rlp()));
+
+                BlockLogBlooms blb;
+                for (auto const& receipt: b.receipts.receipts) blb.blooms.push_back(receipt.bloom());
+                batch->insert(toSlice(b.hash, ExtraLogBlooms), (db::Slice)dev::ref(blb.rlp()));
+                batch->insert(toSlice(b.hash, ExtraReceipts), (db::Slice)dev::ref(b.receipts.compactRlp()));
+                batch->insert(toSlice(h256(number), ExtraBlockHash), (db::Slice)dev::ref(BlockHash(b.hash).rlp()));
+
+                for (unsigned level = 0, index = number; level < c_bloomIndexLevels; level++, index /= c_bloomIndexSize)
+                    blooms[chunkId(level, index / c_bloomIndexSize)].blooms[index % c_bloomIndexSize] |= b.bloom;
+                if (m_logIndex) logs.emplace_back(number, move(b.receipts.receipts));
+
+                // Batches end with the blooms chunks.
+                if ((number + 1) % c_reindexBatchBlocks == 0) writeBatch(number);
+            }
+        });
+        batch->insert(toSlice(previousHash, ExtraDetails), (db::Slice)dev::ref(previous.rlp()));
+        batch->insert(db::Slice("best"), db::Slice((char const*)&lastHash, 32));
+        writeBatch(lastNumber);
+    } catch (...) {
+        // Put the old extras back.
+        LOG(m_loggerError) << "Reindex failed with error: " << boost::current_exception_diagnostic_information();
+        m_logIndex.reset();
+        m_extrasDB.reset();
+        oldExtrasDB.reset();
+        fs::remove_all(m_dbPaths->extrasPath());
+        fs::rename(m_dbPaths->extrasTemporaryPath(), m_dbPaths->extrasPath());
+        m_extrasDB = openChainDB(m_dbPaths->extrasPath());
+        if (isLogIndexEnabled()) m_logIndex.reset(new LogIndex(*m_extrasDB, m_lastBlockNumber + 1, blockChainCacheBudgets().logIndex));
+        m_details.clear();
+        m_receipts.clear();
+        BOOST_THROW_EXCEPTION(DatabaseRebuildFailed());
+    }
+
+    LOG(m_loggerInfo) << "Removing old extras database: " << m_dbPaths->extrasTemporaryPath();
+    oldExtrasDB.reset();
+    fs::remove_all(m_dbPaths->extrasTemporaryPath());
+    writeFile(m_dbPaths->extrasMinorVersionPath(), rlp(c_databaseMinorVersion));
+
+    m_details.clear();
+    m_canonicalHashes.reset(lastNumber, lastHash);
+    m_lastBlockHashes->clear();
+    LOG(m_loggerInfo) << "Reindex complete! Reindexed " << lastNumber << " blocks in " << total.elapsed() << "s";
+}
+
 string BlockChain::dumpDatabase() const
 {
     ostringstream oss;
@@ -545,22 +757,24 @@ void BlockChain::insert(VerifiedBlockRef _block, bytesConstRef _receipts, bool _
     std::unique_ptr<db::WriteBatchFace> blocksWriteBatch = m_blocksDB->createWriteBatch();
     std::unique_ptr<db::WriteBatchFace> extrasWriteBatch = m_extrasDB->createWriteBatch();
 
+    BlockReceipts const br{RLP(_receipts)};
     BlockLogBlooms blb;
-    for (auto i: RLP(_receipts))
-        blb.blooms.push_back(TransactionReceipt(i.data()).bloom());
-
-    // ensure parent is cached for later addition.
-    // TODO: this is a bit horrible would be better refactored into an enveloping UpgradableGuard
-    // together with an "ensureCachedWithUpdatableLock(l)" method.
-    // This is safe in practice since the caches don't get flushed nearly often enough to be
-    // done here.
-    details(_block.info.parentHash());
-    DEV_WRITE_GUARDED(x_details) if (!dev::contains(m_details[_block.info.parentHash()].childHashes, _block.info.hash())) m_details[_block.info.parentHash()].childHashes.push_back(_block.info.hash());
+    for (auto const& receipt: br.receipts)
+        blb.blooms.push_back(receipt.bloom());
+
+    // Add the block to the children of its parent, loading the parent first if not cached.
+    bytes parentDetailsRlp;
+    m_details.modify(_block.info.parentHash(),
+        extrasLoader<BlockDetails, ExtraDetails>(_block.info.parentHash()),
+        [&](BlockDetails& _d) {
+            if (!dev::contains(_d.childHashes, _block.info.hash()))
+                _d.childHashes.push_back(_block.info.hash());
+            parentDetailsRlp = _d.rlp();
+        });
 
     blocksWriteBatch->insert(toSlice(_block.info.hash()), db::Slice(_block.block));
-    DEV_READ_GUARDED(x_details)
     extrasWriteBatch->insert(toSlice(_block.info.parentHash(), ExtraDetails),
-        (db::Slice)dev::ref(m_details[_block.info.parentHash()].rlp()));
+        (db::Slice)dev::ref(parentDetailsRlp));
 
     BlockDetails bd{static_cast<unsigned>(pd.number + 1),
         pd.totalDifficulty + _block.info.difficulty(), _block.info.parentHash(), {} /* children */,
@@ -569,7 +783,8 @@ void BlockChain::insert(VerifiedBlockRef _block, bytesConstRef _receipts, bool _
         toSlice(_block.info.hash(), ExtraDetails), (db::Slice)dev::ref(bd.rlp()));
     extrasWriteBatch->insert(
         toSlice(_block.info.hash(), ExtraLogBlooms), (db::Slice)dev::ref(blb.rlp()));
-    extrasWriteBatch->insert(toSlice(_block.info.hash(), ExtraReceipts), (db::Slice)_receipts);
+    extrasWriteBatch->insert(
+        toSlice(_block.info.hash(), ExtraReceipts), (db::Slice)dev::ref(br.compactRlp()));
 
     try { m_blocksDB->commit(std::move(blocksWriteBatch)); }
     catch (boost::exception const& ex) { cwarn << "Error writing to blockchain database: " << boost::diagnostic_information(ex) << "Fail writing to blockchain database. Bombing out."; exit(-1); }
@@ -657,24 +872,28 @@ ImportRoute BlockChain::insertBlockAndExtras(VerifiedBlockRef const& _block, byt
     std::unique_ptr<db::WriteBatchFace> blocksWriteBatch = m_blocksDB->createWriteBatch(), extrasWriteBatch = m_extrasDB->createWriteBatch();
     h256 newLastBlockHash = currentHash();
     unsigned newLastBlockNumber = number();
+    BlockReceipts br;
     try {
-        // ensure parent is cached for later addition.
-        // TODO: this is a bit horrible would be better refactored into an enveloping UpgradableGuard together with an "ensureCachedWithUpdatableLock(l)" method. This is safe in practice since the caches don't get flushed nearly often enough to be done here.
-        details(_block.info.parentHash());
-        DEV_WRITE_GUARDED(x_details) m_details[_block.info.parentHash()].childHashes.push_back(_block.info.hash());
+        // Add the block to the children of its parent, loading the parent first if not cached.
+        bytes parentDetailsRlp;
+        m_details.modify(_block.info.parentHash(), extrasLoader<BlockDetails, ExtraDetails>(_block.info.parentHash()), [&](BlockDetails& _d) {
+            _d.childHashes.push_back(_block.info.hash());
+            parentDetailsRlp = _d.rlp();
+        });
 
         _performanceLogger.onStageFinished("collation");
 
         blocksWriteBatch->insert(toSlice(_block.info.hash()), db::Slice(_block.block));
-        DEV_READ_GUARDED(x_details) extrasWriteBatch->insert(toSlice(_block.info.parentHash(), ExtraDetails), (db::Slice)dev::ref(m_details[_block.info.parentHash()].rlp()));
+        extrasWriteBatch->insert(toSlice(_block.info.parentHash(), ExtraDetails), (db::Slice)dev::ref(parentDetailsRlp));
 
         BlockDetails const details{static_cast<unsigned>(_block.info.number()), _totalDifficulty, _block.info.parentHash(), {} /* children */, _block.block.size()};
         extrasWriteBatch->insert(toSlice(_block.info.hash(), ExtraDetails), (db::Slice)dev::ref(details.rlp()));
 
+        br = BlockReceipts(RLP(_receipts));
         BlockLogBlooms blb;
-        for (auto i: RLP(_receipts)) blb.blooms.push_back(TransactionReceipt(i.data()).bloom());
+        for (auto const& receipt: br.receipts) blb.blooms.push_back(receipt.bloom());
         extrasWriteBatch->insert(toSlice(_block.info.hash(), ExtraLogBlooms), (db::Slice)dev::ref(blb.rlp()));
-        extrasWriteBatch->insert(toSlice(_block.info.hash(), ExtraReceipts), (db::Slice)_receipts);
+        extrasWriteBatch->insert(toSlice(_block.info.hash(), ExtraReceipts), (db::Slice)dev::ref(br.compactRlp()));
 
         _performanceLogger.onStageFinished("writing");
     } catch (Exception& ex) { addBlockInfo(ex, _block.info, _block.block.toBytes()); throw; }
@@ -682,6 +901,9 @@ ImportRoute BlockChain::insertBlockAndExtras(VerifiedBlockRef const& _block, byt
     h256s route;
     bool isImportedAndBest = false; // This might be the new best block...
     h256 common, last = currentHash();
+    unsigned firstCanonical = 0;
+    h256s canonical; // The blocks becoming canonical, from firstCanonical up.
+    LogIndex::ChunkChanges logIndexChanges;
     if (_totalDifficulty > details(last).totalDifficulty || (m_sealEngine->chainParams().tieBreakingGas && _totalDifficulty == details(last).totalDifficulty && _block.info.gasUsed() > info(last).gasUsed())) {
         // don't include bi.hash() in treeRoute, since it's not yet in details DB... just tack it on afterwards.
         unsigned commonIndex;
@@ -695,20 +917,19 @@ ImportRoute BlockChain::insertBlockAndExtras(VerifiedBlockRef const& _block, byt
         for (auto i = route.rbegin(); i != route.rend() && *i != common; ++i) {
             BlockHeader tbi = (*i == _block.info.hash()) ? _block.info : BlockHeader(block(*i));
 
-            // Collate logs into blooms.
-            h256s alteredBlooms;
+            // Collate logs into blooms, encoding each altered chunk for the database.
+            vector<pair<h256, bytes>> alteredBlooms;
             {
                 LogBloom blockBloom = tbi.logBloom();
                 blockBloom.shiftBloom<3>(sha3(tbi.author().ref()));
 
-                // Pre-memoize everything we need before locking x_blocksBlooms
-                for (unsigned level = 0, index = (unsigned)tbi.number(); level < c_bloomIndexLevels; level++, index /= c_bloomIndexSize) blocksBlooms(chunkId(level, index / c_bloomIndexSize));
-
-                WriteGuard l(x_blocksBlooms);
                 for (unsigned level = 0, index = (unsigned)tbi.number(); level < c_bloomIndexLevels; level++, index /= c_bloomIndexSize) {
                     unsigned i = index / c_bloomIndexSize, o = index % c_bloomIndexSize;
-                    alteredBlooms.push_back(chunkId(level, i));
-                    m_blocksBlooms[alteredBlooms.back()].blooms[o] |= blockBloom;
+                    h256 const id = chunkId(level, i);
+                    m_blocksBlooms.modify(id, extrasLoader<BlocksBlooms, ExtraBlocksBlooms>(id), [&](BlocksBlooms& _b) {
+                        _b.blooms[o] |= blockBloom;
+                        alteredBlooms.emplace_back(id, _b.rlp());
+                    });
                 }
             }
             // Collate transaction hashes and remember who they were.
@@ -718,15 +939,34 @@ ImportRoute BlockChain::insertBlockAndExtras(VerifiedBlockRef const& _block, byt
                 RLP blockRLP(*i == _block.info.hash() ? _block.block : &(blockBytes = block(*i)));
                 TransactionAddress ta;
                 ta.blockHash = tbi.hash();
-                for (ta.index = 0; ta.index < blockRLP[1].itemCount(); ++ta.index) extrasWriteBatch->insert(toSlice(sha3(blockRLP[1][ta.index].data()), ExtraTransactionAddress), (db::Slice)dev::ref(ta.rlp()));
+                vector<bytesConstRef> transactions;
+                transactions.reserve(blockRLP[1].itemCount());
+                for (auto const& tr: blockRLP[1])
+                    transactions.push_back(tr.data());
+                h256s const transactionHashes = sha3Batch(transactions);
+                for (ta.index = 0; ta.index < transactionHashes.size(); ++ta.index) extrasWriteBatch->insert(toSlice(transactionHashes[ta.index], ExtraTransactionAddress), (db::Slice)dev::ref(ta.rlp()));
             }
 
             // Update database with them.
-            ReadGuard l1(x_blocksBlooms);
-            for (auto const& h: alteredBlooms) extrasWriteBatch->insert(toSlice(h, ExtraBlocksBlooms), (db::Slice)dev::ref(m_blocksBlooms[h].rlp()));
+            for (auto const& b: alteredBlooms) extrasWriteBatch->insert(toSlice(b.first, ExtraBlocksBlooms), (db::Slice)dev::ref(b.second));
             extrasWriteBatch->insert(toSlice(h256(tbi.number()), ExtraBlockHash), (db::Slice)dev::ref(BlockHash(tbi.hash()).rlp()));
         }
 
+        // Move the log index over to the new canonical chain.
+        if (m_logIndex) {
+            vector<NumberedReceipts> removed, added;
+            bool isOld = true;
+            for (auto const& h: route)
+                if (h == common) isOld = false;
+                else if (h == _block.info.hash()) added.emplace_back((unsigned)_block.info.number(), br.receipts);
+                else (isOld ? removed : added).emplace_back(number(h), receipts(h).receipts);
+            logIndexChanges = m_logIndex->update(*extrasWriteBatch, removed, added);
+        }
+
+        firstCanonical = number(common) + 1;
+        for (auto i = find(route.begin(), route.end(), common); i != route.end(); ++i)
+            if (*i != common) canonical.push_back(*i);
+
         // FINALLY! change our best hash.
         {
             newLastBlockHash = _block.info.hash();
@@ -739,10 +979,12 @@ ImportRoute BlockChain::insertBlockAndExtras(VerifiedBlockRef const& _block, byt
 
     try { m_blocksDB->commit(std::move(blocksWriteBatch)); } catch (boost::exception& ex) { cwarn << "Error writing to blockchain database: " << boost::diagnostic_information(ex) << "Fail writing to blockchain database. Bombing out."; exit(-1); }
     try { m_extrasDB->commit(std::move(extrasWriteBatch)); } catch (boost::exception& ex) { cwarn << "Error writing to extras database: " << boost::diagnostic_information(ex) << "Fail writing to extras database. Bombing out."; exit(-1); }
+    if (m_logIndex) m_logIndex->noteCommitted(logIndexChanges);
 
     if (m_lastBlockHash != newLastBlockHash) DEV_WRITE_GUARDED(x_lastBlockHash) {
         m_lastBlockHash = newLastBlockHash;
         m_lastBlockNumber = newLastBlockNumber;
+        m_canonicalHashes.setHead(firstCanonical, canonical);
         try { m_extrasDB->insert(db::Slice("best"), db::Slice((char const*)&m_lastBlockHash, 32)); }
         catch (boost::exception const& ex) {
             cwarn << "Error writing to extras database: " << boost::diagnostic_information(ex);
@@ -811,8 +1053,10 @@ void BlockChain::clearBlockBlooms(unsigned _begin, unsigned _end)
                 for (auto const& bloom: blocksBlooms(lowerChunkId).blooms)
                     acc |= bloom;
             }
-            blocksBlooms(id);   // make sure it has been memoized.
-            m_blocksBlooms[id].blooms[offset] = acc;
+            m_blocksBlooms.modify(id, extrasLoader<BlocksBlooms, ExtraBlocksBlooms>(id), [&](BlocksBlooms& _b) {
+                _b.blooms[offset] = acc;
+                _b.rlp();   // refresh the size the cache accounts for.
+            });
         }
     }
 }
@@ -867,18 +1111,65 @@ void BlockChain::rescue(OverlayDB const& _db)
     rewind(l);
 }
 
+h256 BlockChain::numberHash(unsigned _i) const
+{
+    if (!_i)
+        return genesisHash();
+
+    uint64_t generation;
+    if (h256 const hash = m_canonicalHashes.find(_i, generation))
+        return hash;
+    h256 const hash = queryExtras<BlockHash, uint64_t, ExtraBlockHash>(_i, m_blockHashes, NullBlockHash).value;
+    if (hash)
+        m_canonicalHashes.fill(_i, hash, generation);
+    return hash;
+}
+
+h256s BlockChain::canonicalAncestors(h256 const& _hash, unsigned _count) const
+{
+    unsigned const n = number(_hash);
+    uint64_t generation;
+    h256s ret = m_canonicalHashes.preceding(n, _hash, _count, generation);
+    // Not in the ring yet: numberHash() puts it there if it is canonical.
+    if (ret.empty() && numberHash(n) == _hash)
+        ret = m_canonicalHashes.preceding(n, _hash, _count, generation);
+
+    // The ancestors missing from the ring are found through the parents of their children, as
+    // the ring may have changed since it was read.
+    for (size_t i = 1; i < ret.size(); ++i)
+        if (!ret[i])
+        {
+            ret[i] = info(ret[i - 1]).parentHash();
+            m_canonicalHashes.fill(n - static_cast<unsigned>(i), ret[i], generation);
+        }
+    return ret;
+}
+
 void BlockChain::rewind(unsigned _newHead)
 {
     DEV_WRITE_GUARDED(x_lastBlockHash)
     {
         if (_newHead >= m_lastBlockNumber)
             return;
+
+        // Drop the logs of the blocks leaving the chain from the index, along with the new head.
+        std::unique_ptr<db::WriteBatchFace> batch = m_extrasDB->createWriteBatch();
+        LogIndex::ChunkChanges logIndexChanges;
+        if (m_logIndex)
+        {
+            vector<NumberedReceipts> removed;
+            for (unsigned n = max(_newHead + 1, m_logIndex->firstBlock()); n <= m_lastBlockNumber; ++n)
+                removed.emplace_back(n, receipts(numberHash(n)).receipts);
+            logIndexChanges = m_logIndex->update(*batch, removed, {});
+        }
+
         clearCachesDuringChainReversion(_newHead + 1);
         m_lastBlockHash = numberHash(_newHead);
         m_lastBlockNumber = _newHead;
         try
         {
-            m_extrasDB->insert(db::Slice("best"), db::Slice((char const*)&m_lastBlockHash, 32));
+            batch->insert(db::Slice("best"), db::Slice((char const*)&m_lastBlockHash, 32));
+            m_extrasDB->commit(std::move(batch));
         }
         catch (boost::exception const& ex)
         {
@@ -888,10 +1179,41 @@ void BlockChain::rewind(unsigned _newHead)
             cwarn << "Fail writing to extras database. Bombing out.";
             exit(-1);
         }
+        if (m_logIndex)
+            m_logIndex->noteCommitted(logIndexChanges);
         noteCanonChanged();
     }
 }
 
+void BlockChain::bufferWrites()
+{
+    m_blocksDB->buffer();
+    m_extrasDB->buffer();
+}
+
+void BlockChain::flushWrites()
+{
+    // The blocks first, so that the best block in the extras is never on the disk without them.
+    try
+    {
+        m_blocksDB->flush();
+        m_extrasDB->flush();
+    }
+    catch (boost::exception const& ex)
+    {
+        cwarn << "Error writing to blockchain database: " << boost::diagnostic_information(ex);
+        cwarn << "Fail writing to blockchain database. Bombing out.";
+        exit(-1);
+    }
+}
+
+void BlockChain::unbufferWrites()
+{
+    flushWrites();
+    m_blocksDB->unbuffer();
+    m_extrasDB->unbuffer();
+}
+
 tuple<h256s, h256, unsigned> BlockChain::treeRoute(h256 const& _from, h256 const& _to, bool _common, bool _pre, bool _post) const
 {
     if (!_from || !_to)
@@ -945,90 +1267,31 @@ tuple<h256s, h256, unsigned> BlockChain::treeRoute(h256 const& _from, h256 const
     return make_tuple(ret, from, i);
 }
 
-void BlockChain::noteUsed(h256 const& _h, unsigned _extra) const {
-    auto id = CacheID(_h, _extra);
-    Guard l(x_cacheUsage);
-    m_cacheUsage[0].insert(id);
-    if (m_cacheUsage[1].count(id)) m_cacheUsage[1].erase(id);
-    else m_inUse.insert(id);
-}
-
-template <class K, class T> static unsigned getHashSize(unordered_map<K, T> const& _map) {
-    unsigned ret = 0;
-    for (auto const& i: _map) ret += i.second.size + 64;
-    return ret;
-}
-
 void BlockChain::updateStats() const {
-    m_lastStats.memBlocks = 0;
-    DEV_READ_GUARDED(x_blocks) for (auto const& i: m_blocks) m_lastStats.memBlocks += i.second.size() + 64;
-    DEV_READ_GUARDED(x_details) m_lastStats.memDetails = getHashSize(m_details);
-    size_t logBloomsSize = 0;
-    size_t blocksBloomsSize = 0;
-    DEV_READ_GUARDED(x_logBlooms) logBloomsSize = getHashSize(m_logBlooms);
-    DEV_READ_GUARDED(x_blocksBlooms) blocksBloomsSize = getHashSize(m_blocksBlooms);
-    m_lastStats.memLogBlooms = logBloomsSize + blocksBloomsSize;
-    DEV_READ_GUARDED(x_receipts) m_lastStats.memReceipts = getHashSize(m_receipts);
-    DEV_READ_GUARDED(x_blockHashes) m_lastStats.memBlockHashes = getHashSize(m_blockHashes);
-    DEV_READ_GUARDED(x_transactionAddresses) m_lastStats.memTransactionAddresses = getHashSize(m_transactionAddresses);
+    m_lastStats.memBlocks = m_blocks.stats().bytes;
+    m_lastStats.memDetails = m_details.stats().bytes;
+    m_lastStats.memLogBlooms = m_logBlooms.stats().bytes + m_blocksBlooms.stats().bytes;
+    m_lastStats.memReceipts = m_receipts.stats().bytes;
+    m_lastStats.memBlockHashes = m_blockHashes.stats().bytes;
+    m_lastStats.memTransactionAddresses = m_transactionAddresses.stats().bytes;
 }
 
-void BlockChain::garbageCollect(bool _force) {
-    updateStats();
-
-    if (!_force && chrono::system_clock::now() < m_lastCollection + c_collectionDuration && m_lastStats.memTotal() < c_maxCacheSize) return;
-    if (m_lastStats.memTotal() < c_minCacheSize) return;
-
-    m_lastCollection = chrono::system_clock::now();
-
-    Guard l(x_cacheUsage);
-    for (CacheID const& id: m_cacheUsage.back()) {
-        m_inUse.erase(id);
-        // kill i from cache.
-        switch (id.second) {
-        case (unsigned)-1: {
-            WriteGuard l(x_blocks);
-            m_blocks.erase(id.first);
-            break;
-        }
-        case ExtraDetails: {
-            WriteGuard l(x_details);
-            m_details.erase(id.first);
-            break;
-        }
-        case ExtraBlockHash: {
-            // m_cacheUsage should not contain ExtraBlockHash elements currently.  See the second noteUsed() in BlockChain.h, which is a no-op.
-            assert(false);
-            break;
-        }
-        case ExtraReceipts: {
-            WriteGuard l(x_receipts);
-            m_receipts.erase(id.first);
-            break;
-        }
-        case ExtraLogBlooms: {
-            WriteGuard l(x_logBlooms);
-            m_logBlooms.erase(id.first);
-            break;
-        }
-        case ExtraTransactionAddress: {
-            WriteGuard l(x_transactionAddresses);
-            m_transactionAddresses.erase(id.first);
-            break;
-        }
-        case ExtraBlocksBlooms: {
-            WriteGuard l(x_blocksBlooms);
-            m_blocksBlooms.erase(id.first);
-            break;
-        }
-        }
-    }
-    m_cacheUsage.pop_back();
-    m_cacheUsage.push_front(std::unordered_set<CacheID>{});
+BlockChainCacheStats BlockChain::cacheStats() const {
+    BlockChainCacheStats ret;
+    ret.blocks = m_blocks.stats();
+    ret.details = m_details.stats();
+    ret.logBlooms = m_logBlooms.stats();
+    ret.receipts = m_receipts.stats();
+    ret.transactionAddresses = m_transactionAddresses.stats();
+    ret.blockHashes = m_blockHashes.stats();
+    ret.blocksBlooms = m_blocksBlooms.stats();
+    if (m_logIndex)
+        ret.logIndex = m_logIndex->cacheStats();
+    return ret;
 }
 
 void BlockChain::checkConsistency() {
-    DEV_WRITE_GUARDED(x_details) { m_details.clear(); }
+    m_details.clear();
 
     m_blocksDB->forEach([this](db::Slice const& _key, db::Slice const& /* _value */) {
         if (_key.size() == 32)
@@ -1048,8 +1311,9 @@ void BlockChain::checkConsistency() {
 
 void BlockChain::clearCachesDuringChainReversion(unsigned _firstInvalid) {
     unsigned end = m_lastBlockNumber + 1;
-    DEV_WRITE_GUARDED(x_blockHashes) for (auto i = _firstInvalid; i < end; ++i) m_blockHashes.erase(i);
-    DEV_WRITE_GUARDED(x_transactionAddresses) m_transactionAddresses.clear(); // TODO: could perhaps delete them individually?
+    for (auto i = _firstInvalid; i < end; ++i) m_blockHashes.remove(i);
+    m_canonicalHashes.rewind(_firstInvalid - 1);
+    m_transactionAddresses.clear(); // TODO: could perhaps delete them individually?
 
     // If we are reverting previous blocks, we need to clear their blooms (in particular, to
     // rebuild any higher level blooms that they contributed to).
@@ -1138,8 +1402,8 @@ h256Hash BlockChain::allKinFrom(h256 const& _parent, unsigned _generations) cons
 bool BlockChain::isKnown(h256 const& _hash, bool _isCurrent) const {
     if (_hash == m_genesisHash) return true;
 
-    DEV_READ_GUARDED(x_blocks) if (!m_blocks.count(_hash) && !m_blocksDB->exists(toSlice(_hash))) { return false; }
-    DEV_READ_GUARDED(x_details) if (!m_details.count(_hash) && !m_extrasDB->exists(toSlice(_hash, ExtraDetails))) { return false; }
+    if (!m_blocks.contains(_hash) && !m_blocksDB->exists(toSlice(_hash))) { return false; }
+    if (!m_details.contains(_hash) && !m_extrasDB->exists(toSlice(_hash, ExtraDetails))) { return false; }
 //  return true;
     return !_isCurrent || details(_hash).number <= m_lastBlockNumber;       // to allow rewind functionality.
 }
@@ -1147,32 +1411,20 @@ bool BlockChain::isKnown(h256 const& _hash, bool _isCurrent) const {
 bytes BlockChain::block(h256 const& _hash) const {
     if (_hash == m_genesisHash) return m_params.genesisBlock();
 
-    {
-        ReadGuard l(x_blocks);
-        auto it = m_blocks.find(_hash);
-        if (it != m_blocks.end()) return it->second;
-    }
+    if (auto cached = m_blocks.find(_hash)) return std::move(*cached);
 
     string const d = m_blocksDB->lookup(toSlice(_hash));
     if (d.empty()) { cwarn << "Couldn't find requested block:" << _hash; return bytes(); }
 
-    noteUsed(_hash);
-
-    WriteGuard l(x_blocks);
-    m_blocks[_hash].resize(d.size());
-    memcpy(m_blocks[_hash].data(), d.data(), d.size());
-
-    return m_blocks[_hash];
+    bytes ret(d.begin(), d.end());
+    m_blocks.insert(_hash, ret);
+    return ret;
 }
 
 bytes BlockChain::headerData(h256 const& _hash) const  {
     if (_hash == m_genesisHash) return m_genesisHeaderBytes;
 
-    {
-        ReadGuard l(x_blocks);
-        auto it = m_blocks.find(_hash);
-        if (it != m_blocks.end()) return BlockHeader::extractHeader(&it->second).data().toBytes();
-    }
+    if (auto cached = m_blocks.find(_hash)) return BlockHeader::extractHeader(&*cached).data().toBytes();
 
     string const d = m_blocksDB->lookup(toSlice(_hash));
     if (d.empty()) {
@@ -1180,13 +1432,10 @@ bytes BlockChain::headerData(h256 const& _hash) const  {
         return bytes();
     }
 
-    noteUsed(_hash);
-
-    WriteGuard l(x_blocks);
-    m_blocks[_hash].resize(d.size());
-    memcpy(m_blocks[_hash].data(), d.data(), d.size());
-
-    return BlockHeader::extractHeader(&m_blocks[_hash]).data().toBytes();
+    bytes block(d.begin(), d.end());
+    bytes ret = BlockHeader::extractHeader(&block).data().toBytes();
+    m_blocks.insert(_hash, std::move(block));
+    return ret;
 }
 
 Block BlockChain::genesisBlock(OverlayDB const& _db) const {
@@ -5,14 +5,18 @@
 #pragma once
 
 #include "Account.h"
+#include "BlockChainCaches.h"
 #include "BlockDetails.h"
 #include "BlockQueue.h"
+#include "CanonicalHashRing.h"
 #include "ChainParams.h"
 #include "DatabasePaths.h"
 #include "LastBlockHashesFace.h"
+#include "LogIndex.h"
 #include "State.h"
 #include "Transaction.h"
 #include "VerifiedBlock.h"
+#include <libdevcore/BufferedDB.h>
 #include <libdevcore/Exceptions.h>
 #include <libdevcore/Guards.h>
 #include <libdevcore/Log.h>
@@ -26,14 +30,6 @@
 #include <unordered_map>
 #include <unordered_set>
 
-namespace std
-{
-template <> struct hash<pair<dev::h256, unsigned>>
-{
-    size_t operator()(pair<dev::h256, unsigned> const& _x) const { return hash<dev::h256>()(_x.first) ^ hash<unsigned>()(_x.second); }
-};
-}
-
 namespace dev
 {
 
@@ -70,7 +66,8 @@ enum {
     ExtraTransactionAddress,
     ExtraLogBlooms,
     ExtraReceipts,
-    ExtraBlocksBlooms
+    ExtraBlocksBlooms,
+    ExtraLogIndex
 };
 
 using ProgressCallback = std::function<void(unsigned, unsigned)>;
@@ -148,23 +145,23 @@ public:
     bytes headerData() const { return headerData(currentHash()); }
 
     /// Get the familial details concerning a block (or the most recent mined if none given). Thread-safe.
-    BlockDetails details(h256 const& _hash) const { return queryExtras<BlockDetails, ExtraDetails>(_hash, m_details, x_details, NullBlockDetails); }
+    BlockDetails details(h256 const& _hash) const { return queryExtras<BlockDetails, ExtraDetails>(_hash, m_details, NullBlockDetails); }
     BlockDetails details() const { return details(currentHash()); }
 
     /// Get the transactions' log blooms of a block (or the most recent mined if none given). Thread-safe.
-    BlockLogBlooms logBlooms(h256 const& _hash) const { return queryExtras<BlockLogBlooms, ExtraLogBlooms>(_hash, m_logBlooms, x_logBlooms, NullBlockLogBlooms); }
+    BlockLogBlooms logBlooms(h256 const& _hash) const { return queryExtras<BlockLogBlooms, ExtraLogBlooms>(_hash, m_logBlooms, NullBlockLogBlooms); }
     BlockLogBlooms logBlooms() const { return logBlooms(currentHash()); }
 
     /// Get the transactions' receipts of a block (or the most recent mined if none given). Thread-safe.
     /// receipts are given in the same order are in the same order as the transactions
-    BlockReceipts receipts(h256 const& _hash) const { return queryExtras<BlockReceipts, ExtraReceipts>(_hash, m_receipts, x_receipts, NullBlockReceipts); }
+    BlockReceipts receipts(h256 const& _hash) const { return queryExtras<BlockReceipts, ExtraReceipts>(_hash, m_receipts, NullBlockReceipts); }
     BlockReceipts receipts() const { return receipts(currentHash()); }
 
     /// Get the transaction by block hash and index;
     TransactionReceipt transactionReceipt(h256 const& _blockHash, unsigned _i) const { return receipts(_blockHash).receipts[_i]; }
 
     /// Get the transaction receipt by transaction hash. Thread-safe.
-    TransactionReceipt transactionReceipt(h256 const& _transactionHash) const { TransactionAddress ta = queryExtras<TransactionAddress, ExtraTransactionAddress>(_transactionHash, m_transactionAddresses, x_transactionAddresses, NullTransactionAddress); if (!ta) return bytesConstRef(); return transactionReceipt(ta.blockHash, ta.index); }
+    TransactionReceipt transactionReceipt(h256 const& _transactionHash) const { TransactionAddress ta = queryExtras<TransactionAddress, ExtraTransactionAddress>(_transactionHash, m_transactionAddresses, NullTransactionAddress); if (!ta) return bytesConstRef(); return transactionReceipt(ta.blockHash, ta.index); }
 
     /// Get a list of transaction hashes for a given block. Thread-safe.
     TransactionHashes transactionHashes(h256 const& _hash) const { auto b = block(_hash); RLP rlp(b); h256s ret; for (auto t: rlp[1]) ret.push_back(sha3(t.data())); return ret; }
@@ -174,8 +171,13 @@ public:
     UncleHashes uncleHashes(h256 const& _hash) const { auto b = block(_hash); RLP rlp(b); h256s ret; for (auto t: rlp[2]) ret.push_back(sha3(t.data())); return ret; }
     UncleHashes uncleHashes() const { return uncleHashes(currentHash()); }
     
-    /// Get the hash for a given block's number.
-    h256 numberHash(unsigned _i) const { if (!_i) return genesisHash(); return queryExtras<BlockHash, uint64_t, ExtraBlockHash>(_i, m_blockHashes, x_blockHashes, NullBlockHash).value; }
+    /// Get the hash for a given block's number. Thread-safe.
+    h256 numberHash(unsigned _i) const;
+
+    /// @returns the hashes of the canonical block @a _hash and of its ancestors, from the newest,
+    /// up to @a _count of them, or none if the block is not canonical. Thread-safe: the hashes are
+    /// those of one version of the canonical chain, even when it changes meanwhile.
+    h256s canonicalAncestors(h256 const& _hash, unsigned _count) const;
 
     LastBlockHashesFace const& lastBlockHashes() const { return *m_lastBlockHashes;  }
 
@@ -196,17 +198,17 @@ public:
      * i * (x ^ n) + o * x ^ (n - 1)
      */
     BlocksBlooms blocksBlooms(unsigned _level, unsigned _index) const { return blocksBlooms(chunkId(_level, _index)); }
-    BlocksBlooms blocksBlooms(h256 const& _chunkId) const { return queryExtras<BlocksBlooms, ExtraBlocksBlooms>(_chunkId, m_blocksBlooms, x_blocksBlooms, NullBlocksBlooms); }
+    BlocksBlooms blocksBlooms(h256 const& _chunkId) const { return queryExtras<BlocksBlooms, ExtraBlocksBlooms>(_chunkId, m_blocksBlooms, NullBlocksBlooms); }
     LogBloom blockBloom(unsigned _number) const { return blocksBlooms(chunkId(0, _number / c_bloomIndexSize)).blooms[_number % c_bloomIndexSize]; }
     std::vector<unsigned> withBlockBloom(LogBloom const& _b, unsigned _earliest, unsigned _latest) const;
     std::vector<unsigned> withBlockBloom(LogBloom const& _b, unsigned _earliest, unsigned _latest, unsigned _topLevel, unsigned _index) const;
 
     /// Returns true if transaction is known. Thread-safe
-    bool isKnownTransaction(h256 const& _transactionHash) const { TransactionAddress ta = queryExtras<TransactionAddress, ExtraTransactionAddress>(_transactionHash, m_transactionAddresses, x_transactionAddresses, NullTransactionAddress); return !!ta; }
+    bool isKnownTransaction(h256 const& _transactionHash) const { TransactionAddress ta = queryExtras<TransactionAddress, ExtraTransactionAddress>(_transactionHash, m_transactionAddresses, NullTransactionAddress); return !!ta; }
 
     /// Get a transaction from its hash. Thread-safe.
-    bytes transaction(h256 const& _transactionHash) const { TransactionAddress ta = queryExtras<TransactionAddress, ExtraTransactionAddress>(_transactionHash, m_transactionAddresses, x_transactionAddresses, NullTransactionAddress); if (!ta) return bytes(); return transaction(ta.blockHash, ta.index); }
-    std::pair<h256, unsigned> transactionLocation(h256 const& _transactionHash) const { TransactionAddress ta = queryExtras<TransactionAddress, ExtraTransactionAddress>(_transactionHash, m_transactionAddresses, x_transactionAddresses, NullTransactionAddress); if (!ta) return std::pair<h256, unsigned>(h256(), 0); return std::make_pair(ta.blockHash, ta.index); }
+    bytes transaction(h256 const& _transactionHash) const { TransactionAddress ta = queryExtras<TransactionAddress, ExtraTransactionAddress>(_transactionHash, m_transactionAddresses, NullTransactionAddress); if (!ta) return bytes(); return transaction(ta.blockHash, ta.index); }
+    std::pair<h256, unsigned> transactionLocation(h256 const& _transactionHash) const { TransactionAddress ta = queryExtras<TransactionAddress, ExtraTransactionAddress>(_transactionHash, m_transactionAddresses, NullTransactionAddress); if (!ta) return std::pair<h256, unsigned>(h256(), 0); return std::make_pair(ta.blockHash, ta.index); }
 
     /// Get a block's transaction (RLP format) for the given block hash (or the most recent mined if none given) & index. Thread-safe.
     bytes transaction(h256 const& _blockHash, unsigned _i) const { bytes b = block(_blockHash); return RLP(b)[1][_i].data().toBytes(); }
@@ -236,12 +238,28 @@ public:
     void rebuild(boost::filesystem::path const& _path,
         ProgressCallback const& _progress = std::function<void(unsigned, unsigned)>());
 
+    /// Recompute the extras of the canonical chain (details, block hashes, transaction addresses,
+    /// blooms and the log index) from the stored blocks and receipts, without executing anything.
+    /// Blocks are decoded in parallel and written in order of their numbers.
+    /// Will call _progress with the progress in this operation first param done, second total.
+    void reindexExtras(ProgressCallback const& _progress = std::function<void(unsigned, unsigned)>());
+
     /// Alter the head of the chain to some prior block along it.
     void rewind(unsigned _newHead);
 
     /// Rescue the database.
     void rescue(OverlayDB const& _db);
 
+    /// Keeps the writes to the blocks and extras DBs in memory until flushWrites(), so that the
+    /// blocks imported meanwhile are synced to the disk at once rather than one by one. Must be
+    /// called, like unbufferWrites(), by the only thread importing blocks.
+    void bufferWrites();
+    /// Writes the writes kept to the disk, the blocks before the extras, so that the best block
+    /// is never on the disk without the blocks up to it.
+    void flushWrites();
+    /// Flushes the writes kept and writes to the disk directly again.
+    void unbufferWrites();
+
     /** @returns a tuple of:
      * - an vector of hashes of all blocks between @a _from and @a _to, all blocks are ordered first by a number of
      * blocks that are parent-to-child, then two sibling blocks, then a number of blocks that are child-to-parent;
@@ -282,8 +300,11 @@ public:
     /// @returns statistics about memory usage.
     Statistics usage(bool _freshen = false) const { if (_freshen) updateStats(); return m_lastStats; }
 
-    /// Deallocate unused data.
-    void garbageCollect(bool _force = false);
+    /// @returns the counters of the caches in front of the databases.
+    BlockChainCacheStats cacheStats() const;
+
+    /// @returns the index of the logs of the canonical chain, or null if not kept.
+    LogIndex const* logIndex() const { return m_logIndex.get(); }
 
     /// Change the function that is called with a bad block.
     void setOnBad(std::function<void(Exception&)> _t) { m_onBad = _t; }
@@ -328,32 +349,36 @@ private:
     void checkBlockTimestamp(BlockHeader const& _header) const;
 
     template <class T, class K, unsigned N>
-    T queryExtras(K const& _h, std::unordered_map<K, T>& _m, boost::shared_mutex& _x, T const& _n,
+    T queryExtras(K const& _h, ShardedLruCache<K, T>& _m, T const& _n,
         db::DatabaseFace* _extrasDB = nullptr) const
     {
-        {
-            ReadGuard l(_x);
-            auto it = _m.find(_h);
-            if (it != _m.end())
-                return it->second;
-        }
+        if (auto cached = _m.find(_h))
+            return *cached;
 
         std::string const s = (_extrasDB ? _extrasDB : m_extrasDB.get())->lookup(toSlice(_h, N));
         if (s.empty())
             return _n;
 
-        noteUsed(_h, N);
-
-        WriteGuard l(_x);
-        auto ret = _m.insert(std::make_pair(_h, T(RLP(s))));
-        return ret.first->second;
+        // A writer may have changed the value since the lookup, so keep the cached one.
+        return _m.emplace(_h, T(RLP(s)));
     }
 
     template <class T, unsigned N>
-    T queryExtras(h256 const& _h, std::unordered_map<h256, T>& _m, boost::shared_mutex& _x,
-        T const& _n, db::DatabaseFace* _extrasDB = nullptr) const
+    T queryExtras(h256 const& _h, ShardedLruCache<h256, T>& _m, T const& _n,
+        db::DatabaseFace* _extrasDB = nullptr) const
     {
-        return queryExtras<T, h256, N>(_h, _m, _x, _n, _extrasDB);
+        return queryExtras<T, h256, N>(_h, _m, _n, _extrasDB);
+    }
+
+    /// @returns a loader of the value of the key for ShardedLruCache::modify(), which reads it
+    /// from the extras DB and falls back to an empty value.
+    template <class T, unsigned N, class K>
+    std::function<T()> extrasLoader(K const& _h) const
+    {
+        return [this, _h]() {
+            std::string const s = m_extrasDB->lookup(toSlice(_h, N));
+            return s.empty() ? T() : T(RLP(s));
+        };
     }
 
     void checkConsistency();
@@ -363,29 +388,30 @@ private:
     void clearCachesDuringChainReversion(unsigned _firstInvalid);
     void clearBlockBlooms(unsigned _begin, unsigned _end);
 
-    /// The caches of the disk DB and their locks.
-    mutable SharedMutex x_blocks;
-    mutable BlocksHash m_blocks;
-    mutable SharedMutex x_details;
-    mutable BlockDetailsHash m_details;
-    mutable SharedMutex x_logBlooms;
-    mutable BlockLogBloomsHash m_logBlooms;
-    mutable SharedMutex x_receipts;
-    mutable BlockReceiptsHash m_receipts;
-    mutable SharedMutex x_transactionAddresses;
-    mutable TransactionAddressHash m_transactionAddresses;
-    mutable SharedMutex x_blockHashes;
-    mutable BlockHashHash m_blockHashes;
-    mutable SharedMutex x_blocksBlooms;
-    mutable BlocksBloomsHash m_blocksBlooms;
-
-    using CacheID = std::pair<h256, unsigned>;
-    mutable Mutex x_cacheUsage;
-    mutable std::deque<std::unordered_set<CacheID>> m_cacheUsage;
-    mutable std::unordered_set<CacheID> m_inUse;
-    void noteUsed(h256 const& _h, unsigned _extra = (unsigned)-1) const;
-    void noteUsed(uint64_t const& _h, unsigned _extra = (unsigned)-1) const { (void)_h; (void)_extra; } // don't note non-hash types
-    std::chrono::system_clock::time_point m_lastCollection;
+    /// The caches of the disk DB. Each evicts its least recently used entries once over budget.
+    mutable ShardedLruCache<h256, bytes> m_blocks{
+        blockChainCacheBudgets().blocks, [](bytes const& _b) { return _b.size() + 64; }};
+    mutable ShardedLruCache<h256, BlockDetails> m_details{
+        blockChainCacheBudgets().details, extrasSize<BlockDetails>};
+    mutable ShardedLruCache<h256, BlockLogBlooms> m_logBlooms{
+        blockChainCacheBudgets().logBlooms, extrasSize<BlockLogBlooms>};
+    mutable ShardedLruCache<h256, BlockReceipts> m_receipts{
+        blockChainCacheBudgets().receipts, extrasSize<BlockReceipts>};
+    mutable ShardedLruCache<h256, TransactionAddress> m_transactionAddresses{
+        blockChainCacheBudgets().transactionAddresses, extrasSize<TransactionAddress>};
+    mutable ShardedLruCache<uint64_t, BlockHash> m_blockHashes{
+        blockChainCacheBudgets().blockHashes, extrasSize<BlockHash>};
+    mutable ShardedLruCache<h256, BlocksBlooms> m_blocksBlooms{
+        blockChainCacheBudgets().blocksBlooms, extrasSize<BlocksBlooms>};
+    /// The hashes of the recent canonical blocks. Older ones are in m_blockHashes.
+    mutable CanonicalHashRing m_canonicalHashes;
+
+    /// The size of a cached extra, as last encoded or decoded, plus the overhead of its entry.
+    template <class T>
+    static size_t extrasSize(T const& _extras)
+    {
+        return _extras.size + 64;
+    }
 
     void noteCanonChanged() const { m_lastBlockHashes->clear(); }
     std::unique_ptr<LastBlockHashesFace> m_lastBlockHashes;
@@ -394,8 +420,11 @@ private:
     mutable Statistics m_lastStats;
 
     /// The disk DBs. Thread-safe, so no need for locks.
-    std::unique_ptr<db::DatabaseFace> m_blocksDB;
-    std::unique_ptr<db::DatabaseFace> m_extrasDB;
+    std::unique_ptr<db::BufferedDB> m_blocksDB;
+    std::unique_ptr<db::BufferedDB> m_extrasDB;
+
+    /// Index of the logs kept in the extras DB, if enabled.
+    std::unique_ptr<LogIndex> m_logIndex;
 
     /// Hash of the last (valid) block on the longest chain.
     mutable boost::shared_mutex x_lastBlockHash; // should protect both m_lastBlockHash and m_lastBlockNumber
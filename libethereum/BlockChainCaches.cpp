@@ -0,0 +1,163 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#include "BlockChainCaches.h"
+
+#include <boost/program_options.hpp>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+namespace po = boost::program_options;
+
+namespace
+{
+BlockChainCacheBudgets g_budgets;
+
+struct CacheKindTableEntry
+{
+    char const* name;
+    size_t BlockChainCacheBudgets::*budget;
+};
+
+/// The names of the caches, as used by the --chain-cache option.
+CacheKindTableEntry const cacheKindsTable[] = {
+    {"blocks", &BlockChainCacheBudgets::blocks},
+    {"details", &BlockChainCacheBudgets::details},
+    {"logblooms", &BlockChainCacheBudgets::logBlooms},
+    {"receipts", &BlockChainCacheBudgets::receipts},
+    {"txaddresses", &BlockChainCacheBudgets::transactionAddresses},
+    {"blockhashes", &BlockChainCacheBudgets::blockHashes},
+    {"blocksblooms", &BlockChainCacheBudgets::blocksBlooms},
+    {"logindex", &BlockChainCacheBudgets::logIndex},
+};
+
+/// The name of the program option --chain-cache. The boost will trim the tailing space and we
+/// can reuse this variable in exception message.
+char const c_chainCachePrefix[] = "chain-cache ";
+
+/// Parses the values of `--chain-cache <kind>=<MiB>` options into the budgets.
+void parseChainCacheOptions(vector<string> const& _opts)
+{
+    BlockChainCacheBudgets budgets = g_budgets;
+    for (auto const& s : _opts)
+    {
+        auto const separatorPos = s.find('=');
+        if (separatorPos == s.npos)
+            throw po::invalid_syntax{po::invalid_syntax::missing_parameter, c_chainCachePrefix + s};
+        auto const name = s.substr(0, separatorPos);
+        auto const value = s.substr(separatorPos + 1);
+
+        size_t mebibytes = 0;
+        try
+        {
+            size_t parsed = 0;
+            mebibytes = stoul(value, &parsed);
+            if (parsed != value.size())
+                throw invalid_argument{value};
+            // The budget in bytes must fit in size_t.
+            if (mebibytes > (numeric_limits<size_t>::max() >> 20))
+                throw out_of_range{value};
+        }
+        catch (logic_error const&)
+        {
+            BOOST_THROW_EXCEPTION(po::validation_error(
+                po::validation_error::invalid_option_value, "chain-cache", s, 1));
+        }
+
+        bool found = false;
+        for (auto const& entry : cacheKindsTable)
+            if (name == entry.name)
+            {
+                budgets.*entry.budget = mebibytes * 1024 * 1024;
+                found = true;
+            }
+        if (!found)
+            BOOST_THROW_EXCEPTION(po::validation_error(
+                po::validation_error::invalid_option_value, "chain-cache", s, 1));
+    }
+    g_budgets = budgets;
+}
+}  // namespace
+
+namespace dev
+{
+namespace eth
+{
+LruCacheStats BlockChainCacheStats::total() const
+{
+    LruCacheStats ret = blocks;
+    ret += details;
+    ret += logBlooms;
+    ret += receipts;
+    ret += transactionAddresses;
+    ret += blockHashes;
+    ret += blocksBlooms;
+    ret += logIndex;
+    return ret;
+}
+
+std::ostream& operator<<(std::ostream& _out, LruCacheStats const& _s)
+{
+    return _out << _s.entries << " entries, " << _s.bytes << " bytes, " << _s.hits << " hits, "
+                << _s.misses << " misses, " << _s.evictions << " evictions";
+}
+
+std::ostream& operator<<(std::ostream& _out, BlockChainCacheStats const& _s)
+{
+    return _out << "blocks: " << _s.blocks << "; details: " << _s.details
+                << "; log blooms: " << _s.logBlooms << "; receipts: " << _s.receipts
+                << "; transaction addresses: " << _s.transactionAddresses
+                << "; block hashes: " << _s.blockHashes << "; blocks blooms: " << _s.blocksBlooms
+                << "; log index: " << _s.logIndex;
+}
+
+BlockChainCacheBudgets const& blockChainCacheBudgets()
+{
+    return g_budgets;
+}
+
+void setBlockChainCacheBudgets(BlockChainCacheBudgets const& _budgets)
+{
+    g_budgets = _budgets;
+}
+
+po::options_description blockChainCacheProgramOptions(unsigned _lineLength)
+{
+    // It must be a static object because boost expects const char*.
+    static string const description = [] {
+        string names;
+        BlockChainCacheBudgets const defaults;
+        for (auto const& entry : cacheKindsTable)
+        {
+            if (!names.empty())
+                names += ", ";
+            names += string(entry.name) + " (" + to_string(defaults.*entry.budget / 1024 / 1024) +
+                     ")";
+        }
+
+        return "Set the memory budget, in MiB, of a blockchain cache. The caches and their "
+               "default budgets are: " +
+               names + ".\n";
+    }();
+
+    po::options_description opts("BLOCKCHAIN CACHE OPTIONS", _lineLength);
+    auto add = opts.add_options();
+
+    add(c_chainCachePrefix,
+        po::value<vector<string>>()
+            ->multitoken()
+            ->value_name("<kind>=<MiB>")
+            ->notifier(parseChainCacheOptions),
+        description.data());
+
+    return opts;
+}
+
+}  // namespace eth
+}  // namespace dev
@@ -0,0 +1,60 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#pragma once
+
+#include <libdevcore/ShardedLruCache.h>
+
+#include <boost/program_options/options_description.hpp>
+#include <cstddef>
+#include <iosfwd>
+
+namespace dev
+{
+namespace eth
+{
+/// Budgets, in bytes, of the caches a BlockChain keeps in front of its databases.
+struct BlockChainCacheBudgets
+{
+    size_t blocks = 32 * 1024 * 1024;
+    size_t details = 8 * 1024 * 1024;
+    size_t logBlooms = 8 * 1024 * 1024;
+    size_t receipts = 16 * 1024 * 1024;
+    size_t transactionAddresses = 8 * 1024 * 1024;
+    size_t blockHashes = 4 * 1024 * 1024;
+    size_t blocksBlooms = 8 * 1024 * 1024;
+    size_t logIndex = 16 * 1024 * 1024;  ///< Only used when the log index is enabled.
+};
+
+/// Counters of the caches of a BlockChain.
+struct BlockChainCacheStats
+{
+    LruCacheStats blocks;
+    LruCacheStats details;
+    LruCacheStats logBlooms;
+    LruCacheStats receipts;
+    LruCacheStats transactionAddresses;
+    LruCacheStats blockHashes;
+    LruCacheStats blocksBlooms;
+    LruCacheStats logIndex;
+
+    LruCacheStats total() const;
+};
+
+std::ostream& operator<<(std::ostream& _out, LruCacheStats const& _s);
+std::ostream& operator<<(std::ostream& _out, BlockChainCacheStats const& _s);
+
+/// @returns the budgets the caches of new BlockChain objects get.
+BlockChainCacheBudgets const& blockChainCacheBudgets();
+void setBlockChainCacheBudgets(BlockChainCacheBudgets const& _budgets);
+
+/// Provide a set of program options related to the BlockChain caches
+///
+/// @param _lineLength  The line length for description text wrapping, the same as in
+///                     boost::program_options::options_description::options_description().
+boost::program_options::options_description blockChainCacheProgramOptions(
+    unsigned _lineLength = boost::program_options::options_description::m_default_line_length);
+
+}  // namespace eth
+}  // namespace dev
@@ -6,10 +6,80 @@
 #include "BlockDetails.h"
 
 #include <libdevcore/Common.h>
+#include <libethcore/Exceptions.h>
+
+#include <snappy.h>
 using namespace std;
 using namespace dev;
 using namespace dev::eth;
 
+namespace
+{
+/// The first byte of the compact encoding of receipts, followed by the snappy compressed RLP of
+/// [addresses, topics, receipts] with the receipts as [status or state root, gas used, logs]
+/// and the logs as [address index, topic indices, data].
+constexpr byte c_compactReceiptsVersion = 1;
+
+/// Numbers the distinct values in the order they are first seen.
+template <class T>
+class Dictionary
+{
+public:
+    unsigned index(T const& _value)
+    {
+        auto const it = m_indices.emplace(_value, static_cast<unsigned>(m_values.size()));
+        if (it.second)
+            m_values.push_back(_value);
+        return it.first->second;
+    }
+    std::vector<T> const& values() const { return m_values; }
+
+private:
+    std::unordered_map<T, unsigned> m_indices;
+    std::vector<T> m_values;
+};
+
+TransactionReceipts decodeCompactReceipts(bytesConstRef _data, unsigned& o_size)
+{
+    if (_data.empty() || _data[0] != c_compactReceiptsVersion)
+        BOOST_THROW_EXCEPTION(InvalidTransactionReceiptFormat());
+
+    string uncompressed;
+    if (!snappy::Uncompress(reinterpret_cast<char const*>(_data.data()) + 1, _data.size() - 1, &uncompressed))
+        BOOST_THROW_EXCEPTION(InvalidTransactionReceiptFormat());
+
+    RLP const r(uncompressed);
+    if (!r.isList() || r.itemCount() != 3)
+        BOOST_THROW_EXCEPTION(InvalidTransactionReceiptFormat());
+    auto const addresses = r[0].toVector<Address>();
+    auto const topics = r[1].toVector<h256>();
+
+    TransactionReceipts ret;
+    ret.reserve(r[2].itemCount());
+    for (auto const& receipt: r[2])
+    {
+        LogEntries logs;
+        logs.reserve(receipt[2].itemCount());
+        for (auto const& log: receipt[2])
+        {
+            h256s logTopics;
+            for (auto const& topic: log[1])
+                logTopics.push_back(topics.at(topic.toInt<unsigned>()));
+            logs.emplace_back(addresses.at(log[0].toInt<unsigned>()), move(logTopics), log[2].toBytes());
+        }
+
+        u256 const gasUsed = receipt[1].toInt<u256>();
+        if (receipt[0].size() == 32)
+            ret.emplace_back(receipt[0].toHash<h256>(), gasUsed, logs);
+        else
+            ret.emplace_back((uint8_t)receipt[0], gasUsed, logs);
+    }
+    // The blooms derived are held in memory though not stored.
+    o_size = static_cast<unsigned>(uncompressed.size() + ret.size() * sizeof(LogBloom));
+    return ret;
+}
+}  // namespace
+
 BlockDetails::BlockDetails(RLP const& _r)
 {
     number = _r[0].toInt<unsigned>();
@@ -20,6 +90,56 @@ BlockDetails::BlockDetails(RLP const& _r)
     blockSizeBytes = _r[4].toInt<size_t>();
 }
 
+BlockReceipts::BlockReceipts(RLP const& _r)
+{
+    if (_r.isList())
+    {
+        for (auto const& i: _r)
+            receipts.emplace_back(i.data());
+        size = _r.data().size();
+    }
+    else
+        receipts = decodeCompactReceipts(_r.toBytesConstRef(), size);
+}
+
+bytes BlockReceipts::compactRlp() const
+{
+    Dictionary<Address> addresses;
+    Dictionary<h256> topics;
+    RLPStream receiptsRlp(receipts.size());
+    for (TransactionReceipt const& receipt: receipts)
+    {
+        receiptsRlp.appendList(3);
+        if (receipt.hasStatusCode())
+            receiptsRlp << receipt.statusCode();
+        else
+            receiptsRlp << receipt.stateRoot();
+        receiptsRlp << receipt.cumulativeGasUsed();
+        receiptsRlp.appendList(receipt.log().size());
+        for (LogEntry const& log: receipt.log())
+        {
+            receiptsRlp.appendList(3) << addresses.index(log.address);
+            receiptsRlp.appendList(log.topics.size());
+            for (h256 const& topic: log.topics)
+                receiptsRlp << topics.index(topic);
+            receiptsRlp << log.data;
+        }
+    }
+
+    RLPStream s(3);
+    s << addresses.values() << topics.values();
+    s.appendRaw(receiptsRlp.out());
+
+    string compressed;
+    snappy::Compress(reinterpret_cast<char const*>(s.out().data()), s.out().size(), &compressed);
+    bytes encoded;
+    encoded.reserve(1 + compressed.size());
+    encoded.push_back(c_compactReceiptsVersion);
+    encoded.insert(encoded.end(), compressed.begin(), compressed.end());
+    size = static_cast<unsigned>(s.out().size() + receipts.size() * sizeof(LogBloom));
+    return dev::rlp(encoded);
+}
+
 bytes BlockDetails::rlp() const
 {
     auto const detailsRlp =
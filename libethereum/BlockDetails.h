@@ -45,8 +45,8 @@ struct BlockDetails
     h256s childHashes;
 
     // Size of the BlockDetails RLP (in bytes). Used for computing blockchain memory usage
-    // statistics. Field name must be 'size' as BlockChain::getHashSize depends on this
-    mutable unsigned size;
+    // statistics. Field name must be 'size' as the BlockChain caches depend on this
+    mutable unsigned size = 0;
 
     // Size of the block RLP data in bytes
     size_t blockSizeBytes;
@@ -59,7 +59,7 @@ struct BlockLogBlooms
     bytes rlp() const { bytes r = dev::rlp(blooms); size = r.size(); return r; }
 
     LogBlooms blooms;
-    mutable unsigned size;
+    mutable unsigned size = 0;
 };
 
 struct BlocksBlooms
@@ -69,14 +69,20 @@ struct BlocksBlooms
     bytes rlp() const { bytes r = dev::rlp(blooms); size = r.size(); return r; }
 
     std::array<LogBloom, c_bloomIndexSize> blooms;
-    mutable unsigned size;
+    mutable unsigned size = 0;
 };
 
+/// Receipts of a block, read from either their consensus RLP list or the compact encoding of
+/// compactRlp(), which is what the extras database keeps.
 struct BlockReceipts
 {
     BlockReceipts() {}
-    BlockReceipts(RLP const& _r) { for (auto const& i: _r) receipts.emplace_back(i.data()); size = _r.data().size(); }
+    BlockReceipts(RLP const& _r);
     bytes rlp() const { RLPStream s(receipts.size()); for (TransactionReceipt const& i: receipts) i.streamRLP(s); size = s.out().size(); return s.out(); }
+    /// @returns the receipts with the addresses and topics of their logs numbered in a dictionary
+    /// of the block and without their blooms, which are derived from the logs when read, snappy
+    /// compressed in an RLP string.
+    bytes compactRlp() const;
 
     TransactionReceipts receipts;
     mutable unsigned size = 0;
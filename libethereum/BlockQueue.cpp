@@ -11,6 +11,7 @@
 #include "BlockChain.h"
 #include "VerifiedBlock.h"
 #include "State.h"
+#include "Transaction.h"
 using namespace std;
 using namespace dev;
 using namespace dev::eth;
@@ -70,24 +71,42 @@ void BlockQueue::verifierBody()
     while (!m_deleting)
     {
         UnverifiedBlock work;
+        shared_ptr<SenderRecovery> recovery;
 
         {
             unique_lock<Mutex> l(m_verification);
-            m_moreToVerify.wait(l, [&](){ return !m_unverified.isEmpty() || m_deleting; });
+            m_moreToVerify.wait(l, [&]() {
+                return !m_unverified.isEmpty() || !m_senderRecoveries.empty() || m_deleting;
+            });
             if (m_deleting)
                 return;
-            work = m_unverified.dequeue();
 
-            BlockHeader bi;
-            bi.setSha3Uncles(work.hash);
-            bi.setParentHash(work.parentHash);
-            m_verifying.enqueue(move(bi));
+            // Helping another verifier with the senders of its block comes first, that block is
+            // further ahead.
+            if (!m_senderRecoveries.empty())
+                recovery = m_senderRecoveries.front();
+            else
+            {
+                work = m_unverified.dequeue();
+
+                BlockHeader bi;
+                bi.setSha3Uncles(work.hash);
+                bi.setParentHash(work.parentHash);
+                m_verifying.enqueue(move(bi));
+            }
+        }
+
+        if (recovery)
+        {
+            helpRecoverSenders(*recovery);
+            continue;
         }
 
         VerifiedBlock res;
         swap(work.blockData, res.blockData);
         try
         {
+            recoverSenders(&res.blockData);
             res.verified = m_bc->verifyBlock(&res.blockData, m_onBad, ImportRequirements::OutOfOrderChecks);
         }
         catch (std::exception const& _ex)
@@ -134,6 +153,61 @@ void BlockQueue::verifierBody()
     }
 }
 
+void BlockQueue::recoverSenders(bytesConstRef _block)
+{
+    auto recovery = make_shared<SenderRecovery>();
+    try
+    {
+        for (auto const& tr : RLP(_block)[1])
+            recovery->transactions.push_back(tr.data());
+    }
+    catch (Exception const&)
+    {
+        // Malformed block, left to verifyBlock() to report.
+        return;
+    }
+    if (m_verifiers.size() < 2 || recovery->transactions.size() < 2)
+        return;
+
+    DEV_GUARDED(m_verification)
+        m_senderRecoveries.push_back(recovery);
+    m_moreToVerify.notify_all();
+
+    helpRecoverSenders(*recovery);
+
+    unique_lock<Mutex> l(m_verification);
+    m_senderRecoveryDone.wait(
+        l, [&]() { return recovery->done == recovery->transactions.size(); });
+}
+
+void BlockQueue::helpRecoverSenders(SenderRecovery& _recovery)
+{
+    size_t const count = _recovery.transactions.size();
+    for (size_t i = _recovery.next++; i < count; i = _recovery.next++)
+    {
+        try
+        {
+            // The recovered sender lands in SenderCache, where verifyBlock() finds it.
+            Transaction(_recovery.transactions[i], CheckTransaction::Cheap).safeSender();
+        }
+        catch (Exception const&)
+        {
+            // Invalid transactions are reported by verifyBlock().
+        }
+
+        if (++_recovery.done == count)
+            DEV_GUARDED(m_verification)
+                m_senderRecoveryDone.notify_all();
+    }
+
+    // Every transaction is claimed, stop handing the recovery out.
+    Guard l(m_verification);
+    auto const it = find_if(m_senderRecoveries.begin(), m_senderRecoveries.end(),
+        [&](shared_ptr<SenderRecovery> const& _r) { return _r.get() == &_recovery; });
+    if (it != m_senderRecoveries.end())
+        m_senderRecoveries.erase(it);
+}
+
 void BlockQueue::drainVerified_WITH_BOTH_LOCKS()
 {
     while (!m_verifying.isEmpty() && !m_verifying.next().blockData.empty())
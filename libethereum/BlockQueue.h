@@ -272,7 +272,20 @@ private:
 
     bool invariants() const override;
 
+    /// Senders of the transactions of a block, recovered by all the verifier threads together.
+    struct SenderRecovery
+    {
+        std::vector<bytesConstRef> transactions;
+        std::atomic<size_t> next{0};  ///< The next transaction to claim.
+        std::atomic<size_t> done{0};  ///< The number of transactions recovered.
+    };
+
     void verifierBody();
+    /// Recovers the senders of the block's transactions into SenderCache before the block is
+    /// verified, sharing the work with the other verifier threads.
+    void recoverSenders(bytesConstRef _block);
+    /// Recovers senders of the given block until all its transactions are claimed.
+    void helpRecoverSenders(SenderRecovery& _recovery);
     void collectUnknownBad_WITH_BOTH_LOCKS(h256 const& _bad);
     void updateBad_WITH_LOCK(h256 const& _bad);
     void drainVerified_WITH_BOTH_LOCKS();
@@ -301,6 +314,9 @@ private:
     SizedBlockQueue<VerifiedBlock> m_verifying;                             ///< List of blocks being verified; as long as the block component (bytes) is empty, it's not finished.
     SizedBlockQueue<UnverifiedBlock> m_unverified;                          ///< List of <block hash, parent hash, block data> in correct order, ready for verification.
 
+    std::deque<std::shared_ptr<SenderRecovery>> m_senderRecoveries;     ///< Recoveries with transactions left to claim. Guarded by m_verification.
+    std::condition_variable m_senderRecoveryDone;                       ///< Signaled when a recovery finishes its last transaction.
+
     std::vector<std::thread> m_verifiers;                               ///< Threads who only verify.
     std::atomic<bool> m_deleting = {false};                             ///< Exit condition for verifiers.
 
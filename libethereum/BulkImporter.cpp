@@ -0,0 +1,220 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#include "BulkImporter.h"
+#include "BlockChain.h"
+#include "ChainArchive.h"
+
+#include <libdevcore/Log.h>
+#include <libdevcore/OrderedParallel.h>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <chrono>
+#include <thread>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+namespace bi = boost::interprocess;
+
+namespace
+{
+/// The number of consecutive blocks a thread checks at once.
+constexpr size_t c_segmentBlocks = 32;
+
+/// The number of segments split at once, which bounds the blocks held split.
+constexpr size_t c_splitSegments = 1024;
+
+/// Blocks of the file, checked by a worker.
+struct Segment
+{
+    vector<bytesConstRef> blocks;
+    vector<VerifiedBlockRef> verified;  ///< The blocks checked, in order, up to the first bad one.
+    vector<bool> known;                 ///< Whether each block was already in the chain.
+    exception_ptr error;                ///< Why the block after the verified ones is bad.
+};
+
+/// Checks the blocks of the segment up to the first bad one.
+void check(BlockChain const& _bc, Segment& io_segment)
+{
+    for (auto const& block : io_segment.blocks)
+    {
+        try
+        {
+            bool const known = _bc.isKnown(BlockHeader::headerHashFromBlock(block));
+            io_segment.verified.push_back(known ?
+                                              VerifiedBlockRef{block, {}, {}} :
+                                              _bc.verifyBlock(block, {}, ImportRequirements::OutOfOrderChecks));
+            io_segment.known.push_back(known);
+        }
+        catch (...)
+        {
+            io_segment.error = current_exception();
+            return;
+        }
+    }
+}
+}  // namespace
+
+constexpr unsigned BulkImporter::c_defaultBatchBlocks;
+
+BulkImporter::BulkImporter(
+    BlockChain& _bc, OverlayDB const& _stateDB, unsigned _threads, unsigned _batchBlocks)
+  : m_bc(_bc),
+    m_stateDB(_stateDB),
+    m_threads(_threads ? _threads : max(thread::hardware_concurrency(), 1u)),
+    m_batchBlocks(max(_batchBlocks, 1u))
+{}
+
+BulkImportProgress BulkImporter::import(
+    boost::filesystem::path const& _file, unsigned _progressInterval, Progress const& _progress)
+{
+    if (boost::filesystem::file_size(_file) == 0)
+        return {};
+
+    bi::file_mapping const file(_file.string().c_str(), bi::read_only);
+    bi::mapped_region region(file, bi::read_only);
+    region.advise(bi::mapped_region::advice_sequential);
+    bytesConstRef const data(static_cast<byte const*>(region.get_address()), region.get_size());
+    if (ChainArchive::isArchive(data))
+        return import(ChainArchive(data), _progressInterval, _progress);
+    return import(data, _progressInterval, _progress);
+}
+
+BulkImportProgress BulkImporter::import(
+    bytesConstRef _blocks, unsigned _progressInterval, Progress const& _progress)
+{
+    BulkImportProgress progress;
+    auto const start = chrono::steady_clock::now();
+    importBuffered([&] { importBlocks(_blocks, _progressInterval, _progress, start, progress); });
+    progress.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (_progress)
+        _progress(progress);
+    return progress;
+}
+
+BulkImportProgress BulkImporter::import(
+    ChainArchive const& _archive, unsigned _progressInterval, Progress const& _progress)
+{
+    BulkImportProgress progress;
+    auto const start = chrono::steady_clock::now();
+    importBuffered([&] {
+        _archive.forEachSegment(m_bc.number() + 1, _archive.lastNumber(), m_threads,
+            [&](bytesConstRef _blocks) {
+                importBlocks(_blocks, _progressInterval, _progress, start, progress);
+            });
+    });
+    progress.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (_progress)
+        _progress(progress);
+    return progress;
+}
+
+void BulkImporter::importBuffered(function<void()> const& _import)
+{
+    m_stateDB.bufferWrites();
+    m_bc.bufferWrites();
+    try
+    {
+        _import();
+    }
+    catch (...)
+    {
+        // The blocks imported before the error are kept.
+        flush();
+        m_bc.unbufferWrites();
+        throw;
+    }
+    flush();
+    m_bc.unbufferWrites();
+}
+
+void BulkImporter::flush()
+{
+    // Failing to write the state is fatal, the chain written after it would lack the state.
+    try
+    {
+        m_stateDB.flushWrites();
+    }
+    catch (boost::exception const& ex)
+    {
+        cwarn << "Error writing to state database: " << boost::diagnostic_information(ex);
+        cwarn << "Fail writing to state database. Bombing out.";
+        exit(-1);
+    }
+    m_bc.flushWrites();
+    m_unflushed = 0;
+}
+
+void BulkImporter::importBlocks(bytesConstRef _blocks, unsigned _progressInterval,
+    Progress const& _progress, chrono::steady_clock::time_point _start,
+    BulkImportProgress& io_progress)
+{
+    // The importing thread splits the blocks into segments, a run of them at a time, and the
+    // workers check the segments of the run a window ahead of the segment imported.
+    size_t offset = 0;
+    while (offset < _blocks.size())
+    {
+        vector<Segment> segments;
+        while (offset < _blocks.size() && segments.size() < c_splitSegments)
+        {
+            segments.emplace_back();
+            Segment& segment = segments.back();
+            while (offset < _blocks.size() && segment.blocks.size() < c_segmentBlocks)
+            {
+                size_t const size = RLP(_blocks.cropped(offset), RLP::LaissezFaire).actualSize();
+                if (!size || size > _blocks.size() - offset)
+                {
+                    // Reported once the blocks before are imported.
+                    segment.error = make_exception_ptr(
+                        BadRLP() << errinfo_comment("Truncated block at offset " + toString(offset)));
+                    offset = _blocks.size();
+                    break;
+                }
+                segment.blocks.push_back(_blocks.cropped(offset, size));
+                offset += size;
+            }
+        }
+
+        forEachInOrder<Segment>(segments.size(), m_threads, "bulkimport",
+            [&](size_t _i) {
+                Segment segment = move(segments[_i]);
+                check(m_bc, segment);
+                return segment;
+            },
+            [&](Segment& _segment) {
+                for (size_t i = 0; i < _segment.verified.size(); ++i)
+                {
+                    VerifiedBlockRef const& block = _segment.verified[i];
+                    if (_segment.known[i] || m_bc.isKnown(block.info.hash()))
+                    {
+                        ++io_progress.alreadyKnown;
+                        io_progress.lastNumber = BlockHeader(block.block).number();
+                    }
+                    else
+                    {
+                        m_bc.import(block, m_stateDB, false);
+                        ++io_progress.imported;
+                        io_progress.gasUsed += block.info.gasUsed();
+                        io_progress.lastNumber = block.info.number();
+                        if (++m_unflushed == m_batchBlocks)
+                            flush();
+                    }
+
+                    if (_progress && _progressInterval &&
+                        (io_progress.imported + io_progress.alreadyKnown) % _progressInterval == 0)
+                    {
+                        io_progress.seconds =
+                            chrono::duration<double>(chrono::steady_clock::now() - _start).count();
+                        _progress(io_progress);
+                    }
+                }
+                if (_segment.error)
+                    rethrow_exception(_segment.error);
+            });
+    }
+}
@@ -0,0 +1,93 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+/// @file
+/// Import of exported chains straight into the blockchain.
+#pragma once
+
+#include <libdevcore/Common.h>
+#include <libdevcore/OverlayDB.h>
+
+#include <boost/filesystem/path.hpp>
+#include <chrono>
+#include <functional>
+
+namespace dev
+{
+namespace eth
+{
+class BlockChain;
+class ChainArchive;
+
+/// The progress of a bulk import.
+struct BulkImportProgress
+{
+    unsigned imported = 0;      ///< The number of blocks imported.
+    unsigned alreadyKnown = 0;  ///< The number of blocks skipped as already in the chain.
+    u256 gasUsed;               ///< The gas used by the blocks imported.
+    double seconds = 0;         ///< The time since the import started.
+    unsigned lastNumber = 0;    ///< The number of the last block imported or skipped.
+};
+
+/**
+ * @brief Imports a file of consecutive RLP blocks, such as written by --export, into the chain.
+ *
+ * Unlike the import through the block queue, the blocks are taken from the file mapped in memory
+ * and imported in the order of the file, without the bookkeeping of the blocks coming from peers.
+ * Seals and transaction signatures are checked on worker threads ahead of the execution, so
+ * executing a block does not wait for the senders of its transactions to be recovered.
+ * The writes of the blocks are kept in memory and synced to the disk in one batch every few
+ * blocks, the state before the chain, so the chain on the disk always ends at the end of a batch
+ * with its state. An interrupted import can be resumed with the same file, the blocks already in
+ * the chain being skipped.
+ */
+class BulkImporter
+{
+public:
+    using Progress = std::function<void(BulkImportProgress const&)>;
+
+    /// The number of blocks imported between the syncs to the disk by default.
+    static constexpr unsigned c_defaultBatchBlocks = 256;
+
+    /// @param _threads  Number of threads checking blocks, the hardware concurrency if 0.
+    /// @param _batchBlocks  Number of blocks imported between the syncs to the disk.
+    BulkImporter(BlockChain& _bc, OverlayDB const& _stateDB, unsigned _threads = 0,
+        unsigned _batchBlocks = c_defaultBatchBlocks);
+
+    /// Imports the blocks of @a _file, either concatenated or a chain archive, calling @a _progress every @a _progressInterval blocks.
+    /// @throws the error of the first block which cannot be imported, after importing those before.
+    BulkImportProgress import(boost::filesystem::path const& _file, unsigned _progressInterval,
+        Progress const& _progress = Progress());
+
+    /// Imports the blocks concatenated in @a _blocks.
+    BulkImportProgress import(
+        bytesConstRef _blocks, unsigned _progressInterval, Progress const& _progress = Progress());
+
+    /// Imports the blocks of @a _archive after the head of the chain, the segments of the archive
+    /// being decoded ahead.
+    BulkImportProgress import(ChainArchive const& _archive, unsigned _progressInterval,
+        Progress const& _progress = Progress());
+
+private:
+    /// Runs @a _import with the writes of the chain and the state kept in memory, flushing them
+    /// at the end, even if it throws.
+    void importBuffered(std::function<void()> const& _import);
+    /// Syncs the writes kept to the disk, the state first.
+    void flush();
+
+    /// Imports the blocks concatenated in @a _blocks, checked ahead on m_threads threads.
+    void importBlocks(bytesConstRef _blocks, unsigned _progressInterval, Progress const& _progress,
+        std::chrono::steady_clock::time_point _start, BulkImportProgress& io_progress);
+
+    BlockChain& m_bc;
+    /// The copy of the state DB the blocks are imported with, which keeps its writes in memory.
+    OverlayDB m_stateDB;
+    unsigned m_threads;
+    unsigned m_batchBlocks;
+    /// The number of blocks imported since the last flush().
+    unsigned m_unflushed = 0;
+};
+
+}  // namespace eth
+}  // namespace dev
@@ -0,0 +1,93 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#include "CanonicalHashRing.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+constexpr unsigned CanonicalHashRing::c_defaultCapacity;
+
+CanonicalHashRing::CanonicalHashRing(unsigned _capacity) : m_hashes(_capacity)
+{
+    assert(_capacity > 0);
+}
+
+void CanonicalHashRing::reset(unsigned _head, h256 const& _headHash)
+{
+    WriteGuard l(x_ring);
+    fill_n(m_hashes.begin(), m_hashes.size(), h256());
+    m_head = _head;
+    slot(_head) = _headHash;
+    ++m_generation;
+}
+
+h256 CanonicalHashRing::find(unsigned _number, uint64_t& o_generation) const
+{
+    ReadGuard l(x_ring);
+    o_generation = m_generation;
+    return isKept(_number) ? m_hashes[_number % m_hashes.size()] : h256();
+}
+
+h256s CanonicalHashRing::preceding(
+    unsigned _number, h256 const& _hash, unsigned _count, uint64_t& o_generation) const
+{
+    ReadGuard l(x_ring);
+    o_generation = m_generation;
+    if (!_hash || !isKept(_number) || m_hashes[_number % m_hashes.size()] != _hash)
+        return {};
+
+    h256s ret(min<uint64_t>(_count, uint64_t(_number) + 1));
+    for (unsigned i = 0; i < ret.size() && isKept(_number - i); ++i)
+        ret[i] = m_hashes[(_number - i) % m_hashes.size()];
+    return ret;
+}
+
+void CanonicalHashRing::fill(unsigned _number, h256 const& _hash, uint64_t _generation)
+{
+    WriteGuard l(x_ring);
+    if (_generation == m_generation && isKept(_number))
+        slot(_number) = _hash;
+}
+
+void CanonicalHashRing::setHead(unsigned _first, h256s const& _hashes)
+{
+    if (_hashes.empty())
+        return;
+
+    unsigned const head = _first + static_cast<unsigned>(_hashes.size()) - 1;
+    WriteGuard l(x_ring);
+    // Replacing blocks, or leaving a gap the old slots of which are not overwritten, changes
+    // what a concurrent lookup in the database may have seen.
+    if (_first <= m_head || _first > m_head + 1)
+        ++m_generation;
+    // Slots in the gap would otherwise still hold the hashes of blocks one capacity older.
+    unsigned const capacity = static_cast<unsigned>(m_hashes.size());
+    for (unsigned n = max(m_head + 1, head >= capacity ? head - capacity + 1 : 0); n < _first; ++n)
+        slot(n) = h256();
+    size_t const skipped = _hashes.size() > m_hashes.size() ? _hashes.size() - m_hashes.size() : 0;
+    for (size_t i = skipped; i < _hashes.size(); ++i)
+        slot(_first + static_cast<unsigned>(i)) = _hashes[i];
+    m_head = head;
+}
+
+void CanonicalHashRing::rewind(unsigned _head)
+{
+    WriteGuard l(x_ring);
+    if (_head < m_head)
+    {
+        m_head = _head;
+        ++m_generation;
+    }
+}
+
+unsigned CanonicalHashRing::head() const
+{
+    ReadGuard l(x_ring);
+    return m_head;
+}
@@ -0,0 +1,71 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#pragma once
+
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/Guards.h>
+
+#include <vector>
+
+namespace dev
+{
+namespace eth
+{
+/**
+ * @brief The hashes of the most recent canonical blocks, by number.
+ *
+ * The hash of block n is kept in slot n modulo the capacity, for the blocks no older than the
+ * capacity below the head. The blocks made canonical by an import are written in, and the others
+ * are filled in as they are looked up in the database, so nothing is read when the chain is opened.
+ * @threadsafe
+ */
+class CanonicalHashRing
+{
+public:
+    /// 64k hashes, 2 MiB, covering a bit more than a week of blocks.
+    static constexpr unsigned c_defaultCapacity = 65536;
+
+    explicit CanonicalHashRing(unsigned _capacity = c_defaultCapacity);
+
+    /// Forgets all hashes but that of the head @a _head.
+    void reset(unsigned _head, h256 const& _headHash);
+
+    /// @returns the hash of the canonical block @a _number, or a null hash if it is not in the ring.
+    /// @param o_generation  Set to the version of the canonical chain looked up, to pass to fill().
+    h256 find(unsigned _number, uint64_t& o_generation) const;
+
+    /// @returns the hashes of block @a _number and of the blocks before it, from the newest, up to
+    /// @a _count of them, if block @a _number is in the ring with hash @a _hash, or none otherwise.
+    /// They are read at once, so all are of the same canonical chain. Those not in the ring are
+    /// null.
+    /// @param o_generation  Set to the version of the canonical chain read, to pass to fill().
+    h256s preceding(unsigned _number, h256 const& _hash, unsigned _count, uint64_t& o_generation) const;
+
+    /// Keeps the hash of block @a _number found elsewhere, unless the canonical chain changed
+    /// since @a _generation.
+    void fill(unsigned _number, h256 const& _hash, uint64_t _generation);
+
+    /// Makes the blocks @a _hashes canonical, numbered from @a _first, the last one being the new
+    /// head. The blocks above are forgotten.
+    void setHead(unsigned _first, h256s const& _hashes);
+
+    /// Forgets the blocks above @a _head, which becomes the head.
+    void rewind(unsigned _head);
+
+    unsigned head() const;
+
+private:
+    /// @returns true if block @a _number is in the range kept.
+    bool isKept(unsigned _number) const { return _number <= m_head && m_head - _number < m_hashes.size(); }
+    h256& slot(unsigned _number) { return m_hashes[_number % m_hashes.size()]; }
+
+    mutable SharedMutex x_ring;
+    std::vector<h256> m_hashes;
+    unsigned m_head = 0;
+    uint64_t m_generation = 0;  ///< Changed every time blocks stop being canonical.
+};
+
+}  // namespace eth
+}  // namespace dev
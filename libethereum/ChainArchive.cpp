@@ -0,0 +1,224 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#include "ChainArchive.h"
+#include "BlockChain.h"
+
+#include <libdevcore/OrderedParallel.h>
+#include <libdevcore/RLP.h>
+
+#include <boost/crc.hpp>
+#include <snappy.h>
+
+#include <algorithm>
+#include <ostream>
+#include <thread>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace
+{
+bytes const c_magic{'A', 'L', 'E', 'T', 'H', 'C', 'A', 1};
+constexpr size_t c_segmentHeaderSize = 20;
+constexpr size_t c_footerSize = 16;
+/// The largest segment decoded, to bound the memory of a corrupted archive.
+constexpr size_t c_maxSegmentSize = 1024 * 1024 * 1024;
+
+uint32_t crc32(bytesConstRef _data)
+{
+    boost::crc_32_type crc;
+    crc.process_bytes(_data.data(), _data.size());
+    return crc.checksum();
+}
+
+void putBigEndian(bytes& o_out, uint64_t _value, unsigned _size)
+{
+    for (unsigned i = _size; i-- > 0;)
+        o_out.push_back(static_cast<byte>(_value >> (i * 8)));
+}
+
+uint64_t getBigEndian(bytesConstRef _data, size_t _offset, unsigned _size)
+{
+    uint64_t ret = 0;
+    for (unsigned i = 0; i < _size; ++i)
+        ret = (ret << 8) | _data[_offset + i];
+    return ret;
+}
+
+unsigned toThreads(unsigned _threads)
+{
+    return _threads ? _threads : max(thread::hardware_concurrency(), 1u);
+}
+}  // namespace
+
+constexpr unsigned ChainArchive::c_segmentBlocks;
+
+ChainArchive::ChainArchive(bytesConstRef _data) : m_data(_data)
+{
+    if (!isArchive(_data) || _data.size() < 2 * c_magic.size() + c_footerSize ||
+        !_data.cropped(_data.size() - c_magic.size()).contentsEqual(c_magic))
+        BOOST_THROW_EXCEPTION(BadChainArchive() << errinfo_comment("No archive footer"));
+
+    size_t const footer = _data.size() - c_magic.size() - c_footerSize;
+    uint64_t const indexOffset = getBigEndian(_data, footer, 8);
+    uint64_t const indexSize = getBigEndian(_data, footer + 8, 4);
+    if (indexOffset < c_magic.size() || indexOffset > footer || footer - indexOffset != indexSize)
+        BOOST_THROW_EXCEPTION(BadChainArchive() << errinfo_comment("Bad index position"));
+    m_indexOffset = indexOffset;
+    bytesConstRef const index = _data.cropped(indexOffset, indexSize);
+    if (crc32(index) != getBigEndian(_data, footer + 12, 4))
+        BOOST_THROW_EXCEPTION(BadChainArchive() << errinfo_comment("Bad index checksum"));
+
+    try
+    {
+        for (auto const& segment : RLP(index, RLP::VeryStrict))
+        {
+            Segment s{segment[0].toInt<unsigned>(RLP::VeryStrict),
+                segment[1].toInt<unsigned>(RLP::VeryStrict),
+                segment[2].toInt<uint64_t>(RLP::VeryStrict)};
+            // Every segment has room for its header before the next one or the index.
+            if (!s.count || s.offset < c_magic.size() || s.offset + c_segmentHeaderSize > indexOffset ||
+                (!m_segments.empty() && (s.first != m_segments.back().first + m_segments.back().count ||
+                                            m_segments.back().offset + c_segmentHeaderSize > s.offset)))
+                BOOST_THROW_EXCEPTION(BadChainArchive() << errinfo_comment("Bad index entry"));
+            m_segments.push_back(s);
+        }
+    }
+    catch (RLPException const&)
+    {
+        BOOST_THROW_EXCEPTION(BadChainArchive() << errinfo_comment("Bad index"));
+    }
+    if (m_segments.empty())
+        BOOST_THROW_EXCEPTION(BadChainArchive() << errinfo_comment("Empty archive"));
+}
+
+bool ChainArchive::isArchive(bytesConstRef _data)
+{
+    return _data.size() >= c_magic.size() && _data.cropped(0, c_magic.size()).contentsEqual(c_magic);
+}
+
+bytes ChainArchive::segmentBlocks(size_t _segment) const
+{
+    Segment const& s = m_segments.at(_segment);
+    uint64_t const end =
+        _segment + 1 < m_segments.size() ? m_segments[_segment + 1].offset : m_indexOffset;
+    bytesConstRef const data = m_data.cropped(s.offset, end - s.offset);
+    size_t const rawSize = getBigEndian(data, 8, 4);
+    size_t const compressedSize = getBigEndian(data, 12, 4);
+    if (getBigEndian(data, 0, 4) != s.first || getBigEndian(data, 4, 4) != s.count ||
+        c_segmentHeaderSize + compressedSize != data.size())
+        BOOST_THROW_EXCEPTION(BadChainArchive() << errinfo_comment("Segment does not match the index"));
+    bytesConstRef const compressed = data.cropped(c_segmentHeaderSize);
+    if (crc32(compressed) != getBigEndian(data, 16, 4))
+        BOOST_THROW_EXCEPTION(BadChainArchive() << errinfo_comment("Bad segment checksum"));
+
+    size_t uncompressedSize = 0;
+    char const* const begin = reinterpret_cast<char const*>(compressed.data());
+    if (!snappy::GetUncompressedLength(begin, compressedSize, &uncompressedSize) ||
+        uncompressedSize != rawSize || rawSize > c_maxSegmentSize)
+        BOOST_THROW_EXCEPTION(BadChainArchive() << errinfo_comment("Bad segment size"));
+    bytes ret(rawSize);
+    if (!snappy::Uncompress(begin, compressedSize, reinterpret_cast<char*>(ret.data())))
+        BOOST_THROW_EXCEPTION(BadChainArchive() << errinfo_comment("Bad segment compression"));
+    return ret;
+}
+
+void ChainArchive::forEachSegment(unsigned _from, unsigned _to, unsigned _threads,
+    function<void(bytesConstRef)> const& _f) const
+{
+    _from = max(_from, firstNumber());
+    _to = min(_to, lastNumber());
+    if (_from > _to)
+        return;
+
+    // The segments from the one containing _from to the one containing _to.
+    auto const byFirst = [](unsigned _n, Segment const& _s) { return _n < _s.first; };
+    size_t const begin =
+        upper_bound(m_segments.begin(), m_segments.end(), _from, byFirst) - m_segments.begin() - 1;
+    size_t const end = upper_bound(m_segments.begin(), m_segments.end(), _to, byFirst) - m_segments.begin();
+
+    size_t segment = begin;
+    forEachInOrder<bytes>(end - begin, toThreads(_threads), "archive",
+        [&](size_t _i) { return segmentBlocks(begin + _i); },
+        [&](bytes& _blocks) {
+            // Crops the blocks out of the range from the first and last segments.
+            bytesConstRef const blocks(&_blocks);
+            unsigned number = m_segments[segment++].first;
+            size_t offset = 0;
+            size_t rangeBegin = 0;
+            while (offset < blocks.size() && number <= _to)
+            {
+                if (number == _from)
+                    rangeBegin = offset;
+                size_t const size = RLP(blocks.cropped(offset), RLP::LaissezFaire).actualSize();
+                if (!size || size > blocks.size() - offset)
+                    BOOST_THROW_EXCEPTION(BadChainArchive() << errinfo_comment("Truncated block"));
+                offset += size;
+                ++number;
+            }
+            _f(blocks.cropped(rangeBegin, offset - rangeBegin));
+        });
+}
+
+void dev::eth::exportChainArchive(
+    BlockChain const& _bc, unsigned _from, unsigned _to, ostream& _out, unsigned _threads)
+{
+    if (_from > _to)
+        BOOST_THROW_EXCEPTION(UnknownBlockNumber() << errinfo_comment("Empty range of blocks"));
+    if (_to > _bc.number())
+        BOOST_THROW_EXCEPTION(UnknownBlockNumber() << errinfo_comment("Block " + toString(_to) + " is not in the chain"));
+
+    size_t const segments = (uint64_t(_to) - _from) / ChainArchive::c_segmentBlocks + 1;
+    auto const segmentFirst = [&](size_t _i) {
+        return static_cast<unsigned>(_from + _i * ChainArchive::c_segmentBlocks);
+    };
+
+    uint64_t offset = c_magic.size();
+    RLPStream index(segments);
+    _out.write(reinterpret_cast<char const*>(c_magic.data()), c_magic.size());
+
+    forEachInOrder<bytes>(segments, toThreads(_threads), "archive",
+        [&](size_t _i) {
+            unsigned const first = segmentFirst(_i);
+            unsigned const last = min<uint64_t>(_to, uint64_t(first) + ChainArchive::c_segmentBlocks - 1);
+            bytes raw;
+            for (unsigned n = first; n <= last; ++n)
+            {
+                bytes const block = _bc.block(_bc.numberHash(n));
+                if (block.empty())
+                    BOOST_THROW_EXCEPTION(UnknownBlockNumber() << errinfo_comment("Block " + toString(n) + " is not in the database"));
+                raw += block;
+            }
+
+            string compressed;
+            snappy::Compress(reinterpret_cast<char const*>(raw.data()), raw.size(), &compressed);
+            bytes ret;
+            ret.reserve(c_segmentHeaderSize + compressed.size());
+            putBigEndian(ret, first, 4);
+            putBigEndian(ret, last - first + 1, 4);
+            putBigEndian(ret, raw.size(), 4);
+            putBigEndian(ret, compressed.size(), 4);
+            bytesConstRef const compressedRef(reinterpret_cast<byte const*>(compressed.data()), compressed.size());
+            putBigEndian(ret, crc32(compressedRef), 4);
+            ret.insert(ret.end(), compressedRef.begin(), compressedRef.end());
+            return ret;
+        },
+        [&](bytes& _segment) {
+            unsigned const first = static_cast<unsigned>(getBigEndian(&_segment, 0, 4));
+            index.appendList(3) << first << getBigEndian(&_segment, 4, 4) << offset;
+            _out.write(reinterpret_cast<char const*>(_segment.data()), _segment.size());
+            offset += _segment.size();
+        });
+
+    bytes const& indexBytes = index.out();
+    bytes footer;
+    putBigEndian(footer, offset, 8);
+    putBigEndian(footer, indexBytes.size(), 4);
+    putBigEndian(footer, crc32(&indexBytes), 4);
+    footer += c_magic;
+    _out.write(reinterpret_cast<char const*>(indexBytes.data()), indexBytes.size());
+    _out.write(reinterpret_cast<char const*>(footer.data()), footer.size());
+}
@@ -0,0 +1,83 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+/// @file
+/// Compressed, indexed archives of the canonical chain.
+#pragma once
+
+#include <libdevcore/Common.h>
+#include <libdevcore/Exceptions.h>
+
+#include <functional>
+#include <iosfwd>
+#include <vector>
+
+namespace dev
+{
+namespace eth
+{
+class BlockChain;
+
+DEV_SIMPLE_EXCEPTION(BadChainArchive);
+
+/**
+ * @brief A read-only view of a chain archive, as written by exportChainArchive().
+ *
+ * An archive is a sequence of segments of consecutive blocks, each compressed with snappy and
+ * checksummed apart, followed by an index of the numbers of the first blocks of the segments and
+ * their offsets. The segments of a range of blocks are found through the index and can be
+ * decoded concurrently.
+ *
+ * Layout, with the integers in big-endian order:
+ *   magic
+ *   segment*: first number (4), block count (4), raw size (4), compressed size (4),
+ *             crc32 of the compressed blocks (4), compressed blocks
+ *   index: RLP list of [first number, block count, offset] of each segment
+ *   footer: index offset (8), index size (4), crc32 of the index (4), magic
+ */
+class ChainArchive
+{
+public:
+    /// The number of blocks of a segment, but the last one.
+    static constexpr unsigned c_segmentBlocks = 256;
+
+    /// @throws BadChainArchive if the footer or the index of @a _data is invalid.
+    explicit ChainArchive(bytesConstRef _data);
+
+    /// @returns whether @a _data starts as an archive.
+    static bool isArchive(bytesConstRef _data);
+
+    unsigned firstNumber() const { return m_segments.front().first; }
+    unsigned lastNumber() const { return m_segments.back().first + m_segments.back().count - 1; }
+    size_t segmentCount() const { return m_segments.size(); }
+
+    /// @returns the concatenated RLP blocks of the segment.
+    /// @throws BadChainArchive if the segment does not match its checksum or the index.
+    bytes segmentBlocks(size_t _segment) const;
+
+    /// Calls @a _f with the concatenated blocks from @a _from to @a _to, in order, one segment at
+    /// a time, the segments being decoded ahead on @a _threads threads.
+    void forEachSegment(unsigned _from, unsigned _to, unsigned _threads,
+        std::function<void(bytesConstRef)> const& _f) const;
+
+private:
+    struct Segment
+    {
+        unsigned first;
+        unsigned count;
+        uint64_t offset;
+    };
+
+    bytesConstRef m_data;
+    uint64_t m_indexOffset = 0;
+    std::vector<Segment> m_segments;
+};
+
+/// Writes the canonical blocks from @a _from to @a _to of the chain to @a _out as an archive,
+/// reading and compressing the segments on @a _threads threads, the hardware concurrency if 0.
+void exportChainArchive(BlockChain const& _bc, unsigned _from, unsigned _to, std::ostream& _out,
+    unsigned _threads = 0);
+
+}  // namespace eth
+}  // namespace dev
@@ -54,7 +54,7 @@ Client::Client(ChainParams const& _params, int _networkID, p2p::Host& _host, std
     m_bc(_params, _dbPath, _forceAction, [](unsigned d, unsigned t) { std::cerr << "REVISING BLOCKCHAIN: Processed " << d << " of " << t << "...\r"; }),
     m_tq(_l),
     m_gp(_gpForAdoption ? _gpForAdoption : make_shared<TrivialGasPricer>()),
-    m_preSeal(chainParams().accountStartNonce), m_postSeal(chainParams().accountStartNonce), m_working(chainParams().accountStartNonce) {
+    m_preSeal(chainParams().accountStartNonce), m_postSeal(make_shared<Block const>(chainParams().accountStartNonce)), m_working(chainParams().accountStartNonce) {
     init(_host, _dbPath, _snapshotPath, _forceAction, _networkID);
 }
 
@@ -73,13 +73,13 @@ void Client::init(p2p::Host& _extNet, fs::path const& _dbPath, fs::path const& _
     m_stateDB = State::openDB(_dbPath, bc().genesisHash(), _forceAction);
     // LAZY. TODO: move genesis state construction/commiting to stateDB openning and have this just take the root from the genesis block.
     m_preSeal = bc().genesisBlock(m_stateDB);
-    m_postSeal = m_preSeal;
+    publishPostSeal(m_preSeal);
 
     m_bq.setChain(bc());
 
     m_lastGetWork = std::chrono::system_clock::now() - chrono::seconds(30);
     m_tqReady = m_tq.onReady([=]() { this->onTransactionQueueReady(); });  // TODO: should read m_tq->onReady(thisThread, syncTransactionQueue);
-    m_tqReplaced = m_tq.onReplaced([=](h256 const&) { m_needStateReset = true; });
+    m_tqReplaced = m_tq.onReplaced([=](h256 const& _h) { DEV_GUARDED(x_replacedTransactions) m_replacedTransactions.insert(_h); m_needStateReset = true; });
     m_bqReady = m_bq.onReady([=]() { this->onBlockQueueReady(); });  // TODO: should read m_bq->onReady(thisThread, syncBlockQueue);
     m_bq.setOnBad([=](Exception& ex) { this->onBadBlock(ex); });
     bc().setOnBad([=](Exception& ex) { this->onBadBlock(ex); });
@@ -170,7 +170,7 @@ void Client::startedWorking() {
     DEV_WRITE_GUARDED(x_preSeal) m_preSeal.sync(bc());
     DEV_READ_GUARDED(x_preSeal) {
         DEV_WRITE_GUARDED(x_working) m_working = m_preSeal;
-        DEV_WRITE_GUARDED(x_postSeal) m_postSeal = m_preSeal;
+        publishPostSeal(m_preSeal);
     }
 }
 
@@ -180,7 +180,7 @@ void Client::doneWorking() {
     DEV_WRITE_GUARDED(x_preSeal) m_preSeal.sync(bc());
     DEV_READ_GUARDED(x_preSeal) {
         DEV_WRITE_GUARDED(x_working) m_working = m_preSeal;
-        DEV_WRITE_GUARDED(x_postSeal) m_postSeal = m_preSeal;
+        publishPostSeal(m_preSeal);
     }
 }
 
@@ -204,7 +204,7 @@ void Client::reopenChain(ChainParams const& _p, WithExisting _we) {
         WriteGuard l3(x_working);
 
         m_preSeal = Block(chainParams().accountStartNonce);
-        m_postSeal = Block(chainParams().accountStartNonce);
+        m_postSeal = make_shared<Block const>(chainParams().accountStartNonce);
         m_working = Block(chainParams().accountStartNonce);
 
         m_stateDB = OverlayDB();
@@ -213,7 +213,7 @@ void Client::reopenChain(ChainParams const& _p, WithExisting _we) {
 
         m_preSeal = bc().genesisBlock(m_stateDB);
         m_preSeal.setAuthor(_p.author);
-        m_postSeal = m_preSeal;
+        m_postSeal = make_shared<Block const>(m_preSeal);
         m_working = Block(chainParams().accountStartNonce);
     }
 
@@ -226,6 +226,27 @@ void Client::reopenChain(ChainParams const& _p, WithExisting _we) {
     if (wasSealing) startSealing();
 }
 
+BulkImportProgress Client::importBulk(boost::filesystem::path const& _file,
+    unsigned _progressInterval, BulkImporter::Progress const& _progress)
+{
+    m_signalled.notify_all(); // to wake up the thread from Client::doWork()
+    bool wasSealing = wouldSeal();
+    if (wasSealing) stopSealing();
+    stopWorking();
+    m_bq.clear();
+
+    BulkImportProgress ret;
+    exception_ptr error;
+    try { ret = BulkImporter(m_bc, m_stateDB).import(_file, _progressInterval, _progress); }
+    catch (...) { error = current_exception(); }
+
+    onChainChanged(ImportRoute());
+    startWorking();
+    if (wasSealing) startSealing();
+    if (error) rethrow_exception(error);
+    return ret;
+}
+
 void Client::executeInMainThread(function<void ()> const& _function) {
     DEV_WRITE_GUARDED(x_functionQueue) m_functionQueue.push(_function);
     m_signalled.notify_all();
@@ -233,9 +254,9 @@ void Client::executeInMainThread(function<void ()> const& _function) {
 
 void Client::clearPending() {
     DEV_WRITE_GUARDED(x_postSeal) {
-        if (!m_postSeal.pending().size()) return;
+        if (!m_postSeal->pending().size()) return;
         m_tq.clear();
-        DEV_READ_GUARDED(x_preSeal) m_postSeal = m_preSeal;
+        DEV_READ_GUARDED(x_preSeal) m_postSeal = make_shared<Block const>(m_preSeal);
     }
 
     startSealing();
@@ -247,34 +268,37 @@ void Client::appendFromNewPending(TransactionReceipt const& _receipt, h256Hash&
     Guard l(x_filtersWatches);
     io_changed.insert(PendingChangedFilter);
     m_specialFilters.at(PendingChangedFilter).push_back(_sha3);
-    for (pair<h256 const, InstalledFilter>& i: m_filters) {
-        // acceptable number.
-        auto m = i.second.filter.matches(_receipt);
+    // Only the filters which may match a log of the receipt are tested.
+    for (h256 const& id: m_filterIndex.candidates(_receipt)) {
+        InstalledFilter& f = m_filters.at(id);
+        auto m = f.filter.matches(_receipt);
         if (m.size()) {
             // filter catches them
-            for (LogEntry const& l: m) i.second.changes.push_back(LocalisedLogEntry(l));
-            io_changed.insert(i.first);
+            for (LogEntry const& l: m) f.changes.push_back(LocalisedLogEntry(l));
+            io_changed.insert(id);
         }
     }
 }
 
 void Client::appendFromBlock(h256 const& _block, BlockPolarity _polarity, h256Hash& io_changed) {
-    // TODO: more precise check on whether the txs match.
     auto receipts = bc().receipts(_block).receipts;
+    auto const number = (BlockNumber)bc().number(_block);
 
     Guard l(x_filtersWatches);
     io_changed.insert(ChainChangedFilter);
     m_specialFilters.at(ChainChangedFilter).push_back(_block);
-    for (pair<h256 const, InstalledFilter>& i: m_filters) {
-        // acceptable number & looks like block may contain a matching log entry.
-        for (size_t j = 0; j < receipts.size(); j++) {
-            auto tr = receipts[j];
-            auto m = i.second.filter.matches(tr);
+    // The receipts are taken in order, so the changes of each filter stay in the order of the logs.
+    for (size_t j = 0; j < receipts.size(); j++) {
+        h256 transactionHash;
+        for (h256 const& id: m_filterIndex.candidates(receipts[j])) {
+            InstalledFilter& f = m_filters.at(id);
+            auto m = f.filter.matches(receipts[j]);
             if (m.size()) {
-                auto transactionHash = transaction(_block, j).sha3();
+                if (!transactionHash)
+                    transactionHash = transaction(_block, j).sha3();
                 // filter catches them
-                for (LogEntry const& l: m) i.second.changes.push_back(LocalisedLogEntry(l, _block, (BlockNumber)bc().number(_block), transactionHash, j, 0, _polarity));
-                io_changed.insert(i.first);
+                for (LogEntry const& l: m) f.changes.push_back(LocalisedLogEntry(l, _block, number, transactionHash, j, 0, _polarity));
+                io_changed.insert(id);
             }
         }
     }
@@ -328,10 +352,12 @@ void Client::syncTransactionQueue() {
     }
 
     DEV_READ_GUARDED(x_working)
-        DEV_WRITE_GUARDED(x_postSeal)
-            m_postSeal = m_working;
+        publishPostSeal(m_working);
 
-    DEV_READ_GUARDED(x_postSeal) for (size_t i = 0; i < newPendingReceipts.size(); i++) appendFromNewPending(newPendingReceipts[i], changeds, m_postSeal.pending()[i].sha3());
+    // The new receipts are those of the last transactions of the pending block.
+    auto const postSeal = postSealSnapshot();
+    size_t const firstNew = postSeal->pending().size() - newPendingReceipts.size();
+    for (size_t i = 0; i < newPendingReceipts.size(); i++) appendFromNewPending(newPendingReceipts[i], changeds, postSeal->pending()[firstNew + i].sha3());
 
     // Tell farm about new transaction (i.e. restart mining).
     onPostStateChanged();
@@ -381,17 +407,18 @@ void Client::restartMining() {
     // TODO: use m_postSeal to avoid re-evaluating our own blocks.
     preChanged = newPreMine.sync(bc());
 
-    DEV_READ_GUARDED(x_preSeal) DEV_READ_GUARDED(x_postSeal) if (!preChanged && m_preSeal.author() == m_postSeal.author()) { onTransactionQueueReady(); return; }
+    auto const postSeal = postSealSnapshot();
+    DEV_READ_GUARDED(x_preSeal) if (!preChanged && m_preSeal.author() == postSeal->author()) { onTransactionQueueReady(); return; }
 
     DEV_WRITE_GUARDED(x_preSeal) m_preSeal = newPreMine;
     DEV_WRITE_GUARDED(x_working) m_working = newPreMine;
-    DEV_READ_GUARDED(x_postSeal) if (!m_postSeal.isSealed() || m_postSeal.info().hash() != newPreMine.info().parentHash()) for (auto const& t : m_postSeal.pending()) {
+    if (!postSeal->isSealed() || postSeal->info().hash() != newPreMine.info().parentHash()) for (auto const& t : postSeal->pending()) {
         LOG(m_loggerDetail) << "Resubmitting post-seal transaction " << t;
         //                      ctrace << "Resubmitting post-seal transaction " << t;
         auto ir = m_tq.import(t, IfDropped::Retry);
         if (ir != ImportResult::Success) onTransactionQueueReady();
     }
-    DEV_READ_GUARDED(x_working) DEV_WRITE_GUARDED(x_postSeal) m_postSeal = m_working;
+    DEV_READ_GUARDED(x_working) publishPostSeal(m_working);
 
     onPostStateChanged();
 
@@ -405,12 +432,48 @@ void Client::resetState() {
     DEV_READ_GUARDED(x_preSeal) newPreMine = m_preSeal;
 
     DEV_WRITE_GUARDED(x_working) m_working = newPreMine;
-    DEV_READ_GUARDED(x_working) DEV_WRITE_GUARDED(x_postSeal) m_postSeal = m_working;
+    DEV_READ_GUARDED(x_working) publishPostSeal(m_working);
 
     onPostStateChanged();
     onTransactionQueueReady();
 }
 
+void Client::rollbackReplacedTransactions() {
+    h256Hash replaced;
+    DEV_GUARDED(x_replacedTransactions) swap(replaced, m_replacedTransactions);
+
+    bool rolledBack = false;
+    {
+        WriteGuard l(x_working);
+        if (!m_working.isSealed()) {
+            auto const& pending = m_working.pending();
+            auto const first = find_if(pending.begin(), pending.end(), [&](Transaction const& _t) { return replaced.count(_t.sha3()) > 0; });
+            // Replaced transactions that were not executed yet need no rollback.
+            if (first == pending.end()) return;
+            unsigned const index = first - pending.begin();
+            rolledBack = m_working.rollbackPending(index);
+            if (rolledBack) LOG(m_loggerDetail) << "Rolled pending block back to transaction #" << index;
+        }
+    }
+    if (!rolledBack) {
+        resetState();
+        return;
+    }
+
+    DEV_READ_GUARDED(x_working) publishPostSeal(m_working);
+
+    onPostStateChanged();
+    onTransactionQueueReady();
+}
+
+void Client::publishPostSeal(Block const& _block) {
+    // Copy outside of the lock, readers only wait for the pointer swap. The snapshot is only
+    // copied from then on, so its caches are shared while it is still private.
+    auto snapshot = make_shared<Block>(_block);
+    snapshot->shareCaches();
+    DEV_WRITE_GUARDED(x_postSeal) m_postSeal = move(snapshot);
+}
+
 void Client::onChainChanged(ImportRoute const& _ir) {
 //  ctrace << "onChainChanged()";
     h256Hash changeds;
@@ -462,7 +525,7 @@ void Client::rejigSealing() {
                 m_working.commitToSeal(bc(), m_extraData);
             }
             DEV_READ_GUARDED(x_working) {
-                DEV_WRITE_GUARDED(x_postSeal) m_postSeal = m_working;
+                publishPostSeal(m_working);
                 m_sealingInfo = m_working.info();
             }
 
@@ -503,8 +566,8 @@ void Client::doWork(bool _doWait) {
     if (m_syncBlockQueue.compare_exchange_strong(t, false)) syncBlockQueue();
 
     if (m_needStateReset) {
-        resetState();
         m_needStateReset = false;
+        rollbackReplacedTransactions();
     }
 
     t = true;
@@ -547,8 +610,8 @@ void Client::checkWatchGarbage() {
             }
         for (auto i: toUninstall) uninstallWatch(i);
 
-        // blockchain GC
-        bc().garbageCollect();
+        // the blockchain caches evict as they go, so only report them
+        LOG(m_loggerDetail) << "Chain caches: " << bc().cacheStats();
 
         m_lastGarbageCollection = chrono::system_clock::now();
     }
@@ -608,7 +671,7 @@ bool Client::submitSealed(bytes const& _header) {
             UpgradeGuard l2(l);
             if (!m_working.sealBlock(_header)) return false;
         }
-        DEV_WRITE_GUARDED(x_postSeal) m_postSeal = m_working;
+        publishPostSeal(m_working);
         newBlock = m_working.blockData();
     }
 
@@ -648,7 +711,7 @@ h256 Client::importTransaction(Transaction const& _t) {
     // Use the Executive to perform basic validation of the transaction
     // (e.g. transaction signature, account balance) using the state of
     // the pending block. This can throw but we'll catch the exception at the RPC level.
-    try { Executive(m_postSeal, bc()).initialize(_t); }
+    try { Block pending = postSeal(); Executive(pending, bc()).initialize(_t); }
     catch (InvalidNonce const& e) {
         // Too low nonce is invalid for sure
         bigint const& req = *boost::get_error_info<errinfo_required>(e), got = *boost::get_error_info<errinfo_got>(e);
@@ -674,14 +737,17 @@ h256 Client::importTransaction(Transaction const& _t) {
 ExecutionResult Client::call(Address const& _from, u256 _value, Address _dest, bytes const& _data, u256 _gas, u256 _gasPrice, BlockNumber _blockNumber, FudgeFactor _ff) {
     ExecutionResult ret;
     try {
-        Block temp = blockByNumber(_blockNumber);
-        u256 nonce = max<u256>(temp.transactionsFrom(_from), m_tq.maxNonce(_from));
-        u256 gas = _gas == Invalid256 ? gasLimitRemaining() : _gas;
+        CallLimits const limits = callLimits();
+        auto const deadline = callDeadline(limits);
+        auto const view = readView(_blockNumber);
+        u256 nonce = max<u256>(view->state().getNonce(_from), m_tq.maxNonce(_from));
+        u256 gas = min(_gas == Invalid256 ? gasLimitRemaining() : _gas, limits.gas);
         u256 gasPrice = _gasPrice == Invalid256 ? gasBidPrice() : _gasPrice;
         Transaction t(_value, gasPrice, gas, _dest, _data, nonce);
         t.forceSender(_from);
-        if (_ff == FudgeFactor::Lenient) temp.mutableState().addBalance(_from, (u256)(t.gas() * t.gasPrice() + t.value()));
-        ret = temp.execute(bc().lastBlockHashes(), t, Permanence::Reverted);
+        u256 const extraBalance = _ff == FudgeFactor::Lenient ? t.gas() * t.gasPrice() + t.value() : 0;
+        EnvInfo const env{view->info(), bc().lastBlockHashes(), view->gasUsed(), chainParams().chainID};
+        ret = view->execute(env, *bc().sealEngine(), t, extraBalance, deadline);
     } catch (...) { cwarn << boost::current_exception_diagnostic_information(); }
     return ret;
 }
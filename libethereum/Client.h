@@ -8,6 +8,7 @@
 #include "Block.h"
 #include "BlockChain.h"
 #include "BlockChainImporter.h"
+#include "BulkImporter.h"
 #include "ClientBase.h"
 #include "CommonNet.h"
 #include "StateImporter.h"
@@ -96,12 +97,12 @@ public:
     ImportResult queueBlock(bytes const& _block, bool _isSafe = false);
 
     /// Get the remaining gas limit in this block.
-    u256 gasLimitRemaining() const override { return m_postSeal.gasLimitRemaining(); }
+    u256 gasLimitRemaining() const override { return postSealSnapshot()->gasLimitRemaining(); }
     /// Get the gas bid price
     u256 gasBidPrice() const override { return m_gp->bid(); }
 
     /// Get the object representing the current state of Ethereum.
-    dev::eth::Block postState() const { ReadGuard l(x_postSeal); return m_postSeal; }
+    dev::eth::Block postState() const { return *postSealSnapshot(); }
     /// Get the object representing the current canonical blockchain.
     BlockChain const& blockChain() const { return bc(); }
     /// Get some information on the block queue.
@@ -186,6 +187,10 @@ public:
 
     std::unique_ptr<StateImporterFace> createStateImporter() { return dev::eth::createStateImporter(m_stateDB); }
     std::unique_ptr<BlockChainImporterFace> createBlockChainImporter() { return dev::eth::createBlockChainImporter(m_bc); }
+    /// Imports the blocks of @a _file with a BulkImporter, the client not working meanwhile.
+    /// @throws the error of the first block which cannot be imported, after importing those before.
+    BulkImportProgress importBulk(boost::filesystem::path const& _file, unsigned _progressInterval,
+        BulkImporter::Progress const& _progress = BulkImporter::Progress());
 
     /// Queues a function to be executed in the main thread (that owns the blockchain, etc).
     void executeInMainThread(std::function<void()> const& _function);
@@ -224,7 +229,10 @@ protected:
     /// Returns the state object for the full block (i.e. the terminal state) for index _h.
     /// Works properly with LatestBlock and PendingBlock.
     Block preSeal() const override { ReadGuard l(x_preSeal); return m_preSeal; }
-    Block postSeal() const override { ReadGuard l(x_postSeal); return m_postSeal; }
+    Block postSeal() const override { return *postSealSnapshot(); }
+    std::shared_ptr<Block const> postSealSnapshot() const override { ReadGuard l(x_postSeal); return m_postSeal; }
+    /// Publish a copy of @a _block as the new m_postSeal.
+    void publishPostSeal(Block const& _block);
     void prepareForTransaction() override;
 
     /// Collate the changed filters for the bloom filter of the given pending transaction.
@@ -270,6 +278,10 @@ protected:
     /// Clear working state of transactions
     void resetState();
 
+    /// Roll m_working back to before the first of the transactions replaced in the queue, so that
+    /// the following sync executes the replacements. Falls back to resetState().
+    void rollbackReplacedTransactions();
+
     /// Magically called when the chain has changed. An import route is provided.
     /// Called by either submitWork() or in our main thread through syncBlockQueue().
     void onChainChanged(ImportRoute const& _ir);
@@ -322,12 +334,14 @@ protected:
     mutable SharedMutex x_preSeal;          ///< Lock on m_preSeal.
     Block m_preSeal;                        ///< The present state of the client.
     mutable SharedMutex x_postSeal;         ///< Lock on m_postSeal.
-    Block m_postSeal;                       ///< The state of the client which we're sealing (i.e. it'll have all the rewards added).
+    std::shared_ptr<Block const> m_postSeal;  ///< Immutable snapshot of the state of the client which we're sealing (i.e. it'll have all the rewards added).
     mutable SharedMutex x_working;          ///< Lock on m_working.
     Block m_working;                        ///< The state of the client which we're sealing (i.e. it'll have all the rewards added), while we're actually working on it.
     BlockHeader m_sealingInfo;              ///< The header we're attempting to seal on (derived from m_postSeal).
     std::atomic<bool> m_remoteWorking = { false };          ///< Has the remote worker recently been reset?
-    std::atomic<bool> m_needStateReset = { false };         ///< Need reset working state to premin on next sync
+    std::atomic<bool> m_needStateReset = { false };         ///< Need to roll back working state on next sync
+    Mutex x_replacedTransactions;                           ///< Lock on m_replacedTransactions.
+    h256Hash m_replacedTransactions;                        ///< Transactions replaced in m_tq since the last rollback of m_working.
     std::chrono::system_clock::time_point m_lastGetWork;    ///< Is there an active and valid remote worker?
 
     std::weak_ptr<EthereumCapability> m_host;
@@ -13,54 +13,28 @@ using namespace std;
 using namespace dev;
 using namespace dev::eth;
 
-static const int64_t c_maxGasEstimate = 50000000;
-
 std::pair<u256, ExecutionResult> ClientBase::estimateGas(Address const& _from, u256 _value, Address _dest, bytes const& _data, int64_t _maxGas, u256 _gasPrice, BlockNumber _blockNumber, GasEstimationCallback const& _callback)
 {
     try
     {
+        CallLimits const limits = callLimits();
+        auto const deadline = callDeadline(limits);
+        int64_t const maxGasEstimate = static_cast<int64_t>(min<u256>(limits.gas, numeric_limits<int64_t>::max()));
         int64_t upperBound = _maxGas;
-        if (upperBound == Invalid256 || upperBound > c_maxGasEstimate)
-            upperBound = c_maxGasEstimate;
+        if (upperBound == Invalid256 || upperBound > maxGasEstimate)
+            upperBound = maxGasEstimate;
         int64_t lowerBound = Transaction::baseGasRequired(!_dest, &_data, EVMSchedule());
-        Block bk = blockByNumber(_blockNumber);
+        auto const view = readView(_blockNumber);
+        u256 const n = view->state().getNonce(_from);
         u256 gasPrice = _gasPrice == Invalid256 ? gasBidPrice() : _gasPrice;
-        ExecutionResult er;
-        ExecutionResult lastGood;
-        bool good = false;
-        while (upperBound != lowerBound)
-        {
-            int64_t mid = (lowerBound + upperBound) / 2;
-            u256 n = bk.transactionsFrom(_from);
-            Transaction t;
-            if (_dest)
-                t = Transaction(_value, gasPrice, mid, _dest, _data, n);
-            else
-                t = Transaction(_value, gasPrice, mid, _data, n);
+        auto const transactionWithGas = [&](int64_t _gas) {
+            Transaction t = _dest ? Transaction(_value, gasPrice, _gas, _dest, _data, n) :
+                                    Transaction(_value, gasPrice, _gas, _data, n);
             t.forceSender(_from);
-            EnvInfo const env(bk.info(), bc().lastBlockHashes(), 0, mid);
-            State tempState(bk.state());
-            tempState.addBalance(_from, (u256)(t.gas() * t.gasPrice() + t.value()));
-            er = tempState.execute(env, *bc().sealEngine(), t, Permanence::Reverted).first;
-            if (er.excepted == TransactionException::OutOfGas ||
-                er.excepted == TransactionException::OutOfGasBase ||
-                er.excepted == TransactionException::OutOfGasIntrinsic ||
-                er.codeDeposit == CodeDeposit::Failed ||
-                er.excepted == TransactionException::BadJumpDestination)
-                    lowerBound = lowerBound == mid ? upperBound : mid;
-            else
-            {
-                lastGood = er;
-                upperBound = upperBound == mid ? lowerBound : mid;
-                good = true;
-            }
-
-            if (_callback)
-                _callback(GasEstimationProgress { lowerBound, upperBound });
-        }
-        if (_callback)
-            _callback(GasEstimationProgress { lowerBound, upperBound });
-        return make_pair(upperBound, good ? lastGood : er);
+            return t;
+        };
+        return view->estimateGas(bc().lastBlockHashes(), *bc().sealEngine(), transactionWithGas,
+            lowerBound, upperBound, deadline, _callback);
     }
     catch (...)
     {
@@ -127,6 +101,8 @@ LocalisedLogEntries ClientBase::logs(unsigned _watchId) const
 
 LocalisedLogEntries ClientBase::logs(LogFilter const& _f) const
 {
+    LogQueryLimits const limits = logQueryLimits();
+    auto const deadline = logQueryDeadline(limits);
     LocalisedLogEntries ret;
     unsigned begin = min(bc().number() + 1, (unsigned)numberFromHash(_f.latest()));
     unsigned end = min(bc().number(), min(begin, (unsigned)numberFromHash(_f.earliest())));
@@ -134,14 +110,14 @@ LocalisedLogEntries ClientBase::logs(LogFilter const& _f) const
     // Handle pending transactions differently as they're not on the block chain.
     if (begin > bc().number())
     {
-        Block temp = postSeal();
-        for (unsigned i = 0; i < temp.pending().size(); ++i)
+        auto const pending = postSealSnapshot();
+        for (unsigned i = 0; i < pending->pending().size(); ++i)
         {
             // Might have a transaction that contains a matching log.
-            TransactionReceipt const& tr = temp.receipt(i);
+            TransactionReceipt const& tr = pending->receipt(i);
             LogEntries le = _f.matches(tr);
             for (unsigned j = 0; j < le.size(); ++j)
-                ret.insert(ret.begin(), LocalisedLogEntry(le[j]));
+                ret.push_back(LocalisedLogEntry(le[j]));
         }
         begin = bc().number();
     }
@@ -154,7 +130,7 @@ LocalisedLogEntries ClientBase::logs(LogFilter const& _f) const
     tie(blocks, ancestor, ancestorIndex) = bc().treeRoute(_f.earliest(), _f.latest(), false);
 
     for (size_t i = 0; i < ancestorIndex; i++)
-        prependLogsFromBlock(_f, blocks[i], BlockPolarity::Dead, ret);
+        appendLogsFromBlock(_f, blocks[i], BlockPolarity::Dead, ret);
 
     // cause end is our earliest block, let's compare it with our ancestor
     // if ancestor is smaller let's move our end to it
@@ -173,31 +149,58 @@ LocalisedLogEntries ClientBase::logs(LogFilter const& _f) const
     // Handle blocks from main chain
     set<unsigned> matchingBlocks;
     if (!_f.isRangeFilter())
-        for (auto const& i: _f.bloomPossibilities())
-            for (auto u: bc().withBlockBloom(i, end, begin))
+    {
+        // The log index has the exact blocks from its first one on, the blooms have the rest.
+        unsigned bloomsLatest = begin;
+        bool useBlooms = true;
+        LogIndex const* index = bc().logIndex();
+        if (index && begin >= max(end, index->firstBlock()))
+        {
+            unsigned const indexedEarliest = max(end, index->firstBlock());
+            for (auto u: index->matchingBlocks(_f.addresses(), _f.topics(), indexedEarliest, begin))
                 matchingBlocks.insert(u);
+            useBlooms = indexedEarliest > end;
+            bloomsLatest = indexedEarliest - 1;
+        }
+        if (useBlooms)
+            for (auto const& i: _f.bloomPossibilities())
+                for (auto u: bc().withBlockBloom(i, end, bloomsLatest))
+                    matchingBlocks.insert(u);
+    }
     else
         // if it is a range filter, we want to get all logs from all blocks in given range
         for (unsigned i = end; i <= begin; i++)
             matchingBlocks.insert(i);
 
-    for (auto n: matchingBlocks)
-        prependLogsFromBlock(_f, bc().numberHash(n), BlockPolarity::Live, ret);
+    if (limits.maxResults && ret.size() > limits.maxResults)
+        BOOST_THROW_EXCEPTION(TooManyLogs());
 
-    reverse(ret.begin(), ret.end());
+    // Scan the blocks on the pool, in chunks, and get their logs in the order of the blocks.
+    vector<unsigned> const live(matchingBlocks.begin(), matchingBlocks.end());
+    LogScanPool::instance().scan(live,
+        [&](unsigned _number, LocalisedLogEntries& o_logs) {
+            appendLogsFromBlock(_f, bc().numberHash(_number), BlockPolarity::Live, o_logs);
+        },
+        limits.maxResults, deadline, ret);
     return ret;
 }
 
-void ClientBase::prependLogsFromBlock(LogFilter const& _f, h256 const& _blockHash, BlockPolarity _polarity, LocalisedLogEntries& io_logs) const
+void ClientBase::appendLogsFromBlock(LogFilter const& _f, h256 const& _blockHash, BlockPolarity _polarity, LocalisedLogEntries& io_logs) const
 {
-    auto receipts = bc().receipts(_blockHash).receipts;
+    auto const receipts = bc().receipts(_blockHash).receipts;
+    BlockNumber const number = bc().number(_blockHash);
+    bytes block;
     for (size_t i = 0; i < receipts.size(); i++)
     {
-        TransactionReceipt receipt = receipts[i];
-        auto th = transaction(_blockHash, i).sha3();
-        LogEntries le = _f.matches(receipt);
+        LogEntries le = _f.matches(receipts[i]);
+        if (le.empty())
+            continue;
+        // Only the transactions with matching logs are hashed, reading the block once.
+        if (block.empty())
+            block = bc().block(_blockHash);
+        h256 const th = sha3(RLP(block)[1][i].data());
         for (unsigned j = 0; j < le.size(); ++j)
-            io_logs.insert(io_logs.begin(), LocalisedLogEntry(le[j], _blockHash, (BlockNumber)bc().number(_blockHash), th, i, 0, _polarity));
+            io_logs.push_back(LocalisedLogEntry(le[j], _blockHash, number, th, i, 0, _polarity));
     }
 }
 
@@ -210,6 +213,7 @@ unsigned ClientBase::installWatch(LogFilter const& _f, Reaping _r)
         {
             LOG(m_loggerWatch) << "FFF" << _f << h;
             m_filters.insert(make_pair(h, _f));
+            m_filterIndex.insert(h, _f);
         }
     }
     return installWatch(h, _r);
@@ -253,6 +257,7 @@ bool ClientBase::uninstallWatch(unsigned _i)
         if (!--fit->second.refCount)
         {
             LOG(m_loggerWatch) << "*X*" << fit->first << ":" << fit->second.filter;
+            m_filterIndex.erase(fit->first, fit->second.filter);
             m_filters.erase(fit);
         }
     return true;
@@ -407,21 +412,22 @@ unsigned ClientBase::number() const
 
 h256s ClientBase::pendingHashes() const
 {
-    return h256s() + postSeal().pendingHashes();
+    return h256s() + postSealSnapshot()->pendingHashes();
 }
 
 BlockHeader ClientBase::pendingInfo() const
 {
-    return postSeal().info();
+    return postSealSnapshot()->info();
 }
 
 BlockDetails ClientBase::pendingDetails() const
 {
-    auto const pendingHeader = postSeal().info();
+    auto const pending = postSealSnapshot();
+    auto const& pendingHeader = pending->info();
     auto const latestDetails = Interface::blockDetails(LatestBlock);
     return BlockDetails{static_cast<unsigned>(pendingHeader.number()),
         latestDetails.totalDifficulty + pendingHeader.difficulty(), pendingHeader.parentHash(),
-        h256s{} /* children */, postSeal().blockData().size()};
+        h256s{} /* children */, pending->blockData().size()};
 }
 
 Addresses ClientBase::addresses(BlockNumber _block) const
@@ -434,7 +440,7 @@ Addresses ClientBase::addresses(BlockNumber _block) const
 
 u256 ClientBase::gasLimitRemaining() const
 {
-    return postSeal().gasLimitRemaining();
+    return postSealSnapshot()->gasLimitRemaining();
 }
 
 Address ClientBase::author() const
@@ -508,6 +514,36 @@ Block ClientBase::blockByNumber(BlockNumber _h) const
     return block(bc().numberHash(_h));
 }
 
+shared_ptr<ReadView const> ClientBase::readView(BlockNumber _block) const
+{
+    if (_block == PendingBlock)
+    {
+        auto const snapshot = postSealSnapshot();
+        DEV_GUARDED(x_readViews)
+            if (m_pendingViewBlock == snapshot)
+                return m_pendingView;
+
+        auto view = make_shared<ReadView const>(*snapshot);
+        DEV_GUARDED(x_readViews)
+        {
+            m_pendingViewBlock = snapshot;
+            m_pendingView = view;
+        }
+        return view;
+    }
+
+    h256 const hash = _block == LatestBlock ? bc().currentHash() : bc().numberHash(_block);
+    DEV_GUARDED(x_readViews)
+        if (auto view = m_readViews.find(hash))
+            return *view;
+
+    // Build the view outside of the lock; concurrent misses on the same block may build it twice.
+    auto view = make_shared<ReadView const>(block(hash));
+    DEV_GUARDED(x_readViews)
+        m_readViews.insert(hash, view);
+    return view;
+}
+
 int ClientBase::chainId() const
 {
 	return bc().chainParams().chainID;
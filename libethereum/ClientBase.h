@@ -8,9 +8,13 @@
 #include <chrono>
 #include "Interface.h"
 #include "LogFilter.h"
+#include "LogFilterIndex.h"
+#include "LogScanPool.h"
 #include "TransactionQueue.h"
 #include "Block.h"
 #include "CommonNet.h"
+#include "ReadView.h"
+#include <libdevcore/LruCache.h>
 
 namespace dev
 {
@@ -54,7 +58,7 @@ public:
     virtual ~ClientBase() {}
 
     /// Estimate gas usage for call/create.
-    /// @param _maxGas An upper bound value for estimation, if not provided default value of c_maxGasEstimate will be used.
+    /// @param _maxGas An upper bound value for estimation, if not provided the gas limit of calls will be used.
     /// @param _callback Optional callback function for progress reporting
     std::pair<u256, ExecutionResult> estimateGas(Address const& _from, u256 _value, Address _dest, bytes const& _data, int64_t _maxGas, u256 _gasPrice, BlockNumber _blockNumber, GasEstimationCallback const& _callback) override;
 
@@ -75,7 +79,8 @@ public:
 
     LocalisedLogEntries logs(unsigned _watchId) const override;
     LocalisedLogEntries logs(LogFilter const& _filter) const override;
-    virtual void prependLogsFromBlock(LogFilter const& _filter, h256 const& _blockHash, BlockPolarity _polarity, LocalisedLogEntries& io_logs) const;
+    /// Appends the logs of the block matching the filter to @a io_logs in their order.
+    virtual void appendLogsFromBlock(LogFilter const& _filter, h256 const& _blockHash, BlockPolarity _polarity, LocalisedLogEntries& io_logs) const;
 
     /// Install, uninstall and query watches.
     unsigned installWatch(LogFilter const& _filter, Reaping _r = Reaping::Automatic) override;
@@ -97,12 +102,12 @@ public:
     LocalisedTransactionReceipt localisedTransactionReceipt(h256 const& _transactionHash) const override;
     std::pair<h256, unsigned> transactionLocation(h256 const& _transactionHash) const override;
     Transactions transactions(h256 _blockHash) const override;
-    Transactions transactions(BlockNumber _block) const override { if (_block == PendingBlock) return postSeal().pending(); return transactions(hashFromNumber(_block)); }
+    Transactions transactions(BlockNumber _block) const override { if (_block == PendingBlock) return postSealSnapshot()->pending(); return transactions(hashFromNumber(_block)); }
     TransactionHashes transactionHashes(h256 _blockHash) const override;
     BlockHeader uncle(h256 _blockHash, unsigned _i) const override;
     UncleHashes uncleHashes(h256 _blockHash) const override;
     unsigned transactionCount(h256 _blockHash) const override;
-    unsigned transactionCount(BlockNumber _block) const override { if (_block == PendingBlock) { auto p = postSeal().pending(); return p.size(); } return transactionCount(hashFromNumber(_block)); }
+    unsigned transactionCount(BlockNumber _block) const override { if (_block == PendingBlock) return postSealSnapshot()->pending().size(); return transactionCount(hashFromNumber(_block)); }
     unsigned uncleCount(h256 _blockHash) const override;
     unsigned number() const override;
     h256s pendingHashes() const override;
@@ -150,6 +155,18 @@ public:
 
     Block blockByNumber(BlockNumber _h) const;
 
+    /// @returns a read-only view of the state at the given block. Views of recent blocks are
+    /// cached, so concurrent calls against the same block share one view.
+    std::shared_ptr<ReadView const> readView(BlockNumber _block) const;
+
+    /// Limits applied to call() and estimateGas().
+    CallLimits callLimits() const { Guard l(x_readViews); return m_callLimits; }
+    void setCallLimits(CallLimits const& _limits) { Guard l(x_readViews); m_callLimits = _limits; }
+
+    /// Limits applied to logs().
+    LogQueryLimits logQueryLimits() const { Guard l(x_readViews); return m_logQueryLimits; }
+    void setLogQueryLimits(LogQueryLimits const& _limits) { Guard l(x_readViews); m_logQueryLimits = _limits; }
+
     int chainId() const override;
 
 protected:
@@ -160,17 +177,31 @@ protected:
     virtual Block block(h256 const& _h) const = 0;
     virtual Block preSeal() const = 0;
     virtual Block postSeal() const = 0;
+    /// @returns the pending block for reading its transactions, receipts and header without
+    /// copying it. Use postSeal() for access to the state, the snapshot must not be mutated.
+    virtual std::shared_ptr<Block const> postSealSnapshot() const { return std::make_shared<Block const>(postSeal()); }
     virtual void prepareForTransaction() = 0;
     /// }
 
     // filters
     mutable Mutex x_filtersWatches;							///< Our lock.
     std::unordered_map<h256, InstalledFilter> m_filters;	///< The dictionary of filters that are active.
+    LogFilterIndex m_filterIndex;							///< The filters of m_filters by the logs they may match.
     std::unordered_map<h256, h256s> m_specialFilters = std::unordered_map<h256, std::vector<h256>>{{PendingChangedFilter, {}}, {ChainChangedFilter, {}}};
                                                             ///< The dictionary of special filters and their additional data
     std::map<unsigned, ClientWatch> m_watches;				///< Each and every watch - these reference a filter.
 
     Logger m_loggerWatch{createLogger(VerbosityDebug, "watch")};
+
+private:
+    static constexpr size_t c_readViewCacheSize = 16;
+
+    mutable Mutex x_readViews;                       ///< Lock on the read views and query limits.
+    mutable LruCache<h256, std::shared_ptr<ReadView const>> m_readViews{c_readViewCacheSize};  ///< Views of chain blocks by hash.
+    mutable std::shared_ptr<Block const> m_pendingViewBlock;   ///< The pending block snapshot m_pendingView was made of.
+    mutable std::shared_ptr<ReadView const> m_pendingView;     ///< View of the pending block.
+    CallLimits m_callLimits;
+    LogQueryLimits m_logQueryLimits;
 };
 
 }}
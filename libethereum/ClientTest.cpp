@@ -81,8 +81,7 @@ void ClientTest::modifyTimestamp(int64_t _timestamp)
         block = m_preSeal;
 
     Transactions transactions;
-    DEV_READ_GUARDED(x_postSeal)
-        transactions = m_postSeal.pending();
+    transactions = postSealSnapshot()->pending();
     block.resetCurrent(_timestamp);
 
     DEV_WRITE_GUARDED(x_preSeal)
@@ -95,8 +94,7 @@ void ClientTest::modifyTimestamp(int64_t _timestamp)
 
     DEV_WRITE_GUARDED(x_working)
         m_working = block;
-    DEV_READ_GUARDED(x_postSeal)
-        m_postSeal = block;
+    publishPostSeal(block);
 
     onPostStateChanged();
 }
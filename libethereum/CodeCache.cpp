@@ -0,0 +1,84 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#include "CodeCache.h"
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+constexpr size_t CodeCache::c_defaultBudget;
+
+CodeCache::Code CodeCache::find(h256 const& _hash)
+{
+    Guard l(x_cache);
+    auto const it = m_index.find(_hash);
+    if (it == m_index.end())
+    {
+        ++m_misses;
+        return {};
+    }
+
+    ++m_hits;
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return it->second->second;
+}
+
+CodeCache::Code CodeCache::insert(h256 const& _hash, Code _code)
+{
+    if (!_code)
+        return _code;
+
+    Guard l(x_cache);
+    auto const it = m_index.find(_hash);
+    if (it != m_index.end())
+    {
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return it->second->second;
+    }
+
+    m_bytes += _code->size();
+    m_entries.emplace_front(_hash, _code);
+    m_index.emplace(_hash, m_entries.begin());
+    evict_WITH_LOCK();
+    return _code;
+}
+
+void CodeCache::setBudget(size_t _budget)
+{
+    Guard l(x_cache);
+    m_budget = _budget;
+    evict_WITH_LOCK();
+}
+
+size_t CodeCache::budget() const
+{
+    Guard l(x_cache);
+    return m_budget;
+}
+
+CodeCacheStats CodeCache::stats() const
+{
+    Guard l(x_cache);
+    return {m_hits, m_misses, m_index.size(), m_bytes};
+}
+
+void CodeCache::clear()
+{
+    Guard l(x_cache);
+    m_index.clear();
+    m_entries.clear();
+    m_bytes = 0;
+}
+
+void CodeCache::evict_WITH_LOCK()
+{
+    while (m_bytes > m_budget && !m_entries.empty())
+    {
+        auto const& last = m_entries.back();
+        m_bytes -= last.second->size();
+        m_index.erase(last.first);
+        m_entries.pop_back();
+    }
+}
@@ -0,0 +1,79 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#pragma once
+
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/Guards.h>
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+namespace dev
+{
+namespace eth
+{
+/// Counters of the code cache.
+struct CodeCacheStats
+{
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    size_t entries = 0;
+    size_t bytes = 0;  ///< Total size of the cached code.
+};
+
+/**
+ * @brief Process-wide cache of contract code keyed by code hash.
+ *
+ * The code is immutable and reference counted, so the states, accounts and VM frames using a
+ * blob share it with the cache, and a blob dropped from the cache stays valid for its users. The
+ * least recently used blobs are dropped when the total size of the cached code exceeds the budget.
+ */
+class CodeCache
+{
+public:
+    using Code = std::shared_ptr<bytes const>;
+
+    /// The default budget, in bytes of code.
+    static constexpr size_t c_defaultBudget = 64 * 1024 * 1024;
+
+    explicit CodeCache(size_t _budget = c_defaultBudget) : m_budget(_budget) {}
+
+    static CodeCache& instance()
+    {
+        static CodeCache s_cache;
+        return s_cache;
+    }
+
+    /// @returns the code with the hash, making it the most recently used, or null if not cached.
+    Code find(h256 const& _hash);
+
+    /// Adds the code with the hash. @returns the cached code, which is the one already cached if
+    /// another user has added it first.
+    Code insert(h256 const& _hash, Code _code);
+
+    void setBudget(size_t _budget);
+    size_t budget() const;
+
+    CodeCacheStats stats() const;
+    void clear();
+
+private:
+    using Entries = std::list<std::pair<h256, Code>>;
+
+    void evict_WITH_LOCK();
+
+    mutable Mutex x_cache;
+    Entries m_entries;  ///< The most recently used first.
+    std::unordered_map<h256, Entries::iterator> m_index;
+    size_t m_budget;
+    size_t m_bytes = 0;
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+};
+
+}  // namespace eth
+}  // namespace dev
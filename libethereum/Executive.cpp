@@ -34,6 +34,26 @@ std::string dumpStackAndMemory(LegacyVM const& _vm)
     return o.str();
 };
 
+// Loggers are not thread-safe and costly to create, so each thread shares its own ones between the
+// executives it runs.
+Logger& execLogger()
+{
+    static thread_local Logger s_logger{createLogger(VerbosityDebug, "exec")};
+    return s_logger;
+}
+
+Logger& detailsLogger()
+{
+    static thread_local Logger s_logger{createLogger(VerbosityTrace, "exec")};
+    return s_logger;
+}
+
+Logger& vmTraceLogger()
+{
+    static thread_local Logger s_logger{createLogger(VerbosityTrace, "vmtrace")};
+    return s_logger;
+}
+
 std::string dumpStorage(ExtVM const& _ext)
 {
     ostringstream o;
@@ -44,6 +64,11 @@ std::string dumpStorage(ExtVM const& _ext)
 };
 }  // namespace
 
+Executive::Executive(
+    State& _s, EnvInfo const& _envInfo, SealEngineFace const& _sealEngine, unsigned _level)
+  : m_s(_s), m_envInfo(_envInfo), m_depth(_level), m_sealEngine(_sealEngine)
+{}
+
 Executive::Executive(Block& _s, BlockChain const& _bc, unsigned _level)
   : m_s(_s.mutableState()),
     m_envInfo(_s.info(), _bc.lastBlockHashes(), 0, _bc.chainID()),
@@ -70,6 +95,8 @@ Executive::Executive(
 {
 }
 
+Executive::~Executive() = default;
+
 u256 Executive::gasUsed() const
 {
     return m_t.gas() - m_gas;
@@ -105,13 +132,13 @@ void Executive::initialize(Transaction const& _transaction)
         }
         catch (InvalidSignature const&)
         {
-            LOG(m_execLogger) << "Invalid Signature";
+            LOG(execLogger()) << "Invalid Signature";
             m_excepted = TransactionException::InvalidSignature;
             throw;
         }
         if (m_t.nonce() != nonceReq)
         {
-            LOG(m_execLogger) << "Sender: " << m_t.sender().hex() << " Invalid Nonce: Required "
+            LOG(execLogger()) << "Sender: " << m_t.sender().hex() << " Invalid Nonce: Required "
                               << nonceReq << ", received " << m_t.nonce();
             m_excepted = TransactionException::InvalidNonce;
             BOOST_THROW_EXCEPTION(
@@ -123,7 +150,7 @@ void Executive::initialize(Transaction const& _transaction)
         bigint totalCost = m_t.value() + gasCost;
         if (m_s.balance(m_t.sender()) < totalCost)
         {
-            LOG(m_execLogger) << "Not enough cash: Require > " << totalCost << " = " << m_t.gas()
+            LOG(execLogger()) << "Not enough cash: Require > " << totalCost << " = " << m_t.gas()
                               << " * " << m_t.gasPrice() << " + " << m_t.value() << " Got"
                               << m_s.balance(m_t.sender()) << " for sender: " << m_t.sender();
             m_excepted = TransactionException::NotEnoughCash;
@@ -138,8 +165,10 @@ bool Executive::execute()
 {
     // Entry point for a user-executed transaction.
 
+    m_vmMemoryStats = VMMemoryPool::local().stats();
+
     // Pay...
-    LOG(m_detailsLogger) << "Paying " << formatBalance(m_gasCost) << " from sender for gas ("
+    LOG(detailsLogger()) << "Paying " << formatBalance(m_gasCost) << " from sender for gas ("
                          << m_t.gas() << " gas at " << formatBalance(m_t.gasPrice()) << ")";
     m_s.subBalance(m_t.sender(), m_gasCost);
 
@@ -211,13 +240,14 @@ bool Executive::call(CallParameters const& _p, u256 const& _gasPrice, Address co
         m_gas = _p.gas;
         if (m_s.addressHasCode(_p.codeAddress))
         {
-            bytes const& c = m_s.code(_p.codeAddress);
+            // The code may be missing from the database, in which case no code is run.
+            auto const c = m_s.sharedCode(_p.codeAddress);
             h256 codeHash = m_s.codeHash(_p.codeAddress);
             // Contract will be executed with the version stored in account
             auto const version = m_s.version(_p.codeAddress);
-            m_ext = make_shared<ExtVM>(m_s, m_envInfo, m_sealEngine, _p.receiveAddress,
-                _p.senderAddress, _origin, _p.apparentValue, _gasPrice, _p.data, &c, codeHash,
-                version, m_depth, false, _p.staticCall);
+            m_ext.reset(new ExtVM(m_s, m_envInfo, m_sealEngine, _p.receiveAddress,
+                _p.senderAddress, _origin, _p.apparentValue, _gasPrice, _p.data,
+                c ? bytesConstRef(c.get()) : bytesConstRef(), codeHash, version, m_depth, false, _p.staticCall, c));
         }
     }
 
@@ -276,7 +306,7 @@ bool Executive::executeCreate(Address const& _sender, u256 const& _endowment, u2
     bool accountAlreadyExist = (m_s.addressHasCode(m_newAddress) || m_s.getNonce(m_newAddress) > 0);
     if (accountAlreadyExist)
     {
-        LOG(m_detailsLogger) << "Address already used: " << m_newAddress;
+        LOG(detailsLogger()) << "Address already used: " << m_newAddress;
         m_gas = 0;
         m_excepted = TransactionException::AddressAlreadyUsed;
         revert();
@@ -297,9 +327,9 @@ bool Executive::executeCreate(Address const& _sender, u256 const& _endowment, u2
 
     // Schedule _init execution if not empty.
     if (!_init.empty())
-        m_ext = make_shared<ExtVM>(m_s, m_envInfo, m_sealEngine, m_newAddress, _sender, _origin,
+        m_ext.reset(new ExtVM(m_s, m_envInfo, m_sealEngine, m_newAddress, _sender, _origin,
             _endowment, _gasPrice, bytesConstRef(), _init, sha3(_init), _version, m_depth, true,
-            false);
+            false));
     else
         // code stays empty, but we set the version
         m_s.setCode(m_newAddress, {}, _version);
@@ -309,7 +339,7 @@ bool Executive::executeCreate(Address const& _sender, u256 const& _endowment, u2
 
 OnOpFunc Executive::simpleTrace()
 {
-    Logger& traceLogger = m_vmTraceLogger;
+    Logger& traceLogger = vmTraceLogger();
 
     return [&traceLogger](uint64_t steps, uint64_t PC, Instruction inst, bigint newMemSize,
                bigint gasCost, bigint gas, VMFace const* _vm, ExtVMFace const* voidExt) {
@@ -380,7 +410,7 @@ bool Executive::go(OnOpFunc const& _onOp)
         }
         catch (VMException const& _e)
         {
-            LOG(m_detailsLogger) << "Safe VM Exception. " << diagnostic_information(_e);
+            LOG(detailsLogger()) << "Safe VM Exception. " << diagnostic_information(_e);
             m_gas = 0;
             m_excepted = toTransactionException(_e);
             revert();
@@ -392,6 +422,11 @@ bool Executive::go(OnOpFunc const& _onOp)
             revert();
             throw;
         }
+        catch (ExecutionTimeout const&)
+        {
+            revert();
+            throw;
+        }
         catch (Exception const& _e)
         {
             // TODO: AUDIT: check that this can never reasonably happen. Consider what to do if it does.
@@ -452,6 +487,11 @@ bool Executive::finalize()
     if (m_ext)
         m_logs = m_ext->sub.logs;
 
+    m_vmMemoryStats = VMMemoryPool::local().stats() - m_vmMemoryStats;
+    LOG(detailsLogger()) << "VM memory: " << m_vmMemoryStats.frames << " buffers, "
+                         << m_vmMemoryStats.reused << " reused, "
+                         << m_vmMemoryStats.allocations << " heap allocations";
+
     if (m_res) // Collect results
     {
         m_res->gasUsed = gasUsed();
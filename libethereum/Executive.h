@@ -8,7 +8,9 @@
 #include <libdevcore/Log.h>
 #include <libethcore/Common.h>
 #include <libevm/ExtVMFace.h>
+#include <libevm/VMMemoryPool.h>
 #include <functional>
+#include <memory>
 
 namespace dev
 {
@@ -49,7 +51,7 @@ class Executive
 {
 public:
     /// Simple constructor; executive will operate on given state, with the given environment info.
-    Executive(State& _s, EnvInfo const& _envInfo, SealEngineFace const& _sealEngine, unsigned _level = 0): m_s(_s), m_envInfo(_envInfo), m_depth(_level), m_sealEngine(_sealEngine) {}
+    Executive(State& _s, EnvInfo const& _envInfo, SealEngineFace const& _sealEngine, unsigned _level = 0);
 
     /** Easiest constructor.
      * Creates executive to operate on the state of end of the given block, populating environment
@@ -70,6 +72,8 @@ public:
      */
     Executive(State& io_s, Block const& _block, unsigned _txIndex, BlockChain const& _bc, unsigned _level = 0);
 
+    ~Executive();
+
     Executive(Executive const&) = delete;
     void operator=(Executive) = delete;
 
@@ -92,6 +96,10 @@ public:
     /// @returns total gas used in the transaction/operation.
     /// @warning Only valid after finalise().
     u256 gasUsed() const;
+    /// @returns the VM memory pool counters of the frames this transaction executed on the
+    /// calling thread.
+    /// @warning Only valid after finalise().
+    VMMemoryStats const& vmMemoryStats() const { return m_vmMemoryStats; }
 
     owning_bytes_ref takeOutput() { return std::move(m_output); }
 
@@ -144,9 +152,8 @@ private:
         u256 const& _gas, bytesConstRef _code, Address const& _originAddress, u256 const& _version);
 
     State& m_s;							///< The state to which this operation/transaction is applied.
-    // TODO: consider changign to EnvInfo const& to avoid LastHashes copy at every CALL/CREATE
-    EnvInfo m_envInfo;					///< Information on the runtime environment.
-    std::shared_ptr<ExtVM> m_ext;		///< The VM externality object for the VM execution or null if no VM is required. shared_ptr used only to allow ExtVM forward reference. This field does *NOT* survive this object.
+    EnvInfo m_envInfo;					///< Information on the runtime environment. Copies share the block header, so nested frames copy it cheaply.
+    std::unique_ptr<ExtVM> m_ext;		///< The VM externality object for the VM execution or null if no VM is required. This field does *NOT* survive this object.
     owning_bytes_ref m_output;			///< Execution output.
     ExecutionResult* m_res = nullptr;	///< Optional storage for execution results.
 
@@ -157,6 +164,7 @@ private:
 
     Transaction m_t;					///< The original transaction. Set by setup().
     LogEntries m_logs;					///< The log entries created by this transaction. Set by finalize().
+    VMMemoryStats m_vmMemoryStats;		///< VM memory pool counters at execute(), turned into the transaction's share by finalize().
 
     u256 m_gasCost;
     SealEngineFace const& m_sealEngine;
@@ -164,10 +172,6 @@ private:
     bool m_isCreation = false;
     Address m_newAddress;
     size_t m_savepoint = 0;
-
-    Logger m_execLogger{createLogger(VerbosityDebug, "exec")};
-    Logger m_detailsLogger{createLogger(VerbosityTrace, "exec")};
-    Logger m_vmTraceLogger{createLogger(VerbosityTrace, "vmtrace")};
 };
 
 }
@@ -3,7 +3,8 @@
 // Licensed under the GNU General Public License, Version 3.
 #include "ExtVM.h"
 #include "LastBlockHashesFace.h"
-#include <boost/thread.hpp>
+#include <boost/context/continuation.hpp>
+#include <boost/context/pooled_fixedsize_stack.hpp>
 #include <exception>
 
 using namespace dev;
@@ -33,20 +34,23 @@ static size_t const c_entryOverhead = 128 * 1024;
 /// On what depth execution should be offloaded to additional separated stack space.
 static unsigned const c_offloadPoint = (c_defaultStackSize - c_entryOverhead) / c_singleExecutionStackSize;
 
-void goOnOffloadedStack(Executive& _e, OnOpFunc const& _onOp) {
-    // Set new stack size enouth to handle the rest of the calls up to the limit.
-    boost::thread::attributes attrs;
-    attrs.set_stack_size((c_depthLimit - c_offloadPoint) * c_singleExecutionStackSize);
-    cnote << "Offloaded stack stack size = " << (c_depthLimit - c_offloadPoint) * c_singleExecutionStackSize << " c_depthLimit = " << c_depthLimit;
-
-    // Create new thread with big stack and join immediately.
-    // TODO: It is possible to switch the implementation to Boost.Context or similar when the API is stable.
-    boost::exception_ptr exception;
-    boost::thread{attrs, [&]{
-        try { _e.go(_onOp); }
-        catch (...) { exception = boost::current_exception(); } // Catch all exceptions to be rethrown in parent thread.
-    }}.join();
-    if (exception) boost::rethrow_exception(exception);
+/// Stack size of the offloaded execution, enough to handle the rest of the calls up to the limit.
+static size_t const c_offloadedStackSize = (c_depthLimit - c_offloadPoint) * c_singleExecutionStackSize;
+
+void goOnOffloadedStack(Executive& _e, OnOpFunc const& _onOp)
+{
+    // Switch to a big stack on the same thread. The stacks are pooled per thread, so after the
+    // first offloading no thread is created and no stack memory is mapped for the next ones.
+    static thread_local boost::context::pooled_fixedsize_stack s_stacks{c_offloadedStackSize};
+
+    std::exception_ptr exception;
+    boost::context::callcc(
+        std::allocator_arg, s_stacks, [&](boost::context::continuation&& _caller) {
+            try { _e.go(_onOp); }
+            catch (...) { exception = std::current_exception(); } // Catch all exceptions to be rethrown on the original stack.
+            return std::move(_caller);
+        });
+    if (exception) std::rethrow_exception(exception);
 }
 
 void go(unsigned _depth, Executive& _e, OnOpFunc const& _onOp) {
@@ -56,7 +60,7 @@ void go(unsigned _depth, Executive& _e, OnOpFunc const& _onOp) {
     // the rest of the calls up to the depth limit (c_depthLimit).
 
     if (_depth == c_offloadPoint) {
-        cnote << "Stack offloading (depth: " << c_offloadPoint << ")";
+        ctrace << "Stack offloading (depth: " << c_offloadPoint << ")";
         goOnOffloadedStack(_e, _onOp);
     }
     else
@@ -93,8 +97,72 @@ evmc_status_code transactionExceptionToEvmcStatusCode(TransactionException ex) n
     }
 }
 
+/// Storage of finished ExtVM frames kept by a thread for reuse.
+class FrameStorage
+{
+public:
+    ~FrameStorage()
+    {
+        for (void* p : m_free)
+            ::operator delete(p);
+    }
+
+    void* take()
+    {
+        if (m_free.empty())
+            return ::operator new(sizeof(ExtVM));
+        void* p = m_free.back();
+        m_free.pop_back();
+        return p;
+    }
+
+    void give(void* _p) noexcept
+    {
+        // The frames of a transaction never exceed the depth limit, keep one block for each.
+        if (m_free.size() > c_depthLimit)
+            ::operator delete(_p);
+        else
+        {
+            try
+            {
+                m_free.push_back(_p);
+            }
+            catch (...)
+            {
+                ::operator delete(_p);
+            }
+        }
+    }
+
+    static FrameStorage& local()
+    {
+        static thread_local FrameStorage s_storage;
+        return s_storage;
+    }
+
+private:
+    std::vector<void*> m_free;
+};
+
 } // anonymous namespace
 
+void* ExtVM::operator new(std::size_t _size)
+{
+    if (_size != sizeof(ExtVM))
+        return ::operator new(_size);
+    return FrameStorage::local().take();
+}
+
+void ExtVM::operator delete(void* _p, std::size_t _size) noexcept
+{
+    if (!_p)
+        return;
+    if (_size != sizeof(ExtVM))
+        ::operator delete(_p);
+    else
+        FrameStorage::local().give(_p);
+}
+
 
 CallResult ExtVM::call(CallParameters& _p)
 {
@@ -166,10 +234,7 @@ h256 ExtVM::blockHash(u256 _number)
     if (currentNumber < m_sealEngine.chainParams().experimentalForkBlock + 256)
     {
         h256 const parentHash = envInfo().header().parentHash();
-        h256s const lastHashes = envInfo().lastHashes().precedingHashes(parentHash);
-
-        assert(lastHashes.size() > (unsigned)(currentNumber - 1 - _number));
-        return lastHashes[(unsigned)(currentNumber - 1 - _number)];
+        return envInfo().lastHashes().precedingHash(parentHash, (unsigned)(currentNumber - 1 - _number));
     }
 
     u256 const nonce = m_s.getNonce(caller);
@@ -13,6 +13,7 @@
 
 #include <functional>
 #include <map>
+#include <memory>
 
 namespace dev
 {
@@ -29,9 +30,10 @@ public:
     ExtVM(State& _s, EnvInfo const& _envInfo, SealEngineFace const& _sealEngine, Address _myAddress,
         Address _caller, Address _origin, u256 _value, u256 _gasPrice, bytesConstRef _data,
         bytesConstRef _code, h256 const& _codeHash, u256 const& _version, unsigned _depth,
-        bool _isCreate, bool _staticCall)
-      : ExtVMFace(_envInfo, _myAddress, _caller, _origin, _value, _gasPrice, _data, _code.toBytes(),
+        bool _isCreate, bool _staticCall, std::shared_ptr<bytes const> _codeOwner = {})
+      : ExtVMFace(_envInfo, _myAddress, _caller, _origin, _value, _gasPrice, _data, _code,
             _codeHash, _version, _depth, _isCreate, _staticCall),
+        m_codeOwner(std::move(_codeOwner)),
         m_s(_s),
         m_sealEngine(_sealEngine),
         m_evmSchedule(initEvmSchedule(envInfo().number(), _version))
@@ -42,6 +44,11 @@ public:
         assert(m_s.addressInUse(_myAddress));
     }
 
+    /// Frames are created and destroyed in LIFO order by the thread executing the transaction, so
+    /// the storage of finished frames is kept by the thread for the next ones.
+    static void* operator new(std::size_t _size);
+    static void operator delete(void* _p, std::size_t _size) noexcept;
+
     /// Read storage location.
     u256 store(u256 _n) final { return m_s.storage(myAddress, _n); }
 
@@ -104,7 +111,9 @@ private:
             return latestScheduleForAccountVersion(_version);
     }
 
-
+    /// Keeps the code of a called account alive, as the state may drop the account from its cache
+    /// while the frame is running. Null if the code is owned by the caller.
+    std::shared_ptr<bytes const> m_codeOwner;
     State& m_s;  ///< A reference to the base state.
     SealEngineFace const& m_sealEngine;
     EVMSchedule const& m_evmSchedule;
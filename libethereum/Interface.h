@@ -83,7 +83,7 @@ public:
 	virtual ImportResult injectBlock(bytes const& _block) = 0;
 
 	/// Estimate gas usage for call/create.
-	/// @param _maxGas An upper bound value for estimation, if not provided default value of c_maxGasEstimate will be used.
+	/// @param _maxGas An upper bound value for estimation, if not provided the gas limit of calls will be used.
 	/// @param _callback Optional callback function for progress reporting
 	virtual std::pair<u256, ExecutionResult> estimateGas(Address const& _from, u256 _value, Address _dest, bytes const& _data, int64_t _maxGas, u256 _gasPrice, BlockNumber _blockNumber, GasEstimationCallback const& _callback = GasEstimationCallback()) = 0;
 
@@ -29,6 +29,14 @@ public:
 	/// i.e. result[0] is @a _mostRecentHash, result[1] is its parent, result[2] is grandparent etc.
 	virtual h256s precedingHashes(h256 const& _mostRecentHash) const = 0;
 
+	/// Get the hash of the block @a _distance generations before @a _mostRecentHash,
+	/// i.e. precedingHashes(_mostRecentHash)[_distance], or a null hash if there is none.
+	virtual h256 precedingHash(h256 const& _mostRecentHash, unsigned _distance) const
+	{
+		h256s const hashes = precedingHashes(_mostRecentHash);
+		return _distance < hashes.size() ? hashes[_distance] : h256();
+	}
+
 	/// Clear any cached result
 	virtual void clear() = 0;
 };
@@ -0,0 +1,107 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#include "LogFilterIndex.h"
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace
+{
+template <class Map, class Terms>
+void insertUnder(Map& _map, Terms const& _terms, h256 const& _id)
+{
+    for (auto const& term : _terms)
+        _map[term].insert(_id);
+}
+
+template <class Map, class Terms>
+void eraseFrom(Map& _map, Terms const& _terms, h256 const& _id)
+{
+    for (auto const& term : _terms)
+    {
+        auto const it = _map.find(term);
+        if (it == _map.end())
+            continue;
+        it->second.erase(_id);
+        if (it->second.empty())
+            _map.erase(it);
+    }
+}
+
+template <class Map, class Term>
+void addFound(Map const& _map, Term const& _term, h256Hash& o_ids)
+{
+    auto const it = _map.find(_term);
+    if (it != _map.end())
+        o_ids.insert(it->second.begin(), it->second.end());
+}
+}  // namespace
+
+LogFilterIndex::Key LogFilterIndex::keyOf(LogFilter const& _filter)
+{
+    if (!_filter.addresses().empty())
+        return Key::Addresses;
+
+    // The position with the fewest topics lets the fewest logs through. Of positions with as
+    // many topics, the last one is taken: topic 0 is the event signature, shared by all the
+    // events of a kind, while the later ones are mostly their arguments.
+    auto const& topics = _filter.topics();
+    Key ret = Key::Range;
+    size_t fewest = 0;
+    for (unsigned i = 0; i < topics.size(); ++i)
+        if (!topics[i].empty() && (ret == Key::Range || topics[i].size() <= fewest))
+        {
+            ret = static_cast<Key>(static_cast<unsigned>(Key::Topic0) + i);
+            fewest = topics[i].size();
+        }
+    return ret;
+}
+
+void LogFilterIndex::insert(h256 const& _id, LogFilter const& _filter)
+{
+    Key const key = keyOf(_filter);
+    if (key == Key::Addresses)
+        insertUnder(m_byAddress, _filter.addresses(), _id);
+    else if (key == Key::Range)
+        m_range.insert(_id);
+    else
+    {
+        unsigned const position = static_cast<unsigned>(key) - static_cast<unsigned>(Key::Topic0);
+        insertUnder(m_byTopic[position], _filter.topics()[position], _id);
+    }
+    ++m_size;
+}
+
+void LogFilterIndex::erase(h256 const& _id, LogFilter const& _filter)
+{
+    Key const key = keyOf(_filter);
+    if (key == Key::Addresses)
+        eraseFrom(m_byAddress, _filter.addresses(), _id);
+    else if (key == Key::Range)
+        m_range.erase(_id);
+    else
+    {
+        unsigned const position = static_cast<unsigned>(key) - static_cast<unsigned>(Key::Topic0);
+        eraseFrom(m_byTopic[position], _filter.topics()[position], _id);
+    }
+    --m_size;
+}
+
+h256Hash LogFilterIndex::candidates(TransactionReceipt const& _receipt) const
+{
+    h256Hash ret;
+    if (_receipt.log().empty())
+        return ret;
+
+    ret = m_range;
+    for (LogEntry const& log : _receipt.log())
+    {
+        addFound(m_byAddress, log.address, ret);
+        for (unsigned i = 0; i < min<size_t>(log.topics.size(), m_byTopic.size()); ++i)
+            addFound(m_byTopic[i], log.topics[i], ret);
+    }
+    return ret;
+}
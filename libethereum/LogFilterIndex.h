@@ -0,0 +1,58 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#pragma once
+
+#include "LogFilter.h"
+
+#include <array>
+#include <unordered_map>
+
+namespace dev
+{
+namespace eth
+{
+/**
+ * @brief Index of the installed filters by the addresses and topics they accept.
+ *
+ * Each filter is kept under the terms of one of its conditions: its addresses, or else the
+ * topics of its most selective position, the last of those with the fewest topics. A log
+ * matching the filter must have one of these terms, so looking the terms of the log up gives
+ * every filter which may match it, and only those have to be tested. Range filters match every
+ * log and are always given.
+ */
+class LogFilterIndex
+{
+public:
+    void insert(h256 const& _id, LogFilter const& _filter);
+    void erase(h256 const& _id, LogFilter const& _filter);
+
+    /// @returns the ids of the filters which may match a log of the receipt. Any filter matching
+    /// one is among them.
+    h256Hash candidates(TransactionReceipt const& _receipt) const;
+
+    /// @returns the number of the filters indexed.
+    size_t size() const { return m_size; }
+
+private:
+    /// The condition a filter is kept under.
+    enum class Key
+    {
+        Addresses,
+        Topic0,
+        Topic1,
+        Topic2,
+        Topic3,
+        Range
+    };
+    static Key keyOf(LogFilter const& _filter);
+
+    std::unordered_map<Address, h256Hash> m_byAddress;
+    std::array<std::unordered_map<h256, h256Hash>, 4> m_byTopic;
+    h256Hash m_range;  ///< The range filters.
+    size_t m_size = 0;
+};
+
+}  // namespace eth
+}  // namespace dev
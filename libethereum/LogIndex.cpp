@@ -0,0 +1,259 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#include "LogIndex.h"
+#include "BlockChain.h"
+
+#include <libdevcore/SHA3.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace
+{
+bool g_enabled = false;
+
+std::string const c_firstBlock{"logIndexStart"};
+db::Slice const c_sliceFirstBlock{c_firstBlock};
+
+/// The tags of the encodings of a chunk.
+enum : byte
+{
+    ArrayChunk = 0,
+    BitmapChunk = 1
+};
+
+/// The size of the bitmap of a chunk in bytes, the largest encoding of a chunk.
+constexpr size_t c_bitmapSize = LogIndexChunk::c_blocks / 8;
+
+/// A bitmap of the blocks of a chunk.
+using ChunkBits = vector<uint64_t>;
+
+void addTo(ChunkBits& _bits, LogIndexChunk const& _chunk)
+{
+    for (auto const offset : _chunk.offsets())
+        _bits[offset / 64] |= uint64_t(1) << (offset % 64);
+}
+}  // namespace
+
+constexpr unsigned LogIndexChunk::c_blocks;
+
+bool dev::eth::isLogIndexEnabled()
+{
+    return g_enabled;
+}
+
+void dev::eth::setLogIndexEnabled(bool _enabled)
+{
+    g_enabled = _enabled;
+}
+
+LogIndexChunk::LogIndexChunk(bytesConstRef _data)
+{
+    if (_data.empty())
+        return;
+
+    if (_data[0] == BitmapChunk && _data.size() == 1 + c_bitmapSize)
+    {
+        for (unsigned i = 0; i < c_bitmapSize; ++i)
+            for (unsigned bit = 0; bit < 8; ++bit)
+                if (_data[1 + i] & (1 << bit))
+                    m_offsets.push_back(static_cast<uint16_t>(i * 8 + bit));
+    }
+    else if (_data[0] == ArrayChunk && _data.size() % 2 == 1)
+    {
+        m_offsets.reserve(_data.size() / 2);
+        for (size_t i = 1; i < _data.size(); i += 2)
+            m_offsets.push_back(static_cast<uint16_t>((_data[i] << 8) | _data[i + 1]));
+    }
+    else
+        BOOST_THROW_EXCEPTION(BadRLP());
+}
+
+bytes LogIndexChunk::encode() const
+{
+    bytes ret;
+    if (m_offsets.size() * 2 < c_bitmapSize)
+    {
+        ret.reserve(1 + m_offsets.size() * 2);
+        ret.push_back(ArrayChunk);
+        for (auto const offset : m_offsets)
+        {
+            ret.push_back(static_cast<byte>(offset >> 8));
+            ret.push_back(static_cast<byte>(offset));
+        }
+    }
+    else
+    {
+        ret.resize(1 + c_bitmapSize);
+        ret[0] = BitmapChunk;
+        for (auto const offset : m_offsets)
+            ret[1 + offset / 8] |= static_cast<byte>(1 << (offset % 8));
+    }
+    return ret;
+}
+
+void LogIndexChunk::insert(unsigned _offset)
+{
+    assert(_offset < c_blocks);
+    // Blocks are mostly added at the end of the chunk.
+    if (m_offsets.empty() || m_offsets.back() < _offset)
+    {
+        m_offsets.push_back(static_cast<uint16_t>(_offset));
+        return;
+    }
+    auto const it = lower_bound(m_offsets.begin(), m_offsets.end(), _offset);
+    if (*it != _offset)
+        m_offsets.insert(it, static_cast<uint16_t>(_offset));
+}
+
+void LogIndexChunk::erase(unsigned _offset)
+{
+    auto const it = lower_bound(m_offsets.begin(), m_offsets.end(), _offset);
+    if (it != m_offsets.end() && *it == _offset)
+        m_offsets.erase(it);
+}
+
+LogIndex::LogIndex(db::DatabaseFace& _extrasDB, unsigned _nextBlock, size_t _cacheBudget)
+  : m_extrasDB(_extrasDB),
+    m_chunks(_cacheBudget, [](Chunk const& _c) { return _c->offsets().size() * 2 + 64; })
+{
+    string const firstBlock = m_extrasDB.lookup(c_sliceFirstBlock);
+    if (firstBlock.empty())
+    {
+        m_firstBlock = _nextBlock;
+        bytes const value = rlp(m_firstBlock);
+        m_extrasDB.insert(c_sliceFirstBlock, db::Slice(reinterpret_cast<char const*>(value.data()), value.size()));
+    }
+    else
+        m_firstBlock = RLP(firstBlock).toInt<unsigned>();
+}
+
+void LogIndex::forget(db::DatabaseFace& _extrasDB)
+{
+    _extrasDB.kill(c_sliceFirstBlock);
+}
+
+h256 LogIndex::chunkKey(unsigned _position, bytesConstRef _term, unsigned _chunk)
+{
+    bytes key;
+    key.reserve(1 + _term.size() + 4);
+    key.push_back(static_cast<byte>(_position));
+    key.insert(key.end(), _term.begin(), _term.end());
+    for (unsigned i = 4; i-- > 0;)
+        key.push_back(static_cast<byte>(_chunk >> (i * 8)));
+    return sha3(key);
+}
+
+LogIndex::Chunk LogIndex::chunk(h256 const& _key) const
+{
+    if (auto cached = m_chunks.find(_key))
+        return *cached;
+
+    string const s = m_extrasDB.lookup(toSlice(_key, ExtraLogIndex));
+    return m_chunks.emplace(_key, make_shared<LogIndexChunk const>(bytesConstRef(s)));
+}
+
+LogIndex::ChunkChanges LogIndex::update(db::WriteBatchFace& _batch,
+    vector<NumberedReceipts> const& _removed, vector<NumberedReceipts> const& _added)
+{
+    map<h256, shared_ptr<LogIndexChunk>> changed;
+    auto const apply = [&](NumberedReceipts const& _block, bool _add) {
+        unsigned const chunkNumber = _block.first / LogIndexChunk::c_blocks;
+        unsigned const offset = _block.first % LogIndexChunk::c_blocks;
+
+        set<h256> keys;
+        for (auto const& receipt : _block.second)
+            for (auto const& log : receipt.log())
+            {
+                keys.insert(chunkKey(0, log.address.ref(), chunkNumber));
+                for (unsigned i = 0; i < min<size_t>(log.topics.size(), 4); ++i)
+                    keys.insert(chunkKey(i + 1, log.topics[i].ref(), chunkNumber));
+            }
+
+        for (auto const& key : keys)
+        {
+            auto& c = changed[key];
+            if (!c)
+                c = make_shared<LogIndexChunk>(*chunk(key));
+            if (_add)
+                c->insert(offset);
+            else
+                c->erase(offset);
+        }
+    };
+
+    // The blocks are removed first, as the added ones may have the same numbers.
+    for (auto const& block : _removed)
+        apply(block, false);
+    for (auto const& block : _added)
+        apply(block, true);
+
+    ChunkChanges ret;
+    for (auto const& c : changed)
+    {
+        if (c.second->empty())
+            _batch.kill(toSlice(c.first, ExtraLogIndex));
+        else
+        {
+            bytes const encoded = c.second->encode();
+            _batch.insert(toSlice(c.first, ExtraLogIndex), db::Slice(reinterpret_cast<char const*>(encoded.data()), encoded.size()));
+        }
+        ret.emplace(c.first, c.second);
+    }
+    return ret;
+}
+
+void LogIndex::noteCommitted(ChunkChanges const& _changes)
+{
+    for (auto const& c : _changes)
+        m_chunks.insert(c.first, c.second);
+}
+
+vector<unsigned> LogIndex::matchingBlocks(AddressHash const& _addresses,
+    array<h256Hash, 4> const& _topics, unsigned _earliest, unsigned _latest) const
+{
+    assert(_earliest >= m_firstBlock);
+
+    vector<unsigned> ret;
+    for (unsigned chunkNumber = _earliest / LogIndexChunk::c_blocks;
+         chunkNumber <= _latest / LogIndexChunk::c_blocks; ++chunkNumber)
+    {
+        // The blocks having one of the terms of each of the positions given.
+        ChunkBits matching(LogIndexChunk::c_blocks / 64, ~uint64_t(0));
+        auto const intersect = [&](ChunkBits const& _bits) {
+            for (size_t i = 0; i < matching.size(); ++i)
+                matching[i] &= _bits[i];
+        };
+
+        if (!_addresses.empty())
+        {
+            ChunkBits bits(matching.size());
+            for (auto const& address : _addresses)
+                addTo(bits, *chunk(chunkKey(0, address.ref(), chunkNumber)));
+            intersect(bits);
+        }
+        for (unsigned i = 0; i < _topics.size(); ++i)
+            if (!_topics[i].empty())
+            {
+                ChunkBits bits(matching.size());
+                for (auto const& topic : _topics[i])
+                    addTo(bits, *chunk(chunkKey(i + 1, topic.ref(), chunkNumber)));
+                intersect(bits);
+            }
+
+        unsigned const chunkBegin = chunkNumber * LogIndexChunk::c_blocks;
+        unsigned const first = max(_earliest, chunkBegin) - chunkBegin;
+        unsigned const last = min<uint64_t>(_latest, chunkBegin + LogIndexChunk::c_blocks - 1) - chunkBegin;
+        for (unsigned offset = first; offset <= last; ++offset)
+            if (matching[offset / 64] & (uint64_t(1) << (offset % 64)))
+                ret.push_back(chunkBegin + offset);
+    }
+    return ret;
+}
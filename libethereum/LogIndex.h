@@ -0,0 +1,111 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#pragma once
+
+#include "TransactionReceipt.h"
+#include <libdevcore/ShardedLruCache.h>
+#include <libdevcore/db.h>
+
+#include <array>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace dev
+{
+namespace eth
+{
+/// @returns true if new BlockChain objects keep a log index.
+bool isLogIndexEnabled();
+void setLogIndexEnabled(bool _enabled);
+
+/**
+ * @brief The blocks of one chunk of the chain having logs with some address or topic.
+ *
+ * Kept like a roaring bitmap container: a sorted array of the offsets of the blocks in the chunk
+ * while they are few, a bitmap of the whole chunk once that is smaller.
+ */
+class LogIndexChunk
+{
+public:
+    /// The number of blocks in a chunk.
+    static constexpr unsigned c_blocks = 65536;
+
+    LogIndexChunk() = default;
+    explicit LogIndexChunk(bytesConstRef _data);
+
+    bytes encode() const;
+
+    bool empty() const { return m_offsets.empty(); }
+    void insert(unsigned _offset);
+    void erase(unsigned _offset);
+
+    /// The offsets of the blocks in the chunk in ascending order.
+    std::vector<uint16_t> const& offsets() const { return m_offsets; }
+
+private:
+    std::vector<uint16_t> m_offsets;
+};
+
+/// A block of the canonical chain with its receipts.
+using NumberedReceipts = std::pair<unsigned, TransactionReceipts>;
+
+/**
+ * @brief Inverted index of the logs of the canonical chain, kept in the extras DB.
+ *
+ * It maps every log address, and every topic at its position, to the chunks of the chain having
+ * blocks with such logs. It is updated along with the extras when the canonical chain changes, so
+ * it has all the blocks from firstBlock() on, and at worst some blocks no longer having the logs.
+ */
+class LogIndex
+{
+public:
+    using Chunk = std::shared_ptr<LogIndexChunk const>;
+    /// The chunks written by update(), by key.
+    using ChunkChanges = std::map<h256, Chunk>;
+
+    /// Opens the index kept in @a _extrasDB, starting it with the next block, @a _nextBlock, if
+    /// the database has none.
+    LogIndex(db::DatabaseFace& _extrasDB, unsigned _nextBlock, size_t _cacheBudget);
+
+    /// Drops the marker of the index kept in @a _extrasDB, so that the index starts again from
+    /// the head of the chain when enabled next time.
+    static void forget(db::DatabaseFace& _extrasDB);
+
+    /// The number of the first block of the index.
+    unsigned firstBlock() const { return m_firstBlock; }
+
+    /// Writes the changes of the canonical chain to @a _batch: the logs of the blocks @a _removed
+    /// from the chain are dropped from the index and those of the blocks @a _added are indexed.
+    /// @returns the chunks written, to be passed to noteCommitted() once @a _batch is committed.
+    ChunkChanges update(db::WriteBatchFace& _batch, std::vector<NumberedReceipts> const& _removed,
+        std::vector<NumberedReceipts> const& _added);
+
+    /// Caches the chunks written by update() to a batch that has been committed. Until then,
+    /// the index reads the chunks of the database.
+    void noteCommitted(ChunkChanges const& _changes);
+
+    /// @returns the numbers, in ascending order, of the blocks between @a _earliest and
+    /// @a _latest which may have logs with one of the addresses, if any, and for each of the
+    /// topic positions, one of its topics, if any. The range must start at firstBlock() or later.
+    std::vector<unsigned> matchingBlocks(AddressHash const& _addresses,
+        std::array<h256Hash, 4> const& _topics, unsigned _earliest, unsigned _latest) const;
+
+    LruCacheStats cacheStats() const { return m_chunks.stats(); }
+
+private:
+    /// @returns the key of the chunk of a term: the address (position 0) or a topic
+    /// (positions 1 to 4) of a log.
+    static h256 chunkKey(unsigned _position, bytesConstRef _term, unsigned _chunk);
+
+    Chunk chunk(h256 const& _key) const;
+
+    db::DatabaseFace& m_extrasDB;
+    unsigned m_firstBlock = 0;
+    mutable ShardedLruCache<h256, Chunk> m_chunks;
+};
+
+}  // namespace eth
+}  // namespace dev
@@ -0,0 +1,139 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#include "LogScanPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+constexpr size_t LogScanPool::c_chunkBlocks;
+
+struct LogScanPool::Query
+{
+    Query(vector<unsigned> const& _blocks, BlockScanner const& _scanner, size_t _maxResults,
+        chrono::steady_clock::time_point _deadline)
+      : blocks(_blocks),
+        scanner(_scanner),
+        maxResults(_maxResults),
+        deadline(_deadline),
+        results((_blocks.size() + c_chunkBlocks - 1) / c_chunkBlocks)
+    {}
+
+    void fail(exception_ptr _error)
+    {
+        Guard l(x_query);
+        if (!error)
+            error = _error;
+        stopped = true;
+    }
+
+    vector<unsigned> const& blocks;
+    BlockScanner const& scanner;
+    size_t const maxResults;
+    chrono::steady_clock::time_point const deadline;
+
+    atomic<size_t> nextChunk{0};
+    atomic<size_t> found{0};
+    atomic<bool> stopped{false};
+    vector<LocalisedLogEntries> results;  ///< The logs of each chunk.
+
+    Mutex x_query;
+    condition_variable helpersChanged;
+    unsigned helpers = 0;  ///< The number of workers scanning chunks of the query.
+    bool closed = false;   ///< Whether the querying thread is done with the query.
+    exception_ptr error;
+};
+
+void LogScanPool::scan(vector<unsigned> const& _blocks, BlockScanner const& _scanner,
+    size_t _maxResults, chrono::steady_clock::time_point _deadline, LocalisedLogEntries& io_logs)
+{
+    if (_blocks.empty())
+        return;
+
+    auto const query = make_shared<Query>(_blocks, _scanner, _maxResults, _deadline);
+    // The logs given count towards the limit.
+    query->found = io_logs.size();
+    size_t const helpers = min<size_t>(m_pool.threads(), query->results.size() - 1);
+    for (size_t i = 0; i < helpers; ++i)
+        m_pool.post([query] { help(*query); });
+
+    scanChunks(*query);
+
+    // Close the query to the workers which have not started on it, and wait for those still
+    // scanning, as the query refers to the caller's data.
+    {
+        unique_lock<Mutex> l(query->x_query);
+        query->closed = true;
+        query->helpersChanged.wait(l, [&] { return query->helpers == 0; });
+    }
+
+    if (query->error)
+        rethrow_exception(query->error);
+
+    size_t total = io_logs.size();
+    for (auto const& logs : query->results)
+        total += logs.size();
+    io_logs.reserve(total);
+    for (auto& logs : query->results)
+        io_logs.insert(io_logs.end(), make_move_iterator(logs.begin()), make_move_iterator(logs.end()));
+}
+
+void LogScanPool::scanChunks(Query& _query)
+{
+    while (!_query.stopped)
+    {
+        size_t const chunk = _query.nextChunk++;
+        if (chunk >= _query.results.size())
+            return;
+
+        try
+        {
+            LocalisedLogEntries& logs = _query.results[chunk];
+            size_t const end = min(_query.blocks.size(), (chunk + 1) * c_chunkBlocks);
+            for (size_t i = chunk * c_chunkBlocks; i < end && !_query.stopped; ++i)
+            {
+                if (chrono::steady_clock::now() > _query.deadline)
+                    BOOST_THROW_EXCEPTION(LogQueryTimeout());
+                _query.scanner(_query.blocks[i], logs);
+                if (_query.maxResults && _query.found + logs.size() > _query.maxResults)
+                    BOOST_THROW_EXCEPTION(TooManyLogs());
+            }
+            _query.found += logs.size();
+        }
+        catch (...)
+        {
+            _query.fail(current_exception());
+        }
+    }
+}
+
+void LogScanPool::help(Query& _query)
+{
+    DEV_GUARDED(_query.x_query)
+    {
+        if (_query.closed)
+            return;
+        ++_query.helpers;
+    }
+
+    scanChunks(_query);
+
+    DEV_GUARDED(_query.x_query)
+        --_query.helpers;
+    _query.helpersChanged.notify_all();
+}
+
+chrono::steady_clock::time_point dev::eth::logQueryDeadline(LogQueryLimits const& _limits)
+{
+    if (_limits.time.count() <= 0)
+        return chrono::steady_clock::time_point::max();
+    return chrono::steady_clock::now() + _limits.time;
+}
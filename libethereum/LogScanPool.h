@@ -0,0 +1,84 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#pragma once
+
+#include <libdevcore/Exceptions.h>
+#include <libdevcore/ThreadPool.h>
+#include <libethcore/LogEntry.h>
+
+#include <chrono>
+#include <functional>
+#include <vector>
+
+namespace dev
+{
+namespace eth
+{
+DEV_SIMPLE_EXCEPTION(TooManyLogs);
+DEV_SIMPLE_EXCEPTION(LogQueryTimeout);
+
+/// Limits on the log queries.
+struct LogQueryLimits
+{
+    /// Maximum number of logs a query returns. Zero disables the limit.
+    size_t maxResults = 10000;
+    /// Wall-clock budget of a query. Zero disables the limit.
+    std::chrono::milliseconds time{10000};
+};
+
+/**
+ * @brief Pool of threads scanning the blocks of log queries.
+ *
+ * The blocks of a query are split into chunks, which the workers and the querying thread take
+ * in turn. The logs of each chunk are kept apart and merged in the order of the blocks once all
+ * are scanned, so the result is the same as that of scanning the blocks one after another.
+ */
+class LogScanPool
+{
+public:
+    /// Appends the matching logs of the block with the number to the entries, in their order.
+    using BlockScanner = std::function<void(unsigned, LocalisedLogEntries&)>;
+
+    /// The number of blocks a thread takes at once.
+    static constexpr size_t c_chunkBlocks = 64;
+
+    /// @param _threads  Number of worker threads, the hardware concurrency if 0.
+    explicit LogScanPool(unsigned _threads = 0) : m_pool("logscan", _threads) {}
+
+    LogScanPool(LogScanPool const&) = delete;
+    LogScanPool& operator=(LogScanPool const&) = delete;
+
+    static LogScanPool& instance()
+    {
+        static LogScanPool s_pool;
+        return s_pool;
+    }
+
+    /// Scans the blocks and appends their logs to @a io_logs in the order of @a _blocks.
+    /// @throws TooManyLogs as soon as @a io_logs would have more than @a _maxResults logs, if it
+    /// is not zero.
+    /// @throws LogQueryTimeout if the scan is not done by @a _deadline.
+    void scan(std::vector<unsigned> const& _blocks, BlockScanner const& _scanner,
+        size_t _maxResults, std::chrono::steady_clock::time_point _deadline,
+        LocalisedLogEntries& io_logs);
+
+    unsigned threads() const { return m_pool.threads(); }
+
+private:
+    struct Query;
+
+    /// Scans chunks of the query until none is left or the query is stopped.
+    static void scanChunks(Query& _query);
+    /// Scans chunks of the query on a worker, unless the querying thread is done with it.
+    static void help(Query& _query);
+
+    ThreadPool m_pool;
+};
+
+/// @returns the deadline of a log query starting now under @a _limits.
+std::chrono::steady_clock::time_point logQueryDeadline(LogQueryLimits const& _limits);
+
+}  // namespace eth
+}  // namespace dev
@@ -0,0 +1,148 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#include "ReadView.h"
+#include "Block.h"
+#include <libdevcore/ThreadPool.h>
+#include <libevm/VMFace.h>
+#include <algorithm>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace
+{
+/// Number of VM steps between the checks of the deadline.
+constexpr uint64_t c_deadlineCheckInterval = 1024;
+
+/// Number of gas limits probed concurrently in a round of gas estimation.
+constexpr int64_t c_estimationProbes = 4;
+
+/// @returns true if the execution failed for the lack of gas, so that it would need more.
+bool outOfGas(ExecutionResult const& _er)
+{
+    return _er.excepted == TransactionException::OutOfGas ||
+           _er.excepted == TransactionException::OutOfGasBase ||
+           _er.excepted == TransactionException::OutOfGasIntrinsic ||
+           _er.codeDeposit == CodeDeposit::Failed ||
+           _er.excepted == TransactionException::BadJumpDestination;
+}
+
+/// Threads shared by all gas estimations to run their probes, so that concurrent estimations add
+/// at most a fixed number of threads to those of their callers.
+ThreadPool& probePool()
+{
+    static ThreadPool s_pool{"estimate"};
+    return s_pool;
+}
+}  // namespace
+
+ReadView::ReadView(Block const& _block)
+  : ReadView(_block.info(), _block.gasUsed(), _block.stateBeforeRewards())
+{}
+
+ExecutionResult ReadView::execute(EnvInfo const& _env, SealEngineFace const& _sealEngine,
+    Transaction const& _t, u256 const& _extraBalance,
+    chrono::steady_clock::time_point _deadline) const
+{
+    State state = m_state;
+    if (_extraBalance)
+        state.addBalance(_t.sender(), _extraBalance);
+
+    // The steps are counted across all the frames of the call, as each VM counts its own.
+    uint64_t steps = 0;
+    OnOpFunc onOp;
+    if (_deadline != chrono::steady_clock::time_point::max())
+        onOp = [_deadline, &steps](uint64_t, uint64_t, Instruction, bigint, bigint, bigint,
+                   VMFace const*, ExtVMFace const*) {
+            if (++steps % c_deadlineCheckInterval == 0 && chrono::steady_clock::now() > _deadline)
+                BOOST_THROW_EXCEPTION(ExecutionTimeout());
+        };
+
+    try
+    {
+        return state.execute(_env, _sealEngine, _t, Permanence::Reverted, onOp).first;
+    }
+    catch (ExecutionTimeout const&)
+    {
+        ExecutionResult ret;
+        ret.excepted = TransactionException::ExecutionTimeout;
+        return ret;
+    }
+}
+
+pair<u256, ExecutionResult> ReadView::estimateGas(LastBlockHashesFace const& _lh,
+    SealEngineFace const& _sealEngine, function<Transaction(int64_t)> const& _transactionWithGas,
+    int64_t _lowerBound, int64_t _upperBound, chrono::steady_clock::time_point _deadline,
+    GasEstimationCallback const& _callback) const
+{
+    auto const probe = [&](int64_t _gas) {
+        Transaction const t = _transactionWithGas(_gas);
+        EnvInfo const env{m_info, _lh, 0, _gas, _sealEngine.chainParams().chainID};
+        return execute(env, _sealEngine, t, t.gas() * t.gasPrice() + t.value(), _deadline);
+    };
+
+    // Execute once with all the gas available to learn how much the transaction consumes.
+    ExecutionResult best = probe(_upperBound);
+    if (best.excepted == TransactionException::ExecutionTimeout || outOfGas(best))
+        return {_upperBound, move(best)};
+
+    // The search keeps a gas limit known to succeed and one known to fail below it. Nothing
+    // below the gas used after refunds can succeed.
+    int64_t good = _upperBound;
+    int64_t bad = max<int64_t>(_lowerBound, static_cast<int64_t>(best.gasUsed)) - 1;
+
+    // Most transactions need the gas consumed before refunds, or a bit more when they make calls
+    // that must retain 1/64 of the gas. Try these first.
+    int64_t const consumed = static_cast<int64_t>(best.gasUsed + best.gasRefunded);
+    vector<int64_t> probes{consumed, consumed + min(consumed / 63, good - consumed)};
+
+    while (good - bad > 1)
+    {
+        probes.erase(remove_if(probes.begin(), probes.end(),
+                         [&](int64_t _gas) { return _gas <= bad || _gas >= good; }),
+            probes.end());
+        if (probes.empty())
+        {
+            int64_t const span = good - bad;
+            int64_t const count = min(c_estimationProbes, span - 1);
+            // Divided first, as the span may be as large as the configured gas limit.
+            for (int64_t i = 1; i <= count; ++i)
+                probes.push_back(bad + span / (count + 1) * i + span % (count + 1) * i / (count + 1));
+        }
+        sort(probes.begin(), probes.end());
+
+        vector<ExecutionResult> results(probes.size());
+        vector<function<void()>> jobs;
+        for (size_t i = 0; i < probes.size(); ++i)
+            jobs.push_back([&, i] { results[i] = probe(probes[i]); });
+        probePool().runAll(jobs);
+
+        for (size_t i = 0; i < probes.size(); ++i)
+        {
+            if (results[i].excepted == TransactionException::ExecutionTimeout)
+                return {_upperBound, move(results[i])};
+            if (!outOfGas(results[i]))
+            {
+                good = probes[i];
+                best = move(results[i]);
+                break;
+            }
+            bad = probes[i];
+        }
+
+        if (_callback)
+            _callback(GasEstimationProgress{bad, good});
+        probes.clear();
+    }
+    return {good, best};
+}
+
+chrono::steady_clock::time_point dev::eth::callDeadline(CallLimits const& _limits)
+{
+    if (_limits.time.count() <= 0)
+        return chrono::steady_clock::time_point::max();
+    return chrono::steady_clock::now() + _limits.time;
+}
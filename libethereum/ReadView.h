@@ -0,0 +1,85 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#pragma once
+
+#include "Interface.h"
+#include "State.h"
+#include <libethcore/BlockHeader.h>
+#include <chrono>
+
+namespace dev
+{
+namespace eth
+{
+class Block;
+
+/// Limits on the calls and gas estimations executed on read views.
+struct CallLimits
+{
+    /// Gas cap of a single call. Also the upper bound of gas estimation.
+    u256 gas = 50000000;
+    /// Wall-clock budget of a call or of a whole gas estimation. Zero disables the limit.
+    std::chrono::milliseconds time{5000};
+};
+
+/**
+ * @brief Read-only state pinned to a block, for calls that are not recorded.
+ *
+ * A view is immutable once created, so a single instance serves any number of concurrent calls.
+ * Each execution works on a private copy of the state, which costs O(1) as the view shares the
+ * caches of its state when it is created.
+ */
+class ReadView
+{
+public:
+    /// Pins the state of @a _block before the rewards, as seen by transactions executed in it.
+    explicit ReadView(Block const& _block);
+    ReadView(BlockHeader const& _info, u256 const& _gasUsed, State const& _state)
+      : m_info(_info), m_gasUsed(_gasUsed), m_state(_state)
+    {
+        m_state.shareCaches();
+    }
+
+    BlockHeader const& info() const { return m_info; }
+    u256 const& gasUsed() const { return m_gasUsed; }
+
+    /// @returns a private copy of the state.
+    State state() const { return m_state; }
+
+    /// Executes the transaction on a private copy of the state, discarding its changes.
+    /// @param _extraBalance  Added to the sender's balance before the execution.
+    /// @param _deadline  The execution fails with TransactionException::ExecutionTimeout
+    /// once it is passed.
+    ExecutionResult execute(EnvInfo const& _env, SealEngineFace const& _sealEngine,
+        Transaction const& _t, u256 const& _extraBalance = 0,
+        std::chrono::steady_clock::time_point _deadline =
+            std::chrono::steady_clock::time_point::max()) const;
+
+    /// Finds the lowest gas limit in [@a _lowerBound, @a _upperBound] with which the transaction
+    /// does not run out of gas. The transaction is first executed with @a _upperBound to learn
+    /// the gas it consumes, then several gas limits are probed concurrently in each round, on
+    /// threads shared by all estimations.
+    /// @param _transactionWithGas  Builds the transaction with the given gas limit.
+    /// @returns the gas limit and the result of the execution with it, or @a _upperBound and
+    /// the failed result if even that is not enough or if @a _deadline passes, in which case
+    /// the result is excepted with TransactionException::ExecutionTimeout.
+    std::pair<u256, ExecutionResult> estimateGas(LastBlockHashesFace const& _lh,
+        SealEngineFace const& _sealEngine,
+        std::function<Transaction(int64_t)> const& _transactionWithGas, int64_t _lowerBound,
+        int64_t _upperBound,
+        std::chrono::steady_clock::time_point _deadline = std::chrono::steady_clock::time_point::max(),
+        GasEstimationCallback const& _callback = GasEstimationCallback()) const;
+
+private:
+    BlockHeader m_info;
+    u256 m_gasUsed;
+    State m_state;
+};
+
+/// @returns the deadline of a call starting now under @a _limits.
+std::chrono::steady_clock::time_point callDeadline(CallLimits const& _limits);
+
+}  // namespace eth
+}  // namespace dev
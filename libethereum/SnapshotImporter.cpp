@@ -5,19 +5,122 @@
 #include "SnapshotImporter.h"
 #include "Client.h"
 #include "SnapshotStorage.h"
+#include "StateImporter.h"
 
 #include <libdevcore/FileSystem.h>
+#include <libdevcore/OrderedParallel.h>
 #include <libdevcore/RLP.h>
 #include <libdevcore/TrieHash.h>
 #include <libethashseal/Ethash.h>
 
 #include <snappy.h>
 
+#include <chrono>
+#include <thread>
+
 namespace dev
 {
 namespace eth
 {
 
+namespace
+{
+/// An account record of a state chunk, decoded and checked apart from the state.
+struct SnapshotAccount
+{
+    h256 addressHash;
+    u256 nonce;
+    u256 balance;
+    /// The storage of the record, kept only for the first record of the chunk, which may continue
+    /// an account of the previous chunk.
+    std::map<h256, bytes> storage;
+    StorageTrie storageTrie;
+    byte codeFlag = 0;
+    bytes code;
+    h256 codeHash;
+};
+
+struct StateChunk
+{
+    std::vector<SnapshotAccount> accounts;
+    size_t size = 0;  ///< The size of the chunk uncompressed.
+};
+
+StateChunk decodeStateChunk(std::string const& _chunkUncompressed)
+{
+    StateChunk ret;
+    ret.size = _chunkUncompressed.size();
+
+    RLP const accounts(_chunkUncompressed);
+    size_t const accountCount = accounts.itemCount();
+    ret.accounts.resize(accountCount);
+    for (size_t accountIndex = 0; accountIndex < accountCount; ++accountIndex)
+    {
+        SnapshotAccount& decoded = ret.accounts[accountIndex];
+        RLP const addressAndAccount = accounts[accountIndex];
+        if (addressAndAccount.itemCount() != 2)
+            BOOST_THROW_EXCEPTION(InvalidStateChunkData());
+
+        decoded.addressHash = addressAndAccount[0].toHash<h256>(RLP::VeryStrict);
+        if (!decoded.addressHash)
+            BOOST_THROW_EXCEPTION(InvalidStateChunkData());
+
+        RLP const account = addressAndAccount[1];
+        if (account.itemCount() != 5)
+            BOOST_THROW_EXCEPTION(InvalidStateChunkData());
+
+        decoded.nonce = account[0].toInt<u256>(RLP::VeryStrict);
+        decoded.balance = account[1].toInt<u256>(RLP::VeryStrict);
+
+        RLP const storage = account[4];
+        for (auto hashAndValue: storage)
+        {
+            if (hashAndValue.itemCount() != 2)
+                BOOST_THROW_EXCEPTION(InvalidStateChunkData());
+
+            h256 const keyHash = hashAndValue[0].toHash<h256>(RLP::VeryStrict);
+            if (!keyHash || decoded.storage.find(keyHash) != decoded.storage.end())
+                BOOST_THROW_EXCEPTION(InvalidStateChunkData());
+
+            bytes value = hashAndValue[1].toBytes(RLP::VeryStrict);
+            if (value.empty())
+                BOOST_THROW_EXCEPTION(InvalidStateChunkData());
+
+            decoded.storage.emplace(keyHash, std::move(value));
+        }
+        decoded.storageTrie = decoded.storage.empty() ? StorageTrie{EmptyTrie, {}} : buildStorageTrie(decoded.storage);
+        if (accountIndex > 0)
+            std::map<h256, bytes>().swap(decoded.storage);
+
+        decoded.codeFlag = account[2].toInt<byte>(RLP::VeryStrict);
+        switch (decoded.codeFlag)
+        {
+        case 0:
+            decoded.codeHash = EmptySHA3;
+            break;
+        case 1:
+            decoded.code = account[3].toBytes(RLP::VeryStrict);
+            decoded.codeHash = sha3(decoded.code);
+            break;
+        case 2:
+            decoded.codeHash = account[3].toHash<h256>(RLP::VeryStrict);
+            if (!decoded.codeHash)
+                BOOST_THROW_EXCEPTION(InvalidStateChunkData());
+            break;
+        default:
+            BOOST_THROW_EXCEPTION(InvalidStateChunkData());
+        }
+    }
+    return ret;
+}
+}  // namespace
+
+SnapshotImporter::SnapshotImporter(StateImporterFace& _stateImporter, BlockChainImporterFace& _bcImporter, unsigned _threads)
+  : m_stateImporter(_stateImporter),
+    m_blockChainImporter(_bcImporter),
+    m_threads(_threads ? _threads : std::max(std::thread::hardware_concurrency(), 1u))
+{}
+
 void SnapshotImporter::import(SnapshotStorageFace const& _snapshotStorage, h256 const& /*_genesisHash*/)
 {
     bytes const manifestBytes = _snapshotStorage.readManifest();
@@ -48,85 +151,56 @@ void SnapshotImporter::importStateChunks(SnapshotStorageFace const& _snapshotSto
 
     size_t chunksImported = 0;
     size_t accountsImported = 0;
-
-    for (auto const& stateChunkHash: _stateChunkHashes)
-    {
-        std::string const chunkUncompressed = _snapshotStorage.readChunk(stateChunkHash);
-
-        RLP const accounts(chunkUncompressed);
-        size_t const accountCount = accounts.itemCount();
-        for (size_t accountIndex = 0; accountIndex < accountCount; ++accountIndex)
-        {
-            RLP const addressAndAccount = accounts[accountIndex];
-            if (addressAndAccount.itemCount() != 2)
-                BOOST_THROW_EXCEPTION(InvalidStateChunkData());
-
-            h256 const addressHash = addressAndAccount[0].toHash<h256>(RLP::VeryStrict);
-            if (!addressHash)
-                BOOST_THROW_EXCEPTION(InvalidStateChunkData());
-
-            // splitted parts of account can be only first in chunk
-            if (accountIndex > 0 && m_stateImporter.isAccountImported(addressHash))
-                BOOST_THROW_EXCEPTION(AccountAlreadyImported());
-
-            RLP const account = addressAndAccount[1];
-            if (account.itemCount() != 5)
-                BOOST_THROW_EXCEPTION(InvalidStateChunkData());
-
-            u256 const nonce = account[0].toInt<u256>(RLP::VeryStrict);
-            u256 const balance = account[1].toInt<u256>(RLP::VeryStrict);
-
-            RLP const storage = account[4];
-            std::map<h256, bytes> storageMap;
-            for (auto hashAndValue: storage)
-            {
-                if (hashAndValue.itemCount() != 2)
-                    BOOST_THROW_EXCEPTION(InvalidStateChunkData());
-
-                h256 const keyHash = hashAndValue[0].toHash<h256>(RLP::VeryStrict);
-                if (!keyHash || storageMap.find(keyHash) != storageMap.end())
-                    BOOST_THROW_EXCEPTION(InvalidStateChunkData());
-
-                bytes value = hashAndValue[1].toBytes(RLP::VeryStrict);
-                if (value.empty())
-                    BOOST_THROW_EXCEPTION(InvalidStateChunkData());
-
-                storageMap.emplace(keyHash, std::move(value));
-            }
-
-            byte const codeFlag = account[2].toInt<byte>(RLP::VeryStrict);
-            h256 codeHash;
-            switch (codeFlag)
+    size_t bytesImported = 0;
+    h256Hash importedCodes;
+    auto const start = std::chrono::steady_clock::now();
+    auto const secondsSinceStart = [&] {
+        return std::max(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), 0.001);
+    };
+
+    forEachInOrder<StateChunk>(stateChunkCount, m_threads, "snapshot",
+        [&](size_t _i) { return decodeStateChunk(_snapshotStorage.readChunk(_stateChunkHashes[_i])); },
+        [&](StateChunk& _chunk) {
+            for (size_t accountIndex = 0; accountIndex < _chunk.accounts.size(); ++accountIndex)
             {
-            case 0:
-                codeHash = EmptySHA3;
-                break;
-            case 1:
-                codeHash = m_stateImporter.importCode(account[3].toBytesConstRef(RLP::VeryStrict));
-                break;
-            case 2:
-                codeHash = account[3].toHash<h256>(RLP::VeryStrict);
-                if (!codeHash || m_stateImporter.lookupCode(codeHash).empty())
-                    BOOST_THROW_EXCEPTION(InvalidStateChunkData());
-                break;
-            default:
-                BOOST_THROW_EXCEPTION(InvalidStateChunkData());
+                SnapshotAccount const& account = _chunk.accounts[accountIndex];
+                // splitted parts of account can be only first in chunk
+                bool const continued = m_stateImporter.isAccountImported(account.addressHash);
+                if (accountIndex > 0 && continued)
+                    BOOST_THROW_EXCEPTION(AccountAlreadyImported());
+
+                // Codes are hashed by the workers and written once.
+                h256 const& codeHash = account.codeHash;
+                if (account.codeFlag == 1 && importedCodes.insert(codeHash).second)
+                    m_stateImporter.importCode(&account.code);
+                else if (account.codeFlag == 2 && !importedCodes.count(codeHash))
+                {
+                    if (m_stateImporter.lookupCode(codeHash).empty())
+                        BOOST_THROW_EXCEPTION(InvalidStateChunkData());
+                    importedCodes.insert(codeHash);
+                }
+
+                if (continued)
+                    m_stateImporter.importAccount(account.addressHash, account.nonce, account.balance, account.storage, codeHash);
+                else
+                    m_stateImporter.importAccount(account.addressHash, account.nonce, account.balance, account.storageTrie, codeHash);
             }
+            accountsImported += _chunk.accounts.size();
+            bytesImported += _chunk.size;
 
-            m_stateImporter.importAccount(addressHash, nonce, balance, storageMap, codeHash);
-        }
-        accountsImported += accountCount;
-
-        m_stateImporter.commitStateDatabase();
+            m_stateImporter.commitStateDatabase();
 
-        ++chunksImported;
-        LOG(m_logger) << "Imported chunk " << chunksImported << " (" << accounts.itemCount()
-                      << " account records) Total account records imported: " << accountsImported;
-        LOG(m_logger) << stateChunkCount - chunksImported << " chunks left to import";
-    }
+            ++chunksImported;
+            double const seconds = secondsSinceStart();
+            LOG(m_logger) << "Imported chunk " << chunksImported << " (" << _chunk.accounts.size()
+                          << " account records) Total account records imported: " << accountsImported
+                          << " at " << static_cast<size_t>(accountsImported / seconds) << " records/s, "
+                          << static_cast<size_t>(bytesImported / seconds / 1024) << " KiB/s";
+            LOG(m_logger) << stateChunkCount - chunksImported << " chunks left to import";
+        });
 
     // check root
-    LOG(m_logger) << "Chunks imported: " << chunksImported;
+    LOG(m_logger) << "Chunks imported: " << chunksImported << " in " << secondsSinceStart() << " seconds";
     LOG(m_logger) << "Account records imported: " << accountsImported;
     LOG(m_logger) << "Reconstructed state root: " << m_stateImporter.stateRoot();
     LOG(m_logger) << "Manifest state root:      " << _stateRoot;
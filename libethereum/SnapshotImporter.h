@@ -22,10 +22,18 @@ class BlockChainImporterFace;
 class SnapshotStorageFace;
 class StateImporterFace;
 
+/**
+ * @brief Imports the state and the blocks of a snapshot.
+ *
+ * State chunks are read, decompressed and decoded on worker threads, which also build the storage
+ * tries of the accounts, a few chunks ahead of the chunk whose accounts are inserted into the
+ * state trie on the importing thread.
+ */
 class SnapshotImporter
 {
 public:
-    SnapshotImporter(StateImporterFace& _stateImporter, BlockChainImporterFace& _bcImporter): m_stateImporter(_stateImporter), m_blockChainImporter(_bcImporter) {}
+    /// @param _threads  Number of threads decoding state chunks, the hardware concurrency if 0.
+    SnapshotImporter(StateImporterFace& _stateImporter, BlockChainImporterFace& _bcImporter, unsigned _threads = 0);
 
     void import(SnapshotStorageFace const& _snapshotStorage, h256 const& _genesisHash);
 
@@ -35,6 +43,7 @@ private:
 
     StateImporterFace& m_stateImporter;
     BlockChainImporterFace& m_blockChainImporter;
+    unsigned m_threads;
 
     Logger m_logger{createLogger(VerbosityInfo, "snap")};
 };
@@ -34,6 +34,7 @@ State::State(State const& _s):
     m_db(_s.m_db),
     m_state(&m_db, _s.m_state.root(), Verification::Skip),
     m_cache(_s.m_cache),
+    m_sharedCache(_s.m_sharedCache),
     m_unchangedCacheEntries(_s.m_unchangedCacheEntries),
     m_nonExistingAccountsCache(_s.m_nonExistingAccountsCache),
     m_touched(_s.m_touched),
@@ -146,6 +147,7 @@ State& State::operator=(State const& _s)
     m_db = _s.m_db;
     m_state.open(&m_db, _s.m_state.root(), Verification::Skip);
     m_cache = _s.m_cache;
+    m_sharedCache = _s.m_sharedCache;
     m_unchangedCacheEntries = _s.m_unchangedCacheEntries;
     m_nonExistingAccountsCache = _s.m_nonExistingAccountsCache;
     m_touched = _s.m_touched;
@@ -165,6 +167,14 @@ Account* State::account(Address const& _addr)
     if (it != m_cache.end())
         return &it->second;
 
+    if (Account const* shared = m_sharedCache.find(_addr))
+    {
+        clearCacheIfTooLarge();
+        auto i = m_cache.emplace(_addr, *shared);
+        m_unchangedCacheEntries.push_back(_addr);
+        return &i.first->second;
+    }
+
     if (m_nonExistingAccountsCache.count(_addr))
         return nullptr;
 
@@ -211,6 +221,22 @@ void State::clearCacheIfTooLarge() const
     }
 }
 
+void State::shareCaches()
+{
+    m_db.freeze();
+    SharedLayers<Address, Account>::Map unchanged;
+    for (auto it = m_cache.begin(); it != m_cache.end();)
+        if (it->second.isDirty())
+            ++it;
+        else
+        {
+            unchanged.emplace(it->first, move(it->second));
+            it = m_cache.erase(it);
+        }
+    m_sharedCache.push(move(unchanged));
+    m_unchangedCacheEntries.clear();
+}
+
 void State::commit(CommitBehaviour _commitBehaviour)
 {
     if (_commitBehaviour == CommitBehaviour::RemoveEmptyAccounts)
@@ -218,6 +244,7 @@ void State::commit(CommitBehaviour _commitBehaviour)
     m_touched += dev::eth::commit(m_cache, m_state);
     m_changeLog.clear();
     m_cache.clear();
+    m_sharedCache.clear();
     m_unchangedCacheEntries.clear();
 }
 
@@ -296,6 +323,7 @@ std::pair<State::AddressMap, h256> State::addresses(
 void State::setRoot(h256 const& _r)
 {
     m_cache.clear();
+    m_sharedCache.clear();
     m_unchangedCacheEntries.clear();
     m_nonExistingAccountsCache.clear();
 //  m_touched.clear();
@@ -515,20 +543,34 @@ h256 State::storageRoot(Address const& _id) const
 }
 
 bytes const& State::code(Address const& _addr) const
+{
+    auto const c = sharedCode(_addr);
+    return c ? *c : NullBytes;
+}
+
+std::shared_ptr<bytes const> State::sharedCode(Address const& _addr) const
 {
     Account const* a = account(_addr);
     if (!a || a->codeHash() == EmptySHA3)
-        return NullBytes;
+        return {};
 
-    if (a->code().empty())
+    if (!a->sharedCode())
     {
-        // Load the code from the backend.
-        Account* mutableAccount = const_cast<Account*>(a);
-        mutableAccount->noteCode(m_db.lookup(a->codeHash()));
-        CodeSizeCache::instance().store(a->codeHash(), a->code().size());
+        // Take the code from the process-wide cache or load it from the backend.
+        auto& cache = CodeCache::instance();
+        auto c = cache.find(a->codeHash());
+        if (!c)
+        {
+            std::string const code = m_db.lookup(a->codeHash());
+            // Code missing from the backend is not cached, a later lookup may find it.
+            if (code.empty())
+                return {};
+            c = cache.insert(a->codeHash(), std::make_shared<bytes const>(asBytes(code)));
+        }
+        const_cast<Account*>(a)->noteCode(std::move(c));
     }
 
-    return a->code();
+    return a->sharedCode();
 }
 
 void State::setCode(Address const& _address, bytes&& _code, u256 const& _version)
@@ -550,23 +592,7 @@ h256 State::codeHash(Address const& _a) const
 
 size_t State::codeSize(Address const& _a) const
 {
-    if (Account const* a = account(_a))
-    {
-        if (a->hasNewCode())
-            return a->code().size();
-        auto& codeSizeCache = CodeSizeCache::instance();
-        h256 codeHash = a->codeHash();
-        if (codeSizeCache.contains(codeHash))
-            return codeSizeCache.get(codeHash);
-        else
-        {
-            size_t size = code(_a).size();
-            codeSizeCache.store(codeHash, size);
-            return size;
-        }
-    }
-    else
-        return 0;
+    return code(_a).size();
 }
 
 u256 State::version(Address const& _a) const
@@ -783,62 +809,103 @@ State& dev::eth::createIntermediateState(State& o_s, Block const& _block, unsign
     return o_s;
 }
 
+namespace
+{
+/// @returns sha3 of each of the keys, hashed in one batch.
+template <class Key>
+h256s hashKeys(vector<Key> const& _keys)
+{
+    vector<bytesConstRef> refs;
+    refs.reserve(_keys.size());
+    for (auto const& k: _keys)
+        refs.push_back(k.ref());
+    return sha3Batch(refs);
+}
+}  // namespace
+
 template <class DB>
 AddressHash dev::eth::commit(AccountMap const& _cache, SecureTrieDB<Address, DB>& _state)
 {
-    AddressHash ret;
+    // Hash the addresses of all the dirty accounts and below the keys of each account's storage
+    // in batches, the trie updates then take the hashes.
+    vector<Address> addresses;
+    vector<Account const*> accounts;
     for (auto const& i: _cache)
         if (i.second.isDirty())
         {
-            if (!i.second.isAlive())
-                _state.remove(i.first);
-            else
-            {
-                auto const version = i.second.version();
+            addresses.push_back(i.first);
+            accounts.push_back(&i.second);
+        }
+    h256s const hashedAddresses = hashKeys(addresses);
+
+    AddressHash ret;
+    for (size_t k = 0; k < addresses.size(); ++k)
+    {
+        Address const& address = addresses[k];
+        Account const& account = *accounts[k];
+        if (!account.isAlive())
+            _state.removeHashed(hashedAddresses[k]);
+        else
+        {
+            auto const version = account.version();
 
-                // version = 0: [nonce, balance, storageRoot, codeHash]
-                // version > 0: [nonce, balance, storageRoot, codeHash, version]
-                RLPStream s(version != 0 ? 5 : 4);
-                s << i.second.nonce() << i.second.balance();
+            // version = 0: [nonce, balance, storageRoot, codeHash]
+            // version > 0: [nonce, balance, storageRoot, codeHash, version]
+            RLPStream s(version != 0 ? 5 : 4);
+            s << account.nonce() << account.balance();
 
-                if (i.second.storageOverlay().empty())
-                {
-                    assert(i.second.baseRoot());
-                    s.append(i.second.baseRoot());
-                }
-                else
+            if (account.storageOverlay().empty())
+            {
+                assert(account.baseRoot());
+                s.append(account.baseRoot());
+            }
+            else
+            {
+                vector<h256> keys;
+                vector<u256> values;
+                keys.reserve(account.storageOverlay().size());
+                values.reserve(account.storageOverlay().size());
+                for (auto const& j: account.storageOverlay())
                 {
-                    SecureTrieDB<h256, DB> storageDB(_state.db(), i.second.baseRoot());
-                    for (auto const& j: i.second.storageOverlay())
-                        if (j.second)
-                            storageDB.insert(j.first, rlp(j.second));
-                        else
-                            storageDB.remove(j.first);
-                    assert(storageDB.root());
-                    s.append(storageDB.root());
+                    keys.push_back(j.first);
+                    values.push_back(j.second);
                 }
+                h256s const hashedKeys = hashKeys(keys);
 
-                if (i.second.hasNewCode())
+                SecureTrieDB<h256, DB> storageDB(_state.db(), account.baseRoot());
+                for (size_t j = 0; j < keys.size(); ++j)
                 {
-                    h256 ch = i.second.codeHash();
-                    // Store the size of the code
-                    CodeSizeCache::instance().store(ch, i.second.code().size());
-                    _state.db()->insert(ch, &i.second.code());
-                    s << ch;
+                    if (values[j])
+                    {
+                        bytes const value = rlp(values[j]);
+                        storageDB.insertHashed(hashedKeys[j], keys[j].ref(), &value);
+                    }
+                    else
+                        storageDB.removeHashed(hashedKeys[j]);
                 }
-                else
-                    s << i.second.codeHash();
-
-                if (version != 0)
-                    s << i.second.version();
+                assert(storageDB.root());
+                s.append(storageDB.root());
+            }
 
-                _state.insert(i.first, &s.out());
+            if (account.hasNewCode())
+            {
+                h256 ch = account.codeHash();
+                CodeCache::instance().insert(ch, account.sharedCode());
+                _state.db()->insert(ch, &account.code());
+                s << ch;
             }
-            ret.insert(i.first);
+            else
+                s << account.codeHash();
+
+            if (version != 0)
+                s << account.version();
+
+            _state.insertHashed(hashedAddresses[k], address.ref(), &s.out());
         }
+        ret.insert(address);
+    }
     return ret;
 }
 
-
 template AddressHash dev::eth::commit<OverlayDB>(AccountMap const& _cache, SecureTrieDB<Address, OverlayDB>& _state);
 template AddressHash dev::eth::commit<StateCacheDB>(AccountMap const& _cache, SecureTrieDB<Address, StateCacheDB>& _state);
@@ -12,9 +12,10 @@
 #include <libdevcore/Common.h>
 #include <libdevcore/OverlayDB.h>
 #include <libdevcore/RLP.h>
+#include <libdevcore/SharedLayers.h>
 #include <libethcore/BlockHeader.h>
 #include <libethcore/Exceptions.h>
-#include <libethereum/CodeSizeCache.h>
+#include <libethereum/CodeCache.h>
 #include <libevm/ExtVMFace.h>
 #include <array>
 #include <unordered_map>
@@ -268,12 +269,16 @@ public:
     ///          other account. Do not keep it.
     bytes const& code(Address const& _addr) const;
 
+    /// Get the code of an account as a buffer that may be kept.
+    /// @returns null if no account exists at that address or if it has no code.
+    std::shared_ptr<bytes const> sharedCode(Address const& _addr) const;
+
     /// Get the code hash of an account.
     /// @returns EmptySHA3 if no account exists at that address or if there is no code associated with the address.
     h256 codeHash(Address const& _contract) const;
 
     /// Get the byte-size of the code of an account.
-    /// @returns code(_contract).size(), but utilizes CodeSizeHash.
+    /// @returns code(_contract).size().
     size_t codeSize(Address const& _contract) const;
 
     /// Get contract account's version.
@@ -300,6 +305,12 @@ public:
     /// Resets any uncommitted changes to the cache.
     void setRoot(h256 const& _root);
 
+    /// Moves the unchanged cached accounts and the trie nodes written since the last call into
+    /// caches shared with copies, so that copying costs O(1) plus the accounts changed by a
+    /// transaction in progress. Copying itself only reads the source, which concurrent readers
+    /// may share, so the owner calls this while it has the state to itself.
+    void shareCaches();
+
     /// Get the account start nonce. May be required.
     u256 const& accountStartNonce() const { return m_accountStartNonce; }
     u256 const& requireAccountStartNonce() const;
@@ -345,6 +356,9 @@ private:
     /// Our address cache. This stores the states of each address that has (or at least might have)
     /// been changed.
     mutable std::unordered_map<Address, Account> m_cache;
+    /// Unchanged accounts shared with the copies of this state. They are never modified, an
+    /// account is cloned into m_cache when accessed.
+    SharedLayers<Address, Account> m_sharedCache;
     /// Tracks entries in m_cache that can potentially be purged if it grows too large.
     mutable std::vector<Address> m_unchangedCacheEntries;
     /// Tracks addresses that are known to not exist.
@@ -5,6 +5,7 @@
 
 #include <libdevcore/OverlayDB.h>
 #include <libdevcore/RLP.h>
+#include <libdevcore/StateCacheDB.h>
 #include <libdevcore/TrieDB.h>
 
 namespace dev
@@ -42,6 +43,17 @@ public:
 		m_trie.insert(_addressHash, &s.out());
 	}
 
+	void importAccount(h256 const& _addressHash, u256 const& _nonce, u256 const& _balance, StorageTrie const& _storage, h256 const& _codeHash) override
+	{
+		if (m_storageRoots.insert(_storage.root).second)
+			for (auto const& node: _storage.nodes)
+				m_trie.db()->insert(node.first, &node.second);
+
+		RLPStream s(4);
+		s << _nonce << _balance << _storage.root << _codeHash;
+		m_trie.insert(_addressHash, &s.out());
+	}
+
 	h256 importCode(bytesConstRef _code) override
 	{
 		h256 const hash = sha3(_code);
@@ -72,10 +84,26 @@ private:
 	}
 
 	SpecificTrieDB<GenericTrieDB<OverlayDB>, h256> m_trie;
+	h256Hash m_storageRoots;	///< The roots of the storage tries imported whole.
 };
 
 }
 
+StorageTrie buildStorageTrie(std::map<h256, bytes> const& _storage)
+{
+	StateCacheDB db;
+	SpecificTrieDB<GenericTrieDB<StateCacheDB>, h256> trie(&db);
+	trie.init();
+	for (auto const& hashAndValue: _storage)
+		trie.insert(hashAndValue.first, hashAndValue.second);
+
+	StorageTrie ret{trie.root(), {}};
+	EnforceRefs const enforceRefs(db, true);
+	for (auto& node: db.get())
+		ret.nodes.emplace_back(node.first, asBytes(node.second));
+	return ret;
+}
+
 std::unique_ptr<StateImporterFace> createStateImporter(OverlayDB& _stateDb)
 {
 	return std::unique_ptr<StateImporterFace>(new StateImporter(_stateDb));
@@ -10,7 +10,9 @@
 #include <libdevcore/Exceptions.h>
 #include <libdevcore/FixedHash.h>
 
+#include <map>
 #include <memory>
+#include <vector>
 
 namespace dev
 {
@@ -22,6 +24,17 @@ namespace eth
 
 DEV_SIMPLE_EXCEPTION(InvalidAccountInTheDatabase);
 
+/// A storage trie built apart from the state database, as hashes and values of its nodes.
+struct StorageTrie
+{
+	h256 root;
+	std::vector<std::pair<h256, bytes>> nodes;
+};
+
+/// Builds the storage trie of the values by the hashes of their keys in memory.
+/// Can be called concurrently.
+StorageTrie buildStorageTrie(std::map<h256, bytes> const& _storage);
+
 class StateImporterFace
 {
 public:
@@ -29,6 +42,10 @@ public:
 
 	virtual void importAccount(h256 const& _addressHash, u256 const& _nonce, u256 const& _balance, std::map<h256, bytes> const& _storage, h256 const& _codeHash) = 0;
 
+	/// Imports an account with its whole storage, the nodes of the storage trie being inserted
+	/// unless a trie with the same root was imported before.
+	virtual void importAccount(h256 const& _addressHash, u256 const& _nonce, u256 const& _balance, StorageTrie const& _storage, h256 const& _codeHash) = 0;
+
 	virtual h256 importCode(bytesConstRef _code) = 0;
 
 	virtual void commitStateDatabase() = 0;
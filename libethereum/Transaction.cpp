@@ -53,6 +53,8 @@ TransactionException dev::eth::toTransactionException(Exception const& _e)
 		return TransactionException::OutOfStack;
 	if (!!dynamic_cast<StackUnderflow const*>(&_e))
 		return TransactionException::StackUnderflow;
+	if (!!dynamic_cast<ExecutionTimeout const*>(&_e))
+		return TransactionException::ExecutionTimeout;
 	return TransactionException::Unknown;
 }
 
@@ -77,6 +79,9 @@ std::ostream& dev::eth::operator<<(std::ostream& _out, TransactionException cons
         case TransactionException::RevertInstruction:
             _out << "RevertInstruction";
             break;
+        case TransactionException::ExecutionTimeout:
+            _out << "ExecutionTimeout";
+            break;
         default: _out << "Unknown"; break;
 	}
 	return _out;
@@ -35,7 +35,8 @@ enum class TransactionException
 	StackUnderflow,
 	RevertInstruction,
 	InvalidZeroSignatureFormat,
-	AddressAlreadyUsed
+	AddressAlreadyUsed,
+	ExecutionTimeout		///< Exceeded the time limit of a call; never happens in block processing.
 };
 
 enum class CodeDeposit
@@ -7,6 +7,9 @@
 #include <libdevcore/Log.h>
 #include <libethcore/Exceptions.h>
 #include "Transaction.h"
+
+#include <queue>
+
 using namespace std;
 using namespace dev;
 using namespace dev::eth;
@@ -15,16 +18,53 @@ namespace
 {
 constexpr size_t c_maxVerificationQueueSize = 8192;
 constexpr size_t c_maxDroppedTransactionCount = 1024;
+/// Maximum number of transactions a verifier imports at once.
+constexpr size_t c_maxVerificationBatchSize = 256;
+
+/// @returns true if topTransactions returns @a _a after @a _b: it is cheaper, or as expensive and
+/// with a higher nonce, or from a greater sender, so that the order does not depend on the heap.
+bool returnedAfter(Transaction const& _a, Transaction const& _b)
+{
+    if (_a.gasPrice() != _b.gasPrice())
+        return _a.gasPrice() < _b.gasPrice();
+    if (_a.nonce() != _b.nonce())
+        return _a.nonce() > _b.nonce();
+    return _a.from() > _b.from();
+}
+
+/// @returns true if the last transaction of @a _a should be evicted before the last one of @a _b:
+/// it is cheaper, or as cheap and further away from the first transaction of its lane.
+template <class NonceMap>
+bool evictedBefore(NonceMap const& _a, NonceMap const& _b)
+{
+    u256 const& priceA = _a.rbegin()->second.transaction.gasPrice();
+    u256 const& priceB = _b.rbegin()->second.transaction.gasPrice();
+    if (priceA != priceB)
+        return priceA < priceB;
+    return _a.rbegin()->first - _a.begin()->first > _b.rbegin()->first - _b.begin()->first;
+}
 }  // namespace
 
-TransactionQueue::TransactionQueue(unsigned _limit, unsigned _futureLimit)
+constexpr size_t TransactionQueue::c_defaultBytesLimit;
+constexpr size_t TransactionQueue::c_notInHeap;
+
+TransactionQueue::TransactionQueue(unsigned _limit, unsigned _futureLimit, size_t _bytesLimit)
   : m_dropped{c_maxDroppedTransactionCount},
-    m_current{PriorityCompare{*this}},
+    m_heads{[](Lane const& _a, Lane const& _b) {
+                return returnedAfter(_a.current.begin()->second.transaction,
+                    _b.current.begin()->second.transaction);
+            },
+        &Lane::headPosition},
+    m_tails{[](Lane const& _a, Lane const& _b) { return evictedBefore(_b.current, _a.current); },
+        &Lane::tailPosition},
+    m_futureTails{[](Lane const& _a, Lane const& _b) { return evictedBefore(_b.future, _a.future); },
+        &Lane::futurePosition},
     m_limit{_limit},
-    m_futureLimit{_futureLimit}
+    m_futureLimit{_futureLimit},
+    m_bytesLimit{_bytesLimit},
+    m_verifierCount{std::max(thread::hardware_concurrency(), 3U) - 2U}
 {
-    unsigned verifierThreads = std::max(thread::hardware_concurrency(), 3U) - 2U;
-    for (unsigned i = 0; i < verifierThreads; ++i)
+    for (unsigned i = 0; i < m_verifierCount; ++i)
         m_verifiers.emplace_back([=](){
             setThreadName("txcheck" + toString(i));
             this->verifierBody();
@@ -80,78 +120,146 @@ ImportResult TransactionQueue::import(Transaction const& _transaction, IfDropped
 
         {
             _transaction.safeSender();  // Perform EC recovery outside of the write lock
+            size_t const size = _transaction.rlp().size();
             UpgradeGuard ul(l);
-            ret = manageImport_WITH_LOCK(h, _transaction);
+            ret = manageImport_WITH_LOCK(h, _transaction, size);
         }
     }
     return ret;
 }
 
+vector<ImportResult> TransactionQueue::import(Transactions const& _transactions, IfDropped _ik)
+{
+    vector<ImportResult> ret(_transactions.size(), ImportResult::Success);
+    h256s hashes(_transactions.size());
+    vector<size_t> sizes(_transactions.size());
+    for (size_t i = 0; i < _transactions.size(); ++i)
+        if (_transactions[i].hasZeroSignature())
+            ret[i] = ImportResult::ZeroSignature;
+        else
+            hashes[i] = _transactions[i].sha3(WithSignature);
+
+    // Skip known transactions before doing EC recovery of the rest without holding the lock.
+    {
+        UpgradableGuard l(m_lock);
+        for (size_t i = 0; i < _transactions.size(); ++i)
+            if (ret[i] == ImportResult::Success)
+                ret[i] = check_WITH_LOCK(hashes[i], _ik);
+    }
+    for (size_t i = 0; i < _transactions.size(); ++i)
+        if (ret[i] == ImportResult::Success)
+        {
+            _transactions[i].safeSender();
+            sizes[i] = _transactions[i].rlp().size();
+        }
+
+    WriteGuard l(m_lock);
+    for (size_t i = 0; i < _transactions.size(); ++i)
+        if (ret[i] == ImportResult::Success)
+        {
+            // Check again, the queue could have changed while the lock was released.
+            ret[i] = check_WITH_LOCK(hashes[i], _ik);
+            if (ret[i] == ImportResult::Success)
+                ret[i] = manageImport_WITH_LOCK(hashes[i], _transactions[i], sizes[i]);
+        }
+    return ret;
+}
+
 Transactions TransactionQueue::topTransactions(unsigned _limit, h256Hash const& _avoid) const
 {
     ReadGuard l(m_lock);
+
+    // Merge the lanes by gas price, taking the transactions of each lane in nonce order. The
+    // children of a lane in the heap of lane heads are returned after the lane's first
+    // transaction, so they only become candidates once that transaction has been taken.
+    struct Candidate
+    {
+        Lane const* lane;
+        NonceMap::const_iterator transaction;
+        size_t headPosition;  ///< Position of the lane in m_heads if this is its first transaction.
+    };
+    auto const cheaper = [](Candidate const& _a, Candidate const& _b) {
+        return returnedAfter(_a.transaction->second.transaction, _b.transaction->second.transaction);
+    };
+    priority_queue<Candidate, vector<Candidate>, decltype(cheaper)> candidates{cheaper};
+    auto const& heads = m_heads.lanes();
+    auto const pushHead = [&](size_t _position) {
+        if (_position < heads.size())
+            candidates.push({heads[_position], heads[_position]->current.begin(), _position});
+    };
+
     Transactions ret;
-    for (auto t = m_current.begin(); ret.size() < _limit && t != m_current.end(); ++t)
-        if (!_avoid.count(t->transaction.sha3()))
-            ret.push_back(t->transaction);
+    pushHead(0);
+    while (ret.size() < _limit && !candidates.empty())
+    {
+        Candidate const c = candidates.top();
+        candidates.pop();
+        if (!_avoid.count(c.transaction->second.hash))
+            ret.push_back(c.transaction->second.transaction);
+
+        if (c.headPosition != c_notInHeap)
+        {
+            pushHead(2 * c.headPosition + 1);
+            pushHead(2 * c.headPosition + 2);
+        }
+        auto const next = std::next(c.transaction);
+        if (next != c.lane->current.end())
+            candidates.push({c.lane, next, c_notInHeap});
+    }
     return ret;
 }
 
 h256Hash TransactionQueue::knownTransactions() const
 {
     ReadGuard l(m_lock);
-    return m_known;
+    h256Hash ret;
+    ret.reserve(m_known.size());
+    for (auto const& known: m_known)
+        ret.insert(known.first);
+    return ret;
 }
 
-ImportResult TransactionQueue::manageImport_WITH_LOCK(h256 const& _h, Transaction const& _transaction)
+ImportResult TransactionQueue::manageImport_WITH_LOCK(
+    h256 const& _h, Transaction const& _transaction, size_t _size)
 {
     try
     {
         assert(_h == _transaction.sha3());
+        Address const from = _transaction.from();
+        u256 const nonce = _transaction.nonce();
+        Lane& lane = m_lanes[from];
+        lane.sender = from;
+
         // Remove any prior transaction with the same nonce but a lower gas price.
         // Bomb out if there's a prior transaction with higher gas price.
-        auto cs = m_currentByAddressAndNonce.find(_transaction.from());
-        if (cs != m_currentByAddressAndNonce.end())
+        auto const current = lane.current.find(nonce);
+        auto const future = lane.future.find(nonce);
+        if ((current != lane.current.end() &&
+                _transaction.gasPrice() < current->second.transaction.gasPrice()) ||
+            (future != lane.future.end() &&
+                _transaction.gasPrice() < future->second.transaction.gasPrice()))
+            return ImportResult::OverbidGasPrice;
+        if (current != lane.current.end())
         {
-            auto t = cs->second.find(_transaction.nonce());
-            if (t != cs->second.end())
-            {
-                if (_transaction.gasPrice() < (*t->second).transaction.gasPrice())
-                    return ImportResult::OverbidGasPrice;
-                else
-                {
-                    h256 dropped = (*t->second).transaction.sha3();
-                    remove_WITH_LOCK(dropped);
-                    m_onReplaced(dropped);
-                }
-            }
-        }
-        auto fs = m_future.find(_transaction.from());
-        if (fs != m_future.end())
-        {
-            auto t = fs->second.find(_transaction.nonce());
-            if (t != fs->second.end())
-            {
-                if (_transaction.gasPrice() < t->second.transaction.gasPrice())
-                    return ImportResult::OverbidGasPrice;
-                else
-                {
-                    fs->second.erase(t);
-                    --m_futureSize;
-                    if (fs->second.empty())
-                        m_future.erase(fs);
-                }
-            }
+            h256 const dropped = current->second.hash;
+            erase_WITH_LOCK(lane, false, current);
+            m_onReplaced(dropped);
         }
+        if (future != lane.future.end())
+            erase_WITH_LOCK(lane, true, future);
+
         // If valid, append to transactions.
-        insertCurrent_WITH_LOCK(make_pair(_h, _transaction));
+        lane.current.emplace(nonce, VerifiedTransaction{_transaction, _h, _size});
+        m_known[_h] = {from, nonce};
+        ++m_currentSize;
+        m_bytes += _size;
         LOG(m_loggerDetail) << "Queued vaguely legit-looking transaction " << _h;
 
-        while (m_current.size() > m_limit)
-        {
-            LOG(m_loggerDetail) << "Dropping out of bounds transaction " << _h;
-            remove_WITH_LOCK(m_current.rbegin()->transaction.sha3());
-        }
+        // Move following transactions from future to current
+        makeCurrent_WITH_LOCK(lane, nonce);
+        updateLane_WITH_LOCK(lane);
+        // The limits may evict the transaction at once, which is still reported as imported.
+        enforceLimits_WITH_LOCK();
 
         m_onReady();
     }
@@ -178,134 +286,142 @@ u256 TransactionQueue::maxNonce(Address const& _a) const
 u256 TransactionQueue::maxNonce_WITH_LOCK(Address const& _a) const
 {
     u256 ret = 0;
-    auto cs = m_currentByAddressAndNonce.find(_a);
-    if (cs != m_currentByAddressAndNonce.end() && !cs->second.empty())
-        ret = cs->second.rbegin()->first + 1;
-    auto fs = m_future.find(_a);
-    if (fs != m_future.end() && !fs->second.empty())
-        ret = std::max(ret, fs->second.rbegin()->first + 1);
+    auto lane = m_lanes.find(_a);
+    if (lane == m_lanes.end())
+        return ret;
+    if (!lane->second.current.empty())
+        ret = lane->second.current.rbegin()->first + 1;
+    if (!lane->second.future.empty())
+        ret = std::max(ret, lane->second.future.rbegin()->first + 1);
     return ret;
 }
 
-void TransactionQueue::insertCurrent_WITH_LOCK(std::pair<h256, Transaction> const& _p)
+bool TransactionQueue::makeCurrent_WITH_LOCK(Lane& _lane, u256 _nonce)
 {
-    if (m_currentByHash.count(_p.first))
+    bool newCurrent = false;
+    u256 nonce = _nonce + 1;
+    for (auto ft = _lane.future.find(nonce); ft != _lane.future.end() && ft->first == nonce; ++nonce)
     {
-        cwarn << "Transaction hash" << _p.first << "already in current?!";
-        return;
+        _lane.current.insert(std::move(*ft));
+        ft = _lane.future.erase(ft);
+        --m_futureSize;
+        ++m_currentSize;
+        newCurrent = true;
+    }
+    return newCurrent;
+}
+
+void TransactionQueue::enforceLimits_WITH_LOCK()
+{
+    while (m_futureSize > m_futureLimit)
+        evictFuture_WITH_LOCK();
+    while (m_currentSize > m_limit)
+        evictCurrent_WITH_LOCK();
+    while (m_bytes > m_bytesLimit)
+    {
+        if (!m_futureTails.empty())
+            evictFuture_WITH_LOCK();
+        else
+            evictCurrent_WITH_LOCK();
     }
+}
 
-    Transaction const& t = _p.second;
-    // Insert into current
-    auto inserted = m_currentByAddressAndNonce[t.from()].insert(std::make_pair(t.nonce(), PriorityQueue::iterator()));
-    PriorityQueue::iterator handle = m_current.emplace(VerifiedTransaction(t));
-    inserted.first->second = handle;
-    m_currentByHash[_p.first] = handle;
+void TransactionQueue::evictFuture_WITH_LOCK()
+{
+    Lane& lane = m_futureTails.top();
+    auto last = std::prev(lane.future.end());
+    LOG(m_loggerDetail) << "Dropping out of bounds future transaction " << last->second.hash;
+    erase_WITH_LOCK(lane, true, last);
+    updateLane_WITH_LOCK(lane);
+}
 
-    // Move following transactions from future to current
-    makeCurrent_WITH_LOCK(t);
-    m_known.insert(_p.first);
+void TransactionQueue::evictCurrent_WITH_LOCK()
+{
+    Lane& lane = m_tails.top();
+    auto last = std::prev(lane.current.end());
+    LOG(m_loggerDetail) << "Dropping out of bounds transaction " << last->second.hash;
+    erase_WITH_LOCK(lane, false, last);
+    updateLane_WITH_LOCK(lane);
 }
 
 bool TransactionQueue::remove_WITH_LOCK(h256 const& _txHash)
 {
-    auto t = m_currentByHash.find(_txHash);
-    if (t == m_currentByHash.end())
+    auto known = m_known.find(_txHash);
+    if (known == m_known.end())
         return false;
 
-    Address from = (*t->second).transaction.from();
-    auto it = m_currentByAddressAndNonce.find(from);
-    assert (it != m_currentByAddressAndNonce.end());
-    it->second.erase((*t->second).transaction.nonce());
-    m_current.erase(t->second);
-    m_currentByHash.erase(t);
-    if (it->second.empty())
-        m_currentByAddressAndNonce.erase(it);
-    m_known.erase(_txHash);
+    u256 const nonce = known->second.second;
+    Lane& lane = m_lanes.at(known->second.first);
+    auto current = lane.current.find(nonce);
+    if (current != lane.current.end() && current->second.hash == _txHash)
+        erase_WITH_LOCK(lane, false, current);
+    else
+    {
+        auto future = lane.future.find(nonce);
+        assert(future != lane.future.end() && future->second.hash == _txHash);
+        erase_WITH_LOCK(lane, true, future);
+    }
+    updateLane_WITH_LOCK(lane);
     return true;
 }
 
+void TransactionQueue::erase_WITH_LOCK(Lane& _lane, bool _future, NonceMap::iterator _it)
+{
+    m_known.erase(_it->second.hash);
+    m_bytes -= _it->second.size;
+    if (_future)
+    {
+        _lane.future.erase(_it);
+        --m_futureSize;
+    }
+    else
+    {
+        _lane.current.erase(_it);
+        --m_currentSize;
+    }
+}
+
+void TransactionQueue::updateLane_WITH_LOCK(Lane& _lane)
+{
+    m_heads.update(_lane, !_lane.current.empty());
+    m_tails.update(_lane, !_lane.current.empty());
+    m_futureTails.update(_lane, !_lane.future.empty());
+    if (_lane.current.empty() && _lane.future.empty())
+    {
+        Address const sender = _lane.sender;
+        m_lanes.erase(sender);
+    }
+}
+
 unsigned TransactionQueue::waiting(Address const& _a) const
 {
     ReadGuard l(m_lock);
-    unsigned ret = 0;
-    auto cs = m_currentByAddressAndNonce.find(_a);
-    if (cs != m_currentByAddressAndNonce.end())
-        ret = cs->second.size();
-    auto fs = m_future.find(_a);
-    if (fs != m_future.end())
-        ret += fs->second.size();
-    return ret;
+    auto lane = m_lanes.find(_a);
+    if (lane == m_lanes.end())
+        return 0;
+    return lane->second.current.size() + lane->second.future.size();
 }
 
 void TransactionQueue::setFuture(h256 const& _txHash)
 {
     WriteGuard l(m_lock);
-    auto it = m_currentByHash.find(_txHash);
-    if (it == m_currentByHash.end())
+    auto known = m_known.find(_txHash);
+    if (known == m_known.end())
         return;
 
-    VerifiedTransaction const& st = *(it->second);
+    Lane& lane = m_lanes.at(known->second.first);
+    auto cutoff = lane.current.find(known->second.second);
+    if (cutoff == lane.current.end() || cutoff->second.hash != _txHash)
+        return;
 
-    Address from = st.transaction.from();
-    auto& queue = m_currentByAddressAndNonce[from];
-    auto& target = m_future[from];
-    auto cutoff = queue.lower_bound(st.transaction.nonce());
-    for (auto m = cutoff; m != queue.end(); ++m)
+    for (auto m = cutoff; m != lane.current.end(); ++m)
     {
-        VerifiedTransaction& t = const_cast<VerifiedTransaction&>(*(m->second)); // set has only const iterators. Since we are moving out of container that's fine
-        m_currentByHash.erase(t.transaction.sha3());
-        target.emplace(t.transaction.nonce(), move(t));
-        m_current.erase(m->second);
+        lane.future.insert(std::move(*m));
+        --m_currentSize;
         ++m_futureSize;
     }
-    queue.erase(cutoff, queue.end());
-    if (queue.empty())
-        m_currentByAddressAndNonce.erase(from);
-}
-
-void TransactionQueue::makeCurrent_WITH_LOCK(Transaction const& _t)
-{
-    bool newCurrent = false;
-    auto fs = m_future.find(_t.from());
-    if (fs != m_future.end())
-    {
-        u256 nonce = _t.nonce() + 1;
-        auto fb = fs->second.find(nonce);
-        if (fb != fs->second.end())
-        {
-            auto ft = fb;
-            while (ft != fs->second.end() && ft->second.transaction.nonce() == nonce)
-            {
-                auto inserted = m_currentByAddressAndNonce[_t.from()].insert(std::make_pair(ft->second.transaction.nonce(), PriorityQueue::iterator()));
-                PriorityQueue::iterator handle = m_current.emplace(move(ft->second));
-                inserted.first->second = handle;
-                m_currentByHash[(*handle).transaction.sha3()] = handle;
-                --m_futureSize;
-                ++ft;
-                ++nonce;
-                newCurrent = true;
-            }
-            fs->second.erase(fb, ft);
-            if (fs->second.empty())
-                m_future.erase(_t.from());
-        }
-    }
-
-    while (m_futureSize > m_futureLimit)
-    {
-        // TODO: priority queue for future transactions
-        // For now just drop random chain end
-        --m_futureSize;
-        LOG(m_loggerDetail) << "Dropping out of bounds future transaction "
-                            << m_future.begin()->second.rbegin()->second.transaction.sha3();
-        m_future.begin()->second.erase(--m_future.begin()->second.end());
-        if (m_future.begin()->second.empty())
-            m_future.erase(m_future.begin());
-    }
-
-    if (newCurrent)
-        m_onReady();
+    lane.current.erase(cutoff, lane.current.end());
+    updateLane_WITH_LOCK(lane);
 }
 
 void TransactionQueue::drop(h256 const& _txHash)
@@ -323,9 +439,13 @@ void TransactionQueue::drop(h256 const& _txHash)
 void TransactionQueue::dropGood(Transaction const& _t)
 {
     WriteGuard l(m_lock);
-    makeCurrent_WITH_LOCK(_t);
-    if (!m_known.count(_t.sha3()))
-        return;
+    auto lane = m_lanes.find(_t.from());
+    if (lane != m_lanes.end() && makeCurrent_WITH_LOCK(lane->second, _t.nonce()))
+    {
+        updateLane_WITH_LOCK(lane->second);
+        enforceLimits_WITH_LOCK();
+        m_onReady();
+    }
     remove_WITH_LOCK(_t.sha3());
 }
 
@@ -333,12 +453,88 @@ void TransactionQueue::clear()
 {
     WriteGuard l(m_lock);
     m_known.clear();
-    m_current.clear();
     m_dropped.clear();
-    m_currentByAddressAndNonce.clear();
-    m_currentByHash.clear();
-    m_future.clear();
+    m_heads.clear();
+    m_tails.clear();
+    m_futureTails.clear();
+    m_lanes.clear();
+    m_currentSize = 0;
     m_futureSize = 0;
+    m_bytes = 0;
+}
+
+void TransactionQueue::LaneHeap::update(Lane& _lane, bool _hasKey)
+{
+    size_t& position = _lane.*m_position;
+    if (!_hasKey)
+    {
+        if (position == c_notInHeap)
+            return;
+        size_t const removed = position;
+        position = c_notInHeap;
+        Lane* last = m_heap.back();
+        m_heap.pop_back();
+        if (removed < m_heap.size())
+        {
+            place(removed, last);
+            siftUp(removed);
+            siftDown(last->*m_position);
+        }
+        return;
+    }
+
+    if (position == c_notInHeap)
+    {
+        m_heap.push_back(&_lane);
+        position = m_heap.size() - 1;
+    }
+    siftUp(position);
+    siftDown(position);
+}
+
+void TransactionQueue::LaneHeap::clear()
+{
+    for (auto lane: m_heap)
+        lane->*m_position = c_notInHeap;
+    m_heap.clear();
+}
+
+void TransactionQueue::LaneHeap::siftUp(size_t _i)
+{
+    Lane* lane = m_heap[_i];
+    while (_i > 0)
+    {
+        size_t const parent = (_i - 1) / 2;
+        if (!m_less(*m_heap[parent], *lane))
+            break;
+        place(_i, m_heap[parent]);
+        _i = parent;
+    }
+    place(_i, lane);
+}
+
+void TransactionQueue::LaneHeap::siftDown(size_t _i)
+{
+    Lane* lane = m_heap[_i];
+    while (true)
+    {
+        size_t child = 2 * _i + 1;
+        if (child >= m_heap.size())
+            break;
+        if (child + 1 < m_heap.size() && m_less(*m_heap[child], *m_heap[child + 1]))
+            ++child;
+        if (!m_less(*lane, *m_heap[child]))
+            break;
+        place(_i, m_heap[child]);
+        _i = child;
+    }
+    place(_i, lane);
+}
+
+void TransactionQueue::LaneHeap::place(size_t _i, Lane* _lane)
+{
+    m_heap[_i] = _lane;
+    _lane->*m_position = _i;
 }
 
 void TransactionQueue::enqueue(RLP const& _data, h512 const& _nodeId)
@@ -367,22 +563,46 @@ void TransactionQueue::verifierBody()
 {
     while (!m_aborting)
     {
-        UnverifiedTransaction work;
+        vector<UnverifiedTransaction> work;
 
         {
             unique_lock<Mutex> l(x_queue);
             m_queueReady.wait(l, [&](){ return !m_unverified.empty() || m_aborting; });
             if (m_aborting)
                 return;
-            work = move(m_unverified.front());
-            m_unverified.pop_front();
+            // Take a fair share of the queue so that a large packet is spread among the verifiers.
+            size_t const share = (m_unverified.size() + m_verifierCount - 1) / m_verifierCount;
+            size_t const count = std::min(share, c_maxVerificationBatchSize);
+            work.reserve(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                work.emplace_back(move(m_unverified.front()));
+                m_unverified.pop_front();
+            }
+        }
+
+        Transactions transactions;
+        vector<h512> nodeIds;
+        transactions.reserve(work.size());
+        nodeIds.reserve(work.size());
+        for (auto& w: work)
+        {
+            try
+            {
+                transactions.emplace_back(w.transaction, CheckTransaction::Cheap); //Signature will be checked later
+                nodeIds.push_back(w.nodeId);
+            }
+            catch (...)
+            {
+                cwarn << "Bad transaction:" << boost::current_exception_diagnostic_information();
+            }
         }
 
         try
         {
-            Transaction t(work.transaction, CheckTransaction::Cheap); //Signature will be checked later
-            ImportResult ir = import(t);
-            m_onImport(ir, t.sha3(), work.nodeId);
+            vector<ImportResult> const results = import(transactions);
+            for (size_t i = 0; i < transactions.size(); ++i)
+                m_onImport(results[i], transactions[i].sha3(), nodeIds[i]);
         }
         catch (...)
         {
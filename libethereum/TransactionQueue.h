@@ -13,6 +13,8 @@
 #include <condition_variable>
 #include <deque>
 #include <functional>
+#include <limits>
+#include <map>
 #include <thread>
 
 namespace dev
@@ -22,19 +24,28 @@ namespace eth
 
 /**
  * @brief A queue of Transactions, each stored as RLP.
- * Maintains a transaction queue sorted by nonce diff and gas price.
+ * Maintains the transactions of each sender in nonce order and orders the senders by gas price.
  * @threadsafe
  */
 class TransactionQueue
 {
 public:
-    struct Limits { size_t current; size_t future; };
+    static constexpr size_t c_defaultBytesLimit = 64 * 1024 * 1024;
+
+    struct Limits
+    {
+        size_t current;
+        size_t future;
+        size_t bytes = c_defaultBytesLimit;  ///< Maximum total RLP size of the queued transactions.
+    };
 
     /// @brief TransactionQueue
     /// @param _limit Maximum number of pending transactions in the queue.
     /// @param _futureLimit Maximum number of future nonce transactions.
-    TransactionQueue(unsigned _limit = 1024, unsigned _futureLimit = 1024);
-    TransactionQueue(Limits const& _l): TransactionQueue(_l.current, _l.future) {}
+    /// @param _bytesLimit Maximum total RLP size of pending and future transactions.
+    TransactionQueue(unsigned _limit = 1024, unsigned _futureLimit = 1024,
+        size_t _bytesLimit = c_defaultBytesLimit);
+    TransactionQueue(Limits const& _l): TransactionQueue(_l.current, _l.future, _l.bytes) {}
     ~TransactionQueue();
     /// Add transaction to the queue to be verified and imported.
     /// @param _data RLP encoded transaction data.
@@ -53,6 +64,13 @@ public:
     /// @returns Import result code.
     ImportResult import(Transaction const& _tx, IfDropped _ik = IfDropped::Ignore);
 
+    /// Verify and add transactions to the queue synchronously, taking the queue lock once for
+    /// the whole batch.
+    /// @param _txs Transactions to import.
+    /// @param _ik Set to Retry to force re-adding transactions that were previously dropped.
+    /// @returns Import result codes in the order of @a _txs.
+    std::vector<ImportResult> import(Transactions const& _txs, IfDropped _ik = IfDropped::Ignore);
+
     /// Remove transaction from the queue
     /// @param _txHash Trasnaction hash
     void drop(h256 const& _txHash);
@@ -91,10 +109,10 @@ public:
         size_t dropped;
     };
     /// @returns the status of the transaction queue.
-    Status status() const { Status ret; DEV_GUARDED(x_queue) { ret.unverified = m_unverified.size(); } ReadGuard l(m_lock); ret.dropped = m_dropped.size(); ret.current = m_currentByHash.size(); ret.future = m_future.size(); return ret; }
+    Status status() const { Status ret; DEV_GUARDED(x_queue) { ret.unverified = m_unverified.size(); } ReadGuard l(m_lock); ret.dropped = m_dropped.size(); ret.current = m_currentSize; ret.future = m_futureSize; return ret; }
 
     /// @returns the transacrtion limits on current/future.
-    Limits limits() const { return Limits{m_limit, m_futureLimit}; }
+    Limits limits() const { return Limits{m_limit, m_futureLimit, m_bytesLimit}; }
 
     /// Clear the queue
     void clear();
@@ -113,13 +131,18 @@ private:
     /// Verified and imported transaction
     struct VerifiedTransaction
     {
-        VerifiedTransaction(Transaction const& _t): transaction(_t) {}
-        VerifiedTransaction(VerifiedTransaction&& _t): transaction(std::move(_t.transaction)) {}
+        VerifiedTransaction(Transaction const& _t, h256 const& _hash, size_t _size)
+          : transaction(_t), hash(_hash), size(_size)
+        {}
+        VerifiedTransaction(VerifiedTransaction&&) = default;
+        VerifiedTransaction& operator=(VerifiedTransaction&&) = default;
 
         VerifiedTransaction(VerifiedTransaction const&) = delete;
         VerifiedTransaction& operator=(VerifiedTransaction const&) = delete;
 
         Transaction transaction;  ///< Transaction data
+        h256 hash;                ///< Transaction hash
+        size_t size;              ///< Size of the transaction RLP
     };
 
     /// Transaction pending verification
@@ -144,33 +167,69 @@ private:
         h512 nodeId;        ///< Network Id of the peer transaction comes from
     };
 
-    struct PriorityCompare
+    using NonceMap = std::map<u256, VerifiedTransaction>;
+
+    static constexpr size_t c_notInHeap = std::numeric_limits<size_t>::max();
+
+    /// Transactions of a single sender, ordered by nonce.
+    struct Lane
     {
-        TransactionQueue& queue;
-        /// Compare transaction by nonce height and gas price.
-        bool operator()(VerifiedTransaction const& _first, VerifiedTransaction const& _second) const
-        {
-            u256 const& height1 = _first.transaction.nonce() - queue.m_currentByAddressAndNonce[_first.transaction.sender()].begin()->first;
-            u256 const& height2 = _second.transaction.nonce() - queue.m_currentByAddressAndNonce[_second.transaction.sender()].begin()->first;
-            return height1 < height2 || (height1 == height2 && _first.transaction.gasPrice() > _second.transaction.gasPrice());
-        }
+        Address sender;
+        NonceMap current;  ///< Transactions returned by topTransactions.
+        NonceMap future;   ///< Transactions set aside until the preceding nonce is imported.
+
+        size_t headPosition = c_notInHeap;    ///< Position in m_heads.
+        size_t tailPosition = c_notInHeap;    ///< Position in m_tails.
+        size_t futurePosition = c_notInHeap;  ///< Position in m_futureTails.
     };
 
-    // Use a set with dynamic comparator for minmax priority queue. The comparator takes into account min account nonce. Updating it does not affect the order.
-    using PriorityQueue = std::multiset<VerifiedTransaction, PriorityCompare>;
+    /// Binary max-heap of lanes where every lane knows its position in the heap, so that a lane
+    /// whose key has changed can be moved or removed in O(log n).
+    class LaneHeap
+    {
+    public:
+        using Less = bool (*)(Lane const&, Lane const&);
+
+        LaneHeap(Less _less, size_t Lane::*_position): m_less(_less), m_position(_position) {}
+
+        /// Inserts, moves or removes the lane depending on whether it has a key.
+        void update(Lane& _lane, bool _hasKey);
+        void clear();
+
+        bool empty() const { return m_heap.empty(); }
+        Lane& top() const { return *m_heap.front(); }
+        /// @returns the underlying heap, the greatest lane first.
+        std::vector<Lane*> const& lanes() const { return m_heap; }
+
+    private:
+        void siftUp(size_t _i);
+        void siftDown(size_t _i);
+        void place(size_t _i, Lane* _lane);
+
+        Less m_less;
+        size_t Lane::*m_position;
+        std::vector<Lane*> m_heap;
+    };
 
     ImportResult import(bytesConstRef _tx, IfDropped _ik = IfDropped::Ignore);
     ImportResult check_WITH_LOCK(h256 const& _h, IfDropped _ik);
-    ImportResult manageImport_WITH_LOCK(h256 const& _h, Transaction const& _transaction);
-
-    void insertCurrent_WITH_LOCK(std::pair<h256, Transaction> const& _p);
-    void makeCurrent_WITH_LOCK(Transaction const& _t);
+    ImportResult manageImport_WITH_LOCK(h256 const& _h, Transaction const& _transaction, size_t _size);
+
+    /// Moves future transactions with nonces following @a _nonce to current.
+    bool makeCurrent_WITH_LOCK(Lane& _lane, u256 _nonce);
+    /// Evicts transactions until the queue is within its limits.
+    void enforceLimits_WITH_LOCK();
+    void evictFuture_WITH_LOCK();
+    void evictCurrent_WITH_LOCK();
     bool remove_WITH_LOCK(h256 const& _txHash);
+    void erase_WITH_LOCK(Lane& _lane, bool _future, NonceMap::iterator _it);
+    /// Repositions the lane in the heaps after its transactions have changed.
+    void updateLane_WITH_LOCK(Lane& _lane);
     u256 maxNonce_WITH_LOCK(Address const& _a) const;
     void verifierBody();
 
     mutable SharedMutex m_lock;  ///< General lock.
-    h256Hash m_known;            ///< Headers of transactions in both sets.
+    std::unordered_map<h256, std::pair<Address, u256>> m_known;  ///< Sender and nonce of transactions in both sets.
 
     std::unordered_map<h256, std::function<void(ImportResult)>> m_callbacks;	///< Called once.
 
@@ -179,19 +238,23 @@ private:
     ///< the number of transaction hashes stored.
     LruCache<h256, bool> m_dropped;
 
-    PriorityQueue m_current;
-    std::unordered_map<h256, PriorityQueue::iterator> m_currentByHash;			///< Transaction hash to set ref
-    std::unordered_map<Address, std::map<u256, PriorityQueue::iterator>> m_currentByAddressAndNonce; ///< Transactions grouped by account and nonce
-    std::unordered_map<Address, std::map<u256, VerifiedTransaction>> m_future;	/// Future transactions
+    std::unordered_map<Address, Lane> m_lanes;  ///< Transactions grouped by sender.
+    LaneHeap m_heads;        ///< Lanes with current transactions, highest priced first one first.
+    LaneHeap m_tails;        ///< Lanes with current transactions, cheapest last one first.
+    LaneHeap m_futureTails;  ///< Lanes with future transactions, cheapest last one first.
 
     Signal<> m_onReady;															///< Called when a subsequent call to import transactions will return a non-empty container. Be nice and exit fast.
     Signal<ImportResult, h256 const&, h512 const&> m_onImport;					///< Called for each import attempt. Arguments are result, transaction id an node id. Be nice and exit fast.
     Signal<h256 const&> m_onReplaced;											///< Called whan transction is dropped during a call to import() to make room for another transaction.
     unsigned m_limit;															///< Max number of pending transactions
     unsigned m_futureLimit;														///< Max number of future transactions
-    unsigned m_futureSize = 0;													///< Current number of future transactions
+    size_t m_bytesLimit;														///< Max total size of pending and future transactions
+    size_t m_currentSize = 0;													///< Current number of pending transactions
+    size_t m_futureSize = 0;													///< Current number of future transactions
+    size_t m_bytes = 0;															///< Current total size of pending and future transactions
 
     std::condition_variable m_queueReady;										///< Signaled when m_unverified has a new entry.
+    unsigned const m_verifierCount;												///< Number of verifier threads
     std::vector<std::thread> m_verifiers;
     std::deque<UnverifiedTransaction> m_unverified;  ///< Pending verification queue
     mutable Mutex x_queue;                           ///< Verification queue mutex
@@ -239,7 +239,7 @@ evmc::result EvmCHost::call(evmc_message const& _msg) noexcept
 }
 
 ExtVMFace::ExtVMFace(EnvInfo const& _envInfo, Address _myAddress, Address _caller, Address _origin,
-    u256 _value, u256 _gasPrice, bytesConstRef _data, bytes _code, h256 const& _codeHash,
+    u256 _value, u256 _gasPrice, bytesConstRef _data, bytesConstRef _code, h256 const& _codeHash,
     u256 const& _version, unsigned _depth, bool _isCreate, bool _staticCall)
   : m_envInfo(_envInfo),
     myAddress(_myAddress),
@@ -248,7 +248,7 @@ ExtVMFace::ExtVMFace(EnvInfo const& _envInfo, Address _myAddress, Address _calle
     value(_value),
     gasPrice(_gasPrice),
     data(_data),
-    code(std::move(_code)),
+    code(_code),
     codeHash(_codeHash),
     version(_version),
     depth(_depth),
@@ -18,6 +18,7 @@
 
 #include <boost/optional.hpp>
 #include <functional>
+#include <memory>
 #include <set>
 
 namespace dev
@@ -130,30 +131,37 @@ class EnvInfo
 public:
     EnvInfo(BlockHeader const& _current, LastBlockHashesFace const& _lh, u256 const& _gasUsed,
         u256 const& _chainID)
-      : m_headerInfo(_current), m_lastHashes(_lh), m_gasUsed(_gasUsed), m_chainID(_chainID)
+      : m_headerInfo(std::make_shared<BlockHeader const>(_current)),
+        m_lastHashes(_lh),
+        m_gasUsed(_gasUsed),
+        m_chainID(_chainID)
     {}
     // Constructor with custom gasLimit - used in some synthetic scenarios like eth_estimateGas RPC
     // method
     EnvInfo(BlockHeader const& _current, LastBlockHashesFace const& _lh, u256 const& _gasUsed,
         u256 const& _gasLimit, u256 const& _chainID)
-      : EnvInfo(_current, _lh, _gasUsed, _chainID)
+      : m_lastHashes(_lh), m_gasUsed(_gasUsed), m_chainID(_chainID)
     {
-        m_headerInfo.setGasLimit(_gasLimit);
+        auto header = std::make_shared<BlockHeader>(_current);
+        header->setGasLimit(_gasLimit);
+        m_headerInfo = std::move(header);
     }
 
-    BlockHeader const& header() const { return m_headerInfo; }
+    BlockHeader const& header() const { return *m_headerInfo; }
 
-    int64_t number() const { return m_headerInfo.number(); }
-    Address const& author() const { return m_headerInfo.author(); }
-    int64_t timestamp() const { return m_headerInfo.timestamp(); }
-    u256 const& difficulty() const { return m_headerInfo.difficulty(); }
-    u256 const& gasLimit() const { return m_headerInfo.gasLimit(); }
+    int64_t number() const { return m_headerInfo->number(); }
+    Address const& author() const { return m_headerInfo->author(); }
+    int64_t timestamp() const { return m_headerInfo->timestamp(); }
+    u256 const& difficulty() const { return m_headerInfo->difficulty(); }
+    u256 const& gasLimit() const { return m_headerInfo->gasLimit(); }
     LastBlockHashesFace const& lastHashes() const { return m_lastHashes; }
     u256 const& gasUsed() const { return m_gasUsed; }
     u256 const& chainID() const { return m_chainID; }
 
 private:
-    BlockHeader m_headerInfo;
+    /// Immutable and shared between copies, so that the nested frames of a transaction copy the
+    /// environment without copying the header.
+    std::shared_ptr<BlockHeader const> m_headerInfo;
     LastBlockHashesFace const& m_lastHashes;
     u256 m_gasUsed;
     u256 m_chainID;
@@ -194,8 +202,9 @@ class ExtVMFace
 public:
     /// Full constructor.
     ExtVMFace(EnvInfo const& _envInfo, Address _myAddress, Address _caller, Address _origin,
-        u256 _value, u256 _gasPrice, bytesConstRef _data, bytes _code, h256 const& _codeHash,
-        u256 const& _version, unsigned _depth, bool _isCreate, bool _staticCall);
+        u256 _value, u256 _gasPrice, bytesConstRef _data, bytesConstRef _code,
+        h256 const& _codeHash, u256 const& _version, unsigned _depth, bool _isCreate,
+        bool _staticCall);
 
     ExtVMFace(ExtVMFace const&) = delete;
     ExtVMFace& operator=(ExtVMFace const&) = delete;
@@ -268,7 +277,7 @@ public:
     u256 value;         ///< Value (in Wei) that was passed to this address.
     u256 gasPrice;      ///< Price of gas (that we already paid).
     bytesConstRef data;       ///< Current input data.
-    bytes code;               ///< Current code that is executing.
+    bytesConstRef code;       ///< Current code that is executing. Must outlive the execution.
     h256 codeHash;            ///< SHA3 hash of the executing code
     u256 version;             ///< Version of the VM to execute code
     u256 salt;                ///< Values used in new address construction by CREATE2
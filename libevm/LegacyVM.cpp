@@ -8,6 +8,20 @@ using namespace std;
 using namespace dev;
 using namespace dev::eth;
 
+void LegacyVM::acquireBuffers()
+{
+    auto& pool = VMMemoryPool::local();
+    m_mem = pool.acquire();
+    m_returnData = pool.acquire();
+}
+
+void LegacyVM::releaseBuffers()
+{
+    auto& pool = VMMemoryPool::local();
+    pool.release(std::move(m_mem));
+    pool.release(std::move(m_returnData));
+}
+
 uint64_t LegacyVM::memNeed(u256 const& _offset, u256 const& _size)
 {
     return toInt63(_size ? u512(_offset) + _size : u512(0));
@@ -177,7 +191,7 @@ void LegacyVM::updateMem(uint64_t _newMem)
     m_newMemSize = (_newMem + 31) / 32 * 32;
     updateGas();
     if (m_newMemSize > m_mem.size())
-        m_mem.resize(m_newMemSize);
+        VMMemoryPool::local().resize(m_mem, m_newMemSize);
 }
 
 void LegacyVM::logGasMem()
@@ -190,6 +204,8 @@ void LegacyVM::logGasMem()
 void LegacyVM::fetchInstruction()
 {
     m_OP = Instruction(m_code[m_PC]);
+    if (m_profiler)
+        m_profiler->step(static_cast<uint8_t>(m_OP));
     const InstructionMetric& metric = c_metrics[static_cast<size_t>(m_OP)];
     adjustStack(metric.args, metric.ret);
 
@@ -214,6 +230,23 @@ owning_bytes_ref LegacyVM::exec(u256& _io_gas, ExtVMFace& _ext, OnOpFunc const&
     m_onFail = &LegacyVM::onOperation; // this results in operations that fail being logged twice in the trace
     m_PC = 0;
 
+    // The instance may have run other frames before, start from a clean interpreter state.
+    m_SP = m_SPP = m_stackEnd;
+#if EIP_615
+    m_RP = m_return - 1;
+    m_frameSize.clear();
+#endif
+    m_nSteps = 0;
+    m_runGas = 0;
+    m_output = {};
+    m_jumpDests.clear();
+    m_beginSubs.clear();
+    m_pool.clear();
+    acquireBuffers();
+
+    if (VMProfiler::instance().enabled())
+        m_profiler.reset(new FrameProfiler{m_ext->codeHash, m_runGas});
+
     try
     {
         // trampoline to minimize depth of call stack when calling out
@@ -226,10 +259,14 @@ owning_bytes_ref LegacyVM::exec(u256& _io_gas, ExtVMFace& _ext, OnOpFunc const&
     catch (...)
     {
         *m_io_gas_p = m_io_gas;
+        m_profiler.reset();
+        releaseBuffers();
         throw;
     }
 
     *m_io_gas_p = m_io_gas;
+    m_profiler.reset();
+    releaseBuffers();
     return std::move(m_output);
 }
 
@@ -1354,7 +1391,7 @@ void LegacyVM::interpretCases()
             updateMem(memNeed(m_SP[0], m_SP[2]));
             updateIOGas();
 
-            copyDataToMemory(&m_ext->code, m_SP);
+            copyDataToMemory(m_ext->code, m_SP);
         }
         NEXT
 
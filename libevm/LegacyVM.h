@@ -7,12 +7,21 @@
 #include "Instruction.h"
 #include "LegacyVMConfig.h"
 #include "VMFace.h"
+#include "VMMemoryPool.h"
+#include "VMProfiler.h"
 
 namespace dev
 {
 namespace eth
 {
 
+/**
+ * @brief The interpreter of EVM bytecode.
+ *
+ * An instance may execute any number of frames, one at a time, keeping the code buffer and other
+ * allocations between them. The memory buffers of a frame come from and go back to the
+ * VMMemoryPool of the executing thread.
+ */
 class LegacyVM: public VMFace
 {
 public:
@@ -42,6 +51,8 @@ private:
     static void initMetrics();
     static u256 exp256(u256 _base, u256 _exponent);
     void copyCode(int);
+    void acquireBuffers();
+    void releaseBuffers();
     typedef void (LegacyVM::*MemFnPtr)();
     MemFnPtr m_bounce = 0;
     MemFnPtr m_onFail = 0;
@@ -133,6 +144,9 @@ private:
     uint64_t decodeJumpDest(const byte* const _code, uint64_t& _pc);
     uint64_t decodeJumpvDest(const byte* const _code, uint64_t& _pc, byte _voff);
 
+    /// Per-opcode counters of this frame, present only when profiling is enabled.
+    std::unique_ptr<FrameProfiler> m_profiler;
+
     template<class T> uint64_t toInt63(T v)
     {
         // check for overflow
@@ -141,7 +141,9 @@ void LegacyVM::caseCreate()
 
         CreateResult result = m_ext->create(endowment, gas, initCode, m_OP, salt, m_onOp);
         m_SPP[0] = (u160)result.address;  // Convert address to integer.
-        m_returnData = result.output.toBytes();
+        auto& pool = VMMemoryPool::local();
+        pool.assign(m_returnData, result.output.data(), result.output.size());
+        pool.release(result.output.takeBytes());
 
         *m_io_gas_p -= (createGas - gas);
         m_io_gas = uint64_t(*m_io_gas_p);
@@ -173,8 +175,10 @@ void LegacyVM::caseCall()
         //    higher memory footprint, no memory copy.
         // 2. Copy only the return data from the returned memory buffer:
         //    minimal memory footprint, additional memory copy.
-        // Option 2 used:
-        m_returnData = result.output.toBytes();
+        // Option 2 used, the returned buffer goes back to the memory pool:
+        auto& pool = VMMemoryPool::local();
+        pool.assign(m_returnData, result.output.data(), result.output.size());
+        pool.release(result.output.takeBytes());
 
         m_SPP[0] = result.status == EVMC_SUCCESS ? 1 : 0;
     }
@@ -233,6 +237,8 @@ bool LegacyVM::caseCallSetup(CallParameters *callParams, bytesRef& o_output)
         callParams->gas = std::min(m_SP[0], maxAllowedCallGas);
     }
 
+    if (m_profiler)
+        m_profiler->setOwnGas(m_runGas);
     m_runGas = toInt63(callParams->gas);
     updateIOGas();
 
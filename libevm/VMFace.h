@@ -27,6 +27,10 @@ ETH_SIMPLE_EXCEPTION_VM(BufferOverrun);
 /// differently than defined consensus exceptions.
 struct InternalVMError : Exception {};
 
+/// Execution exceeded its wall-clock budget; raised by the OnOpFunc of time-limited calls. This is
+/// not based on VMException because it must abort the whole call, not only fail the current frame.
+struct ExecutionTimeout : Exception {};
+
 /// Error info for EVMC status code.
 using errinfo_evmcStatusCode = boost::error_info<struct tag_evmcStatusCode, evmc_status_code>;
 
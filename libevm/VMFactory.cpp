@@ -156,6 +156,51 @@ po::options_description vmProgramOptions(unsigned _lineLength)
 }
 
 
+namespace
+{
+/// Idle LegacyVM instances of a thread. The frames of a thread are nested, so few instances serve
+/// any call depth and spare constructing the VM stack for every frame.
+class LegacyVMPool
+{
+public:
+    static LegacyVMPool& local()
+    {
+        static thread_local LegacyVMPool s_pool;
+        return s_pool;
+    }
+
+    LegacyVM* take()
+    {
+        if (m_free.empty())
+            return new LegacyVM;
+        LegacyVM* vm = m_free.back().release();
+        m_free.pop_back();
+        return vm;
+    }
+
+    void give(LegacyVM* _vm) noexcept
+    {
+        std::unique_ptr<LegacyVM> vm{_vm};
+        if (m_free.size() < c_maxIdle)
+        {
+            try
+            {
+                m_free.push_back(std::move(vm));
+            }
+            catch (...)
+            {
+            }
+        }
+    }
+
+private:
+    /// The maximum number of idle instances kept. Deeper call chains construct fresh ones.
+    static constexpr size_t c_maxIdle = 16;
+
+    std::vector<std::unique_ptr<LegacyVM>> m_free;
+};
+}  // namespace
+
 VMPtr VMFactory::create()
 {
     return create(g_kind);
@@ -165,6 +210,9 @@ VMPtr VMFactory::create(VMKind _kind)
 {
     static const auto default_delete = [](VMFace * _vm) noexcept { delete _vm; };
     static const auto null_delete = [](VMFace*) noexcept {};
+    static const auto legacy_recycle = [](VMFace* _vm) noexcept {
+        LegacyVMPool::local().give(static_cast<LegacyVM*>(_vm));
+    };
 
     switch (_kind)
     {
@@ -176,7 +224,7 @@ VMPtr VMFactory::create(VMKind _kind)
         return {g_evmcDll.get(), null_delete};
     case VMKind::Legacy:
     default:
-        return {new LegacyVM, default_delete};
+        return {LegacyVMPool::local().take(), legacy_recycle};
     }
 }
 }  // namespace eth
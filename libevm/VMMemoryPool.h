@@ -0,0 +1,105 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+#pragma once
+
+#include <libdevcore/Common.h>
+
+namespace dev
+{
+namespace eth
+{
+/// Allocation counters of the VM memory pool of a single thread. The counters are cumulative over
+/// the lifetime of the thread and never reset; the share of some work is the difference of the
+/// counters taken before and after it.
+struct VMMemoryStats
+{
+    uint64_t frames = 0;       ///< Buffers handed out to VM frames.
+    uint64_t reused = 0;       ///< Buffers served from the pool instead of fresh ones.
+    uint64_t allocations = 0;  ///< Heap allocations made to grow a buffer.
+};
+
+inline VMMemoryStats operator-(VMMemoryStats const& _a, VMMemoryStats const& _b)
+{
+    return {_a.frames - _b.frames, _a.reused - _b.reused, _a.allocations - _b.allocations};
+}
+
+/**
+ * @brief Per-thread pool of the memory and return data buffers used by VM frames.
+ *
+ * Buffers returned to the pool keep their capacity, which saves the heap allocations of the next
+ * frames using them. Memory expansion still zero-fills the newly exposed bytes, as EVM memory
+ * must read as zero. The pool lives for the lifetime of the thread, so it is shared by all frames and transactions
+ * executed on it.
+ */
+class VMMemoryPool
+{
+public:
+    /// @returns the pool of the calling thread.
+    static VMMemoryPool& local();
+
+    /// @returns an empty buffer, reusing a released one if available.
+    bytes acquire();
+    /// Returns the buffer to the pool. Oversized buffers are freed instead.
+    void release(bytes&& _buffer);
+
+    /// Resizes the buffer, zero-filling any newly exposed bytes and counting heap allocations.
+    void resize(bytes& _buffer, size_t _size);
+    /// Replaces the content of the buffer with the given data, counting heap allocations.
+    void assign(bytes& _buffer, byte const* _data, size_t _size);
+
+    VMMemoryStats const& stats() const { return m_stats; }
+
+private:
+    /// The maximum number of buffers kept for reuse.
+    static constexpr size_t c_maxBuffers = 64;
+    /// The maximum capacity of a buffer kept for reuse. Bigger buffers are freed on release.
+    static constexpr size_t c_maxBufferCapacity = 4 * 1024 * 1024;
+
+    std::vector<bytes> m_free;
+    VMMemoryStats m_stats;
+};
+
+inline VMMemoryPool& VMMemoryPool::local()
+{
+    static thread_local VMMemoryPool s_pool;
+    return s_pool;
+}
+
+inline bytes VMMemoryPool::acquire()
+{
+    ++m_stats.frames;
+    if (m_free.empty())
+        return {};
+
+    ++m_stats.reused;
+    bytes buffer = std::move(m_free.back());
+    m_free.pop_back();
+    return buffer;
+}
+
+inline void VMMemoryPool::release(bytes&& _buffer)
+{
+    if (_buffer.capacity() == 0 || _buffer.capacity() > c_maxBufferCapacity ||
+        m_free.size() >= c_maxBuffers)
+        return;
+
+    _buffer.clear();
+    m_free.push_back(std::move(_buffer));
+}
+
+inline void VMMemoryPool::resize(bytes& _buffer, size_t _size)
+{
+    if (_size > _buffer.capacity())
+        ++m_stats.allocations;
+    _buffer.resize(_size);
+}
+
+inline void VMMemoryPool::assign(bytes& _buffer, byte const* _data, size_t _size)
+{
+    if (_size > _buffer.capacity())
+        ++m_stats.allocations;
+    _buffer.assign(_data, _data + _size);
+}
+}  // namespace eth
+}  // namespace dev
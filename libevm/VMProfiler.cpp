@@ -0,0 +1,52 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+#include "VMProfiler.h"
+#include "Instruction.h"
+
+#include <sstream>
+
+namespace dev
+{
+namespace eth
+{
+namespace
+{
+std::string opcodeName(size_t _op)
+{
+    if (auto const name = instructionInfo(static_cast<Instruction>(_op)).name)
+        return name;
+
+    std::ostringstream o;
+    o << "0x" << std::hex << _op;
+    return o.str();
+}
+}  // namespace
+
+std::string foldedStacks(VMProfiles const& _profiles)
+{
+    std::ostringstream o;
+    for (auto const& profile : _profiles)
+        for (size_t op = 0; op < profile.second.size(); ++op)
+            if (profile.second[op].count)
+                o << profile.first.hex() << ';' << opcodeName(op) << ' '
+                  << profile.second[op].cycles << '\n';
+    return o.str();
+}
+
+std::string profileTable(VMProfiles const& _profiles)
+{
+    std::ostringstream o;
+    o << "code hash,opcode,count,cycles,gas\n";
+    for (auto const& profile : _profiles)
+        for (size_t op = 0; op < profile.second.size(); ++op)
+        {
+            auto const& counters = profile.second[op];
+            if (counters.count)
+                o << profile.first.hex() << ',' << opcodeName(op) << ',' << counters.count << ','
+                  << counters.cycles << ',' << counters.gas << '\n';
+        }
+    return o.str();
+}
+}  // namespace eth
+}  // namespace dev
@@ -0,0 +1,207 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+#pragma once
+
+#include <libdevcore/FixedHash.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#endif
+
+namespace dev
+{
+namespace eth
+{
+/// Counters of a single opcode.
+struct OpcodeCounters
+{
+    uint64_t count = 0;   ///< Number of executions.
+    uint64_t cycles = 0;  ///< Time spent, excluding nested calls, in CPU cycles (or clock ticks).
+    uint64_t gas = 0;     ///< Gas charged, excluding gas forwarded to nested calls.
+};
+
+/// Counters of all opcodes, indexed by opcode.
+using OpcodeProfile = std::array<OpcodeCounters, 256>;
+
+/// Opcode profiles keyed by the hash of the executed code.
+using VMProfiles = std::unordered_map<h256, OpcodeProfile>;
+
+/**
+ * @brief Process-wide collector of per-opcode and per-code-hash execution counters.
+ *
+ * Profiling is off by default. When on, every VM frame counts into a FrameProfiler of its own
+ * and merges it into the collector when the frame ends, so the only shared state touched on
+ * the hot path is the enabled flag read at frame entry.
+ */
+class VMProfiler
+{
+public:
+    static VMProfiler& instance();
+
+    bool enabled() const noexcept { return m_enabled.load(std::memory_order_relaxed); }
+    void setEnabled(bool _enabled) noexcept { m_enabled.store(_enabled, std::memory_order_relaxed); }
+
+    /// Adds the counters of a finished frame.
+    void add(h256 const& _codeHash, OpcodeProfile const& _profile);
+
+    /// @returns a copy of the counters collected so far.
+    VMProfiles profiles() const;
+    /// Drops the counters collected so far.
+    void reset();
+
+private:
+    std::atomic<bool> m_enabled{false};
+    mutable std::mutex x_profiles;
+    VMProfiles m_profiles;
+};
+
+/**
+ * @brief Counts the instructions of a single VM frame.
+ *
+ * The VM calls step() before each instruction. The time since the previous step, minus the time
+ * spent in nested frames, and the gas the VM charged meanwhile are attributed to the previous
+ * instruction. The last instruction is accounted for on destruction.
+ */
+class FrameProfiler
+{
+public:
+    /// @param _runGas  The VM's gas charge of the current instruction.
+    FrameProfiler(h256 const& _codeHash, uint64_t const& _runGas);
+    ~FrameProfiler();
+
+    FrameProfiler(FrameProfiler const&) = delete;
+    FrameProfiler& operator=(FrameProfiler const&) = delete;
+
+    void step(uint8_t _nextOp) noexcept;
+
+    /// Sets the gas charge of the current instruction, for the calls which go on to charge the gas
+    /// they forward to the nested frame.
+    void setOwnGas(uint64_t _gas) noexcept
+    {
+        m_ownGas = _gas;
+        m_hasOwnGas = true;
+    }
+
+    /// @returns CPU timestamp counter or, where it is not available, a steady clock reading.
+    static uint64_t now() noexcept;
+
+private:
+    void countCurrent(uint64_t _now) noexcept;
+
+    /// @returns the profiler of the innermost frame running on the calling thread.
+    static FrameProfiler*& current() noexcept;
+
+    h256 m_codeHash;
+    uint64_t const& m_runGas;
+    FrameProfiler* m_parent = nullptr;
+    std::unique_ptr<OpcodeProfile> m_profile{new OpcodeProfile{}};
+    int m_op = -1;               ///< The instruction being executed or -1 before the first one.
+    uint64_t m_start = 0;        ///< When the frame started.
+    uint64_t m_last = 0;         ///< When the current instruction started.
+    uint64_t m_nestedCycles = 0; ///< Time spent in nested frames during the current instruction.
+    uint64_t m_ownGas = 0;       ///< The gas charge set by setOwnGas().
+    bool m_hasOwnGas = false;    ///< Whether the current instruction's charge is m_ownGas.
+};
+
+inline VMProfiler& VMProfiler::instance()
+{
+    static VMProfiler s_instance;
+    return s_instance;
+}
+
+inline void VMProfiler::add(h256 const& _codeHash, OpcodeProfile const& _profile)
+{
+    std::lock_guard<std::mutex> l(x_profiles);
+    auto& profile = m_profiles[_codeHash];
+    for (size_t i = 0; i < profile.size(); ++i)
+    {
+        profile[i].count += _profile[i].count;
+        profile[i].cycles += _profile[i].cycles;
+        profile[i].gas += _profile[i].gas;
+    }
+}
+
+inline VMProfiles VMProfiler::profiles() const
+{
+    std::lock_guard<std::mutex> l(x_profiles);
+    return m_profiles;
+}
+
+inline void VMProfiler::reset()
+{
+    std::lock_guard<std::mutex> l(x_profiles);
+    m_profiles.clear();
+}
+
+inline FrameProfiler::FrameProfiler(h256 const& _codeHash, uint64_t const& _runGas)
+  : m_codeHash{_codeHash}, m_runGas{_runGas}, m_parent{current()}, m_start{now()}
+{
+    m_last = m_start;
+    current() = this;
+}
+
+inline FrameProfiler::~FrameProfiler()
+{
+    auto const end = now();
+    countCurrent(end);
+    current() = m_parent;
+    if (m_parent)
+        m_parent->m_nestedCycles += end - m_start;
+    VMProfiler::instance().add(m_codeHash, *m_profile);
+}
+
+inline void FrameProfiler::step(uint8_t _nextOp) noexcept
+{
+    auto const t = now();
+    countCurrent(t);
+    m_op = _nextOp;
+    m_last = t;
+}
+
+inline void FrameProfiler::countCurrent(uint64_t _now) noexcept
+{
+    if (m_op < 0)
+        return;
+
+    auto& counters = (*m_profile)[static_cast<size_t>(m_op)];
+    auto const elapsed = _now - m_last;
+    ++counters.count;
+    counters.cycles += elapsed > m_nestedCycles ? elapsed - m_nestedCycles : 0;
+    counters.gas += m_hasOwnGas ? m_ownGas : m_runGas;
+    m_nestedCycles = 0;
+    m_hasOwnGas = false;
+}
+
+inline uint64_t FrameProfiler::now() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    return __rdtsc();
+#else
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+inline FrameProfiler*& FrameProfiler::current() noexcept
+{
+    static thread_local FrameProfiler* s_current = nullptr;
+    return s_current;
+}
+
+/// @returns the profiles in the folded stacks format of flamegraph.pl, one
+/// "<code hash>;<opcode> <cycles>" line per executed opcode.
+std::string foldedStacks(VMProfiles const& _profiles);
+
+/// @returns the profiles as a table of code hash, opcode, count, cycles and gas per line.
+std::string profileTable(VMProfiles const& _profiles);
+}  // namespace eth
+}  // namespace dev
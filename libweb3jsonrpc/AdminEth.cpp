@@ -8,6 +8,8 @@
 #include <libethereum/Client.h>
 #include <libethereum/Executive.h>
 #include <libethereum/StandardTrace.h>
+#include <libevm/Instruction.h>
+#include <libevm/VMProfiler.h>
 using namespace std;
 using namespace dev;
 using namespace dev::rpc;
@@ -214,6 +216,45 @@ Json::Value AdminEth::admin_eth_vmTrace(string const& _blockNumberOrHash, int _t
     return ret;
 }
 
+bool AdminEth::admin_eth_setVMProfiling(bool _on, string const& _session)
+{
+    RPC_ADMIN;
+    auto& profiler = VMProfiler::instance();
+    if (_on && !profiler.enabled())
+        profiler.reset();
+    profiler.setEnabled(_on);
+    return true;
+}
+
+Json::Value AdminEth::admin_eth_vmProfile(string const& _session)
+{
+    RPC_ADMIN;
+    VMProfiles const profiles = VMProfiler::instance().profiles();
+
+    Json::Value entries{Json::arrayValue};
+    for (auto const& codeProfile : profiles)
+        for (size_t op = 0; op < codeProfile.second.size(); ++op)
+        {
+            auto const& counters = codeProfile.second[op];
+            if (!counters.count)
+                continue;
+            auto const name = instructionInfo(static_cast<Instruction>(op)).name;
+            Json::Value entry;
+            entry["codeHash"] = toJS(codeProfile.first);
+            entry["opcode"] = name ? name : toJS(static_cast<byte>(op));
+            entry["count"] = toJS(counters.count);
+            entry["cycles"] = toJS(counters.cycles);
+            entry["gas"] = toJS(counters.gas);
+            entries.append(entry);
+        }
+
+    Json::Value ret;
+    ret["enabled"] = VMProfiler::instance().enabled();
+    ret["profile"] = entries;
+    ret["folded"] = foldedStacks(profiles);
+    return ret;
+}
+
 Json::Value AdminEth::admin_eth_getReceiptByHashAndIndex(string const& _blockNumberOrHash, int _txIndex, string const& _session)
 {
     RPC_ADMIN;
@@ -26,6 +26,8 @@ namespace dev {
                     this->bindAndAddMethod(jsonrpc::Procedure("admin_eth_setMiningBenefactor", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_BOOLEAN, "param1",jsonrpc::JSON_STRING,"param2",jsonrpc::JSON_STRING, NULL), &dev::rpc::AdminEthFace::admin_eth_setMiningBenefactorI);
                     this->bindAndAddMethod(jsonrpc::Procedure("admin_eth_inspect", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_OBJECT, "param1",jsonrpc::JSON_STRING,"param2",jsonrpc::JSON_STRING, NULL), &dev::rpc::AdminEthFace::admin_eth_inspectI);
                     this->bindAndAddMethod(jsonrpc::Procedure("admin_eth_vmTrace", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_OBJECT, "param1",jsonrpc::JSON_STRING,"param2",jsonrpc::JSON_INTEGER,"param3",jsonrpc::JSON_STRING, NULL), &dev::rpc::AdminEthFace::admin_eth_vmTraceI);
+                    this->bindAndAddMethod(jsonrpc::Procedure("admin_eth_setVMProfiling", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_BOOLEAN, "param1",jsonrpc::JSON_BOOLEAN,"param2",jsonrpc::JSON_STRING, NULL), &dev::rpc::AdminEthFace::admin_eth_setVMProfilingI);
+                    this->bindAndAddMethod(jsonrpc::Procedure("admin_eth_vmProfile", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_OBJECT, "param1",jsonrpc::JSON_STRING, NULL), &dev::rpc::AdminEthFace::admin_eth_vmProfileI);
                     this->bindAndAddMethod(jsonrpc::Procedure("admin_eth_getReceiptByHashAndIndex", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_OBJECT, "param1",jsonrpc::JSON_STRING,"param2",jsonrpc::JSON_INTEGER,"param3",jsonrpc::JSON_STRING, NULL), &dev::rpc::AdminEthFace::admin_eth_getReceiptByHashAndIndexI);
                     this->bindAndAddMethod(jsonrpc::Procedure("miner_start", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_BOOLEAN, "param1",jsonrpc::JSON_INTEGER, NULL), &dev::rpc::AdminEthFace::miner_startI);
                     this->bindAndAddMethod(jsonrpc::Procedure("miner_stop", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_BOOLEAN,  NULL), &dev::rpc::AdminEthFace::miner_stopI);
@@ -83,6 +85,14 @@ namespace dev {
                 {
                     response = this->admin_eth_vmTrace(request[0u].asString(), request[1u].asInt(), request[2u].asString());
                 }
+                inline virtual void admin_eth_setVMProfilingI(const Json::Value &request, Json::Value &response)
+                {
+                    response = this->admin_eth_setVMProfiling(request[0u].asBool(), request[1u].asString());
+                }
+                inline virtual void admin_eth_vmProfileI(const Json::Value &request, Json::Value &response)
+                {
+                    response = this->admin_eth_vmProfile(request[0u].asString());
+                }
                 inline virtual void admin_eth_getReceiptByHashAndIndexI(const Json::Value &request, Json::Value &response)
                 {
                     response = this->admin_eth_getReceiptByHashAndIndex(request[0u].asString(), request[1u].asInt(), request[2u].asString());
@@ -125,6 +135,8 @@ namespace dev {
                 virtual bool admin_eth_setMiningBenefactor(const std::string& param1, const std::string& param2) = 0;
                 virtual Json::Value admin_eth_inspect(const std::string& param1, const std::string& param2) = 0;
                 virtual Json::Value admin_eth_vmTrace(const std::string& param1, int param2, const std::string& param3) = 0;
+                virtual bool admin_eth_setVMProfiling(bool param1, const std::string& param2) = 0;
+                virtual Json::Value admin_eth_vmProfile(const std::string& param1) = 0;
                 virtual Json::Value admin_eth_getReceiptByHashAndIndex(const std::string& param1, int param2, const std::string& param3) = 0;
                 virtual bool miner_start(int param1) = 0;
                 virtual bool miner_stop() = 0;
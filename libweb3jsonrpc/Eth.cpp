@@ -21,9 +21,16 @@ using namespace eth;
 using namespace shh;
 using namespace dev::rpc;
 
-Eth::Eth(eth::Interface& _eth, eth::AccountHolder& _ethAccounts):
+namespace
+{
+/// Maximum number of calls waiting for a thread, above which they are rejected.
+constexpr size_t c_maxQueuedCalls = 1024;
+}
+
+Eth::Eth(eth::Interface& _eth, eth::AccountHolder& _ethAccounts, unsigned _callThreads):
 	m_eth(_eth),
-	m_ethAccounts(_ethAccounts)
+	m_ethAccounts(_ethAccounts),
+	m_callPool("rpc-call", _callThreads, c_maxQueuedCalls)
 {
 }
 
@@ -311,9 +318,22 @@ string Eth::eth_call(Json::Value const& _json, string const& _blockNumber)
 	{
 		TransactionSkeleton t = toTransactionSkeleton(_json);
 		setTransactionDefaults(t);
-		ExecutionResult er = client()->call(t.from, t.value, t.to, t.data, t.gas, t.gasPrice, jsToBlockNumber(_blockNumber), FudgeFactor::Lenient);
+		BlockNumber const blockNumber = jsToBlockNumber(_blockNumber);
+		ExecutionResult er = m_callPool.run([&] {
+			return client()->call(t.from, t.value, t.to, t.data, t.gas, t.gasPrice, blockNumber, FudgeFactor::Lenient);
+		});
+		if (er.excepted == TransactionException::ExecutionTimeout)
+			BOOST_THROW_EXCEPTION(JsonRpcException("Call execution timed out"));
 		return toJS(er.output);
 	}
+	catch (JsonRpcException const&)
+	{
+		throw;
+	}
+	catch (ThreadPoolFull const&)
+	{
+		BOOST_THROW_EXCEPTION(JsonRpcException("Too many calls in progress"));
+	}
 	catch (...)
 	{
 		BOOST_THROW_EXCEPTION(JsonRpcException(Errors::ERROR_RPC_INVALID_PARAMS));
@@ -327,7 +347,20 @@ string Eth::eth_estimateGas(Json::Value const& _json)
 		TransactionSkeleton t = toTransactionSkeleton(_json);
 		setTransactionDefaults(t);
 		int64_t gas = static_cast<int64_t>(t.gas);
-		return toJS(client()->estimateGas(t.from, t.value, t.to, t.data, gas, t.gasPrice, PendingBlock).first);
+		auto const estimate = m_callPool.run([&] {
+			return client()->estimateGas(t.from, t.value, t.to, t.data, gas, t.gasPrice, PendingBlock);
+		});
+		if (estimate.second.excepted == TransactionException::ExecutionTimeout)
+			BOOST_THROW_EXCEPTION(JsonRpcException("Gas estimation timed out"));
+		return toJS(estimate.first);
+	}
+	catch (JsonRpcException const&)
+	{
+		throw;
+	}
+	catch (ThreadPoolFull const&)
+	{
+		BOOST_THROW_EXCEPTION(JsonRpcException("Too many calls in progress"));
 	}
 	catch (...)
 	{
@@ -572,6 +605,14 @@ Json::Value Eth::eth_getFilterLogs(string const& _filterId)
 	{
 		return toJson(client()->logs(jsToInt(_filterId)));
 	}
+	catch (TooManyLogs const&)
+	{
+		BOOST_THROW_EXCEPTION(JsonRpcException("Query returned too many logs, narrow its block range"));
+	}
+	catch (LogQueryTimeout const&)
+	{
+		BOOST_THROW_EXCEPTION(JsonRpcException("Log query timed out"));
+	}
 	catch (...)
 	{
 		BOOST_THROW_EXCEPTION(JsonRpcException(Errors::ERROR_RPC_INVALID_PARAMS));
@@ -584,6 +625,14 @@ Json::Value Eth::eth_getFilterLogsEx(string const& _filterId)
 	{
 		return toJsonByBlock(client()->logs(jsToInt(_filterId)));
 	}
+	catch (TooManyLogs const&)
+	{
+		BOOST_THROW_EXCEPTION(JsonRpcException("Query returned too many logs, narrow its block range"));
+	}
+	catch (LogQueryTimeout const&)
+	{
+		BOOST_THROW_EXCEPTION(JsonRpcException("Log query timed out"));
+	}
 	catch (...)
 	{
 		BOOST_THROW_EXCEPTION(JsonRpcException(Errors::ERROR_RPC_INVALID_PARAMS));
@@ -596,6 +645,14 @@ Json::Value Eth::eth_getLogs(Json::Value const& _json)
 	{
 		return toJson(client()->logs(toLogFilter(_json, *client())));
 	}
+	catch (TooManyLogs const&)
+	{
+		BOOST_THROW_EXCEPTION(JsonRpcException("Query returned too many logs, narrow its block range"));
+	}
+	catch (LogQueryTimeout const&)
+	{
+		BOOST_THROW_EXCEPTION(JsonRpcException("Log query timed out"));
+	}
 	catch (...)
 	{
 		BOOST_THROW_EXCEPTION(JsonRpcException(Errors::ERROR_RPC_INVALID_PARAMS));
@@ -608,6 +665,14 @@ Json::Value Eth::eth_getLogsEx(Json::Value const& _json)
 	{
 		return toJsonByBlock(client()->logs(toLogFilter(_json)));
 	}
+	catch (TooManyLogs const&)
+	{
+		BOOST_THROW_EXCEPTION(JsonRpcException("Query returned too many logs, narrow its block range"));
+	}
+	catch (LogQueryTimeout const&)
+	{
+		BOOST_THROW_EXCEPTION(JsonRpcException("Log query timed out"));
+	}
 	catch (...)
 	{
 		BOOST_THROW_EXCEPTION(JsonRpcException(Errors::ERROR_RPC_INVALID_PARAMS));
@@ -10,6 +10,7 @@
 #include <jsonrpccpp/common/exception.h>
 #include <jsonrpccpp/server.h>
 #include <libdevcore/Common.h>
+#include <libdevcore/ThreadPool.h>
 #include <libethashseal/Ethash.h>
 #include <libethereum/Client.h>
 #include <iosfwd>
@@ -44,7 +45,9 @@ std::string exceptionToErrorMessage();
 class Eth: public dev::rpc::EthFace
 {
 public:
-	Eth(eth::Interface& _eth, eth::AccountHolder& _ethAccounts);
+	/// @param _callThreads  Number of threads executing eth_call and eth_estimateGas, the
+	/// hardware concurrency if 0.
+	Eth(eth::Interface& _eth, eth::AccountHolder& _ethAccounts, unsigned _callThreads = 0);
 
 	virtual RPCModules implementedModules() const override
 	{
@@ -114,6 +117,9 @@ protected:
 
     eth::Interface& m_eth;
 	eth::AccountHolder& m_ethAccounts;
+	/// Runs the EVM work of eth_call and eth_estimateGas, so that the number of executions in
+	/// flight is capped however many connections there are.
+	ThreadPool m_callPool;
 
 };
 
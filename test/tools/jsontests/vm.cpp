@@ -22,7 +22,7 @@ namespace fs = boost::filesystem;
 
 FakeExtVM::FakeExtVM(EnvInfo const& _envInfo, unsigned _depth)
   :  /// TODO: XXX: remove the default argument & fix.
-    ExtVMFace(_envInfo, Address(), Address(), Address(), 0, 1, bytesConstRef(), bytes(), EmptySHA3,
+    ExtVMFace(_envInfo, Address(), Address(), Address(), 0, 1, bytesConstRef(), bytesConstRef(), EmptySHA3,
         0, _depth, false, false)
 {}
 
@@ -173,11 +173,11 @@ void FakeExtVM::importExec(mObject const& _o)
     execGas = gas;
 
     thisTxCode.clear();
-    code = thisTxCode;
+    code.reset();
 
     thisTxCode = importCode(_o);
     if (_o.count("code") == 0 || (_o.at("code").type() != str_type && _o.at("code").type() != array_type))
-        code.clear();
+        code.reset();
 
     thisTxData.clear();
     thisTxData = importData(_o);
@@ -321,7 +321,7 @@ json_spirit::mValue VmTestSuite::doTests(json_spirit::mValue const& _input, bool
         if (fev.code.empty())
         {
             fev.thisTxCode = get<3>(fev.addresses.at(fev.myAddress));
-            fev.code = fev.thisTxCode;
+            fev.code = &fev.thisTxCode;
         }
         fev.codeHash = sha3(fev.code);
 
@@ -0,0 +1,91 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#include <libdevcore/BufferedDB.h>
+#include <libdevcore/MemoryDB.h>
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::db;
+
+namespace
+{
+class BufferedDBTest : public testing::Test
+{
+public:
+    shared_ptr<MemoryDB> disk = make_shared<MemoryDB>();
+    BufferedDB db{disk};
+};
+}  // namespace
+
+TEST_F(BufferedDBTest, writesDirectlyUntilBuffered)
+{
+    db.insert(Slice("a"), Slice("1"));
+    EXPECT_EQ(disk->lookup(Slice("a")), "1");
+
+    db.buffer();
+    db.insert(Slice("b"), Slice("2"));
+    db.kill(Slice("a"));
+    EXPECT_EQ(db.lookup(Slice("b")), "2");
+    EXPECT_FALSE(db.exists(Slice("a")));
+
+    // The disk is untouched until the flush.
+    EXPECT_EQ(disk->lookup(Slice("a")), "1");
+    EXPECT_FALSE(disk->exists(Slice("b")));
+
+    db.unbuffer();
+    EXPECT_EQ(disk->lookup(Slice("b")), "2");
+
+    db.insert(Slice("c"), Slice("3"));
+    EXPECT_EQ(disk->lookup(Slice("c")), "3");
+}
+
+TEST_F(BufferedDBTest, keepsCommittedBatchesUntilFlushed)
+{
+    db.buffer();
+    auto batch = db.createWriteBatch();
+    batch->insert(Slice("a"), Slice("1"));
+    batch->insert(Slice("b"), Slice("2"));
+    batch->kill(Slice("b"));
+    db.commit(move(batch));
+
+    EXPECT_EQ(db.lookup(Slice("a")), "1");
+    EXPECT_FALSE(db.exists(Slice("b")));
+    EXPECT_EQ(disk->size(), 0u);
+
+    db.flush();
+    EXPECT_EQ(disk->lookup(Slice("a")), "1");
+    EXPECT_FALSE(disk->exists(Slice("b")));
+
+    // Still buffering after the flush.
+    db.insert(Slice("c"), Slice("3"));
+    EXPECT_FALSE(disk->exists(Slice("c")));
+}
+
+TEST_F(BufferedDBTest, passesBatchesThroughUntilBuffered)
+{
+    auto batch = db.createWriteBatch();
+    EXPECT_TRUE(dynamic_cast<MemoryDBWriteBatch*>(batch.get()));
+    batch->insert(Slice("a"), Slice("1"));
+    db.commit(move(batch));
+    EXPECT_EQ(disk->lookup(Slice("a")), "1");
+}
+
+TEST_F(BufferedDBTest, forEachSeesTheWritesKept)
+{
+    disk->insert(Slice("a"), Slice("1"));
+    disk->insert(Slice("b"), Slice("2"));
+    db.buffer();
+    db.insert(Slice("b"), Slice("3"));
+    db.insert(Slice("c"), Slice("4"));
+    db.kill(Slice("a"));
+
+    map<string, string> records;
+    db.forEach([&](Slice _key, Slice _value) {
+        records[_key.toString()] = _value.toString();
+        return true;
+    });
+    EXPECT_EQ(records, (map<string, string>{{"b", "3"}, {"c", "4"}}));
+}
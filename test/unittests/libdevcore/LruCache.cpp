@@ -79,6 +79,25 @@ TEST(LruCache, BasicOperations)
     }
 }
 
+TEST(LruCache, Find)
+{
+    LRU lruCache{c_capacity};
+    VEC testData = Populate(lruCache, lruCache.capacity());
+
+    auto const oldest = testData.back();
+    auto const value = lruCache.find(oldest.first);
+    ASSERT_NE(value, nullptr);
+    EXPECT_EQ(*value, oldest.second);
+
+    // The found item became the most recently used one.
+    testData.pop_back();
+    testData.insert(testData.begin(), oldest);
+    VerifyEquals(lruCache, testData);
+
+    lruCache.remove(oldest.first);
+    EXPECT_EQ(lruCache.find(oldest.first), nullptr);
+}
+
 TEST(LruCache, AdvancedOperations)
 {
     LRU lruCache{c_capacity};
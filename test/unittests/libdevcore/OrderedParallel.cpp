@@ -0,0 +1,60 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#include <libdevcore/OrderedParallel.h>
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+using namespace std;
+using namespace dev;
+
+TEST(OrderedParallel, consumesInOrder)
+{
+    vector<size_t> consumed;
+    forEachInOrder<size_t>(1000, 4, "test", [](size_t _i) { return _i * 2; },
+        [&](size_t& _value) { consumed.push_back(_value); });
+
+    ASSERT_EQ(consumed.size(), 1000u);
+    for (size_t i = 0; i < consumed.size(); ++i)
+        EXPECT_EQ(consumed[i], i * 2);
+}
+
+TEST(OrderedParallel, throwsFirstErrorAfterValuesBefore)
+{
+    vector<size_t> consumed;
+    auto const produce = [](size_t _i) {
+        if (_i == 100 || _i == 200)
+            throw runtime_error(to_string(_i));
+        return _i;
+    };
+    try
+    {
+        forEachInOrder<size_t>(1000, 4, "test", produce,
+            [&](size_t& _value) { consumed.push_back(_value); });
+        FAIL();
+    }
+    catch (runtime_error const& _e)
+    {
+        EXPECT_EQ(string(_e.what()), "100");
+    }
+    EXPECT_EQ(consumed.size(), 100u);
+
+    EXPECT_THROW(forEachInOrder<size_t>(1000, 4, "test", [](size_t _i) { return _i; },
+                     [](size_t& _value) {
+                         if (_value == 10)
+                             throw runtime_error("consume");
+                     }),
+        runtime_error);
+}
+
+TEST(OrderedParallel, doesNothingWithoutValues)
+{
+    bool called = false;
+    forEachInOrder<size_t>(0, 4, "test", [&](size_t _i) {
+        called = true;
+        return _i;
+    }, [&](size_t&) { called = true; });
+    EXPECT_FALSE(called);
+}
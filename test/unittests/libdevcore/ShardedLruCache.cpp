@@ -0,0 +1,83 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#include <libdevcore/ShardedLruCache.h>
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace std;
+using namespace dev;
+
+namespace
+{
+using Cache = ShardedLruCache<int, string>;
+
+size_t stringSize(string const& _s)
+{
+    return _s.size();
+}
+}  // namespace
+
+TEST(ShardedLruCache, findCountsHitsAndMisses)
+{
+    Cache cache{1024 * 1024, stringSize};
+    cache.insert(1, "one");
+
+    EXPECT_EQ(*cache.find(1), "one");
+    EXPECT_FALSE(cache.find(2));
+    EXPECT_TRUE(cache.contains(1));
+
+    LruCacheStats const stats = cache.stats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.entries, 1u);
+    EXPECT_EQ(stats.bytes, 3u);
+}
+
+TEST(ShardedLruCache, emplaceKeepsCachedValue)
+{
+    Cache cache{1024 * 1024, stringSize};
+    cache.insert(1, "new");
+
+    EXPECT_EQ(cache.emplace(1, "old"), "new");
+    EXPECT_EQ(cache.emplace(2, "two"), "two");
+    EXPECT_EQ(*cache.find(1), "new");
+}
+
+TEST(ShardedLruCache, modifyLoadsAndResizes)
+{
+    Cache cache{1024 * 1024, stringSize};
+    cache.modify(1, [] { return string("ab"); }, [](string& _s) { _s += "cd"; });
+
+    EXPECT_EQ(*cache.find(1), "abcd");
+    EXPECT_EQ(cache.stats().bytes, 4u);
+
+    cache.modify(1, [] { return string("unused"); }, [](string& _s) { _s.resize(1); });
+    EXPECT_EQ(*cache.find(1), "a");
+    EXPECT_EQ(cache.stats().bytes, 1u);
+}
+
+TEST(ShardedLruCache, staysWithinBudget)
+{
+    size_t const budget = 16 * 30;
+    Cache cache{budget, stringSize};
+    cache.insert(0, string(10, 'x'));
+    for (int i = 1; i < 1000; ++i)
+    {
+        cache.insert(i, string(10, 'x'));
+        // Keep the first key the most recently used one.
+        EXPECT_TRUE(cache.find(0));
+    }
+
+    LruCacheStats const stats = cache.stats();
+    EXPECT_LE(stats.bytes, budget);
+    EXPECT_EQ(stats.bytes, stats.entries * 10);
+    EXPECT_EQ(stats.evictions, 1000 - stats.entries);
+
+    cache.setBudget(0);
+    EXPECT_LE(cache.stats().entries, 16u);
+    cache.clear();
+    EXPECT_EQ(cache.stats().bytes, 0u);
+    EXPECT_FALSE(cache.contains(0));
+}
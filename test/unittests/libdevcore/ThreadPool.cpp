@@ -0,0 +1,69 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#include <libdevcore/ThreadPool.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+
+using namespace std;
+using namespace dev;
+
+TEST(ThreadPool, runReturnsResultOfWorker)
+{
+    ThreadPool pool{"test", 2};
+    EXPECT_EQ(pool.threads(), 2u);
+
+    auto const caller = this_thread::get_id();
+    EXPECT_NE(pool.run([] { return this_thread::get_id(); }), caller);
+    EXPECT_EQ(pool.run([] { return 42; }), 42);
+    EXPECT_THROW(pool.run([]() -> int { throw runtime_error("failed"); }), runtime_error);
+}
+
+TEST(ThreadPool, rejectsJobsWhenQueueIsFull)
+{
+    ThreadPool pool{"test", 1, 1};
+    promise<void> release;
+    shared_future<void> released = release.get_future().share();
+    promise<void> started;
+    pool.post([&] {
+        started.set_value();
+        released.wait();
+    });
+    started.get_future().wait();
+
+    pool.post([] {});
+    EXPECT_FALSE(pool.tryPost([] {}));
+    EXPECT_THROW(pool.post([] {}), ThreadPoolFull);
+    release.set_value();
+}
+
+TEST(ThreadPool, runAllRunsEveryJob)
+{
+    ThreadPool pool{"test", 3};
+    vector<atomic<int>> runs(100);
+    vector<function<void()>> jobs;
+    for (size_t i = 0; i < runs.size(); ++i)
+        jobs.push_back([&runs, i] { ++runs[i]; });
+
+    pool.runAll(jobs);
+    for (auto const& r : runs)
+        EXPECT_EQ(r.load(), 1);
+
+    jobs.push_back([] { throw runtime_error("failed"); });
+    EXPECT_THROW(pool.runAll(jobs), runtime_error);
+    for (auto const& r : runs)
+        EXPECT_EQ(r.load(), 2);
+}
+
+TEST(ThreadPool, runsQueuedJobsWhenDestroyed)
+{
+    atomic<int> runs{0};
+    {
+        ThreadPool pool{"test", 1};
+        for (int i = 0; i < 10; ++i)
+            pool.post([&runs] { ++runs; });
+    }
+    EXPECT_EQ(runs.load(), 10);
+}
@@ -75,6 +75,27 @@ BOOST_AUTO_TEST_CASE(emptySHA3Types)
     BOOST_REQUIRE_EQUAL(emptyListSHA3, EmptyListSHA3);
 }
 
+BOOST_AUTO_TEST_CASE(sha3BatchMatchesSha3)
+{
+    // Sizes around the 136-byte block boundary and counts covering full and partial
+    // 8-way and 4-way groups as well as the single input fallback.
+    vector<bytes> data;
+    for (size_t size : {0, 1, 20, 32, 135, 136, 137, 271, 272, 300, 1000})
+        data.push_back(bytes(size, static_cast<byte>(size)));
+
+    for (size_t count = 0; count <= 19; ++count)
+    {
+        vector<bytesConstRef> inputs;
+        for (size_t i = 0; i < count; ++i)
+            inputs.push_back(&data[(i * 7 + count) % data.size()]);
+
+        h256s const hashes = sha3Batch(inputs);
+        BOOST_REQUIRE_EQUAL(hashes.size(), count);
+        for (size_t i = 0; i < count; ++i)
+            BOOST_REQUIRE_EQUAL(hashes[i], sha3(inputs[i]));
+    }
+}
+
 BOOST_AUTO_TEST_CASE(pubkeyOfZero)
 {
     auto pub = toPublic(Secret{});
@@ -856,6 +877,40 @@ BOOST_AUTO_TEST_CASE(PerfSHA256_4000, *utf::label("perf"))
     BOOST_CHECK_EQUAL(data[0], 0x4d);
 }
 
+BOOST_AUTO_TEST_CASE(PerfSHA3Batch, *utf::label("perf"))
+{
+    if (!test::Options::get().all)
+    {
+        std::cout << "Skipping test Crypto/devcrypto/PerfSHA3Batch. Use --all to run it.\n";
+        return;
+    }
+
+    size_t const count = 4096;
+    for (size_t size : {20, 32, 100, 136, 200, 532})
+    {
+        vector<bytes> data(count, bytes(size, 0xaa));
+        vector<bytesConstRef> inputs;
+        for (auto const& d : data)
+            inputs.push_back(&d);
+        h256s hashes(count);
+
+        Timer timer;
+        for (auto i = 0; i < 100; ++i)
+            for (size_t j = 0; j < count; ++j)
+                hashes[j] = sha3(inputs[j]);
+        double const single = timer.elapsed();
+
+        timer.restart();
+        for (auto i = 0; i < 100; ++i)
+            sha3Batch(inputs.data(), count, hashes.data());
+        double const batch = timer.elapsed();
+
+        double const megabytes = 100.0 * count * size / 1000000;
+        std::cout << "sha3 " << size << " B: " << megabytes / single << " MB/s, sha3Batch: "
+                  << megabytes / batch << " MB/s\n";
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()
 
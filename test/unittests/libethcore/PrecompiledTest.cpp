@@ -6,7 +6,9 @@
 /// Precompiled contract implemetations testing.
 #include <boost/test/unit_test.hpp>
 #include <test/tools/libtesteth/TestHelper.h>
+#include <libethcore/ModExp.h>
 #include <libethcore/Precompiled.h>
+#include <random>
 
 using namespace std;
 using namespace dev;
@@ -173,6 +175,31 @@ BOOST_AUTO_TEST_CASE(modexpModLengthZero)
     BOOST_REQUIRE(res.second.empty());
 }
 
+BOOST_AUTO_TEST_CASE(modexpMontgomeryMatchesGeneric)
+{
+    mt19937_64 rng{0};
+    auto random = [&rng](unsigned _bits) -> bigint {
+        bigint ret;
+        for (unsigned i = 0; i < _bits; i += 64)
+            ret = (ret << 64) | rng();
+        return ret >> ((_bits + 63) / 64 * 64 - _bits);
+    };
+
+    // Cover every kernel width, the boundaries between them and the generic fallback.
+    for (unsigned bits : {1, 64, 65, 256, 257, 512, 1024, 1500, 2048, 4096, 4097})
+        for (int i = 0; i < 8; ++i)
+        {
+            bigint mod = random(bits) | (bigint{1} << (bits - 1));
+            if (i != 7)  // keep one even modulus per width
+                mod |= 1;
+            bigint const base = i == 0 ? bigint{0} : random(bits + 64 * (i % 3));
+            bigint const exp = i == 1 ? bigint{0} : random(i % 2 ? 17 : bits);
+
+            BOOST_REQUIRE_MESSAGE(modexp(base, exp, mod) == modexpGeneric(base, exp, mod),
+                "Mismatch for " + toString(bits) + "-bit modulus, case " + toString(i));
+        }
+}
+
 BOOST_AUTO_TEST_CASE(modexpCostFermatTheorem)
 {
     PrecompiledPricer cost = PrecompiledRegistrar::pricer("modexp");
@@ -718,6 +745,48 @@ BOOST_AUTO_TEST_CASE(bench_modexp, *ut::label("bench"))
     benchmarkPrecompiled("modexp", tests, 10000);
 }
 
+BOOST_AUTO_TEST_CASE(bench_modexp_gas, *ut::label("bench"))
+{
+    if (!Options::get().all)
+    {
+        std::cout << "Skipping benchmark test because --all option is not specified.\n";
+        return;
+    }
+
+    PrecompiledExecutor exec = PrecompiledRegistrar::executor("modexp");
+    PrecompiledPricer cost = PrecompiledRegistrar::pricer("modexp");
+    int const n = 1000;
+
+    for (auto&& test : modexpTests)
+    {
+        bytes input = fromHex(test.input);
+        bytesConstRef inputRef = &input;
+        auto const gas = static_cast<double>(cost(inputRef, {}, {}));
+
+        size_t const baseLength{fromBigEndian<bigint>(inputRef.cropped(0, 32))};
+        size_t const expLength{fromBigEndian<bigint>(inputRef.cropped(32, 32))};
+        size_t const modLength{fromBigEndian<bigint>(inputRef.cropped(64, 32))};
+        bigint const base{fromBigEndian<bigint>(inputRef.cropped(96, baseLength))};
+        bigint const exp{fromBigEndian<bigint>(inputRef.cropped(96 + baseLength, expLength))};
+        bigint const mod{
+            fromBigEndian<bigint>(inputRef.cropped(96 + baseLength + expLength, modLength))};
+
+        Timer timer;
+        for (int i = 0; i < n; ++i)
+            exec(inputRef);
+        auto const t = std::chrono::duration<double, std::nano>(timer.duration() / n).count();
+
+        timer.restart();
+        for (int i = 0; i < n; ++i)
+            modexpGeneric(base, exp, mod);
+        auto const tGeneric =
+            std::chrono::duration<double, std::nano>(timer.duration() / n).count();
+
+        std::cout << ut::framework::current_test_case().p_name << "/" << test.name << ": "
+                  << t / gas << " ns/gas (generic: " << tGeneric / gas << " ns/gas)\n";
+    }
+}
+
 BOOST_AUTO_TEST_CASE(bench_bn256Add, *ut::label("bench"))
 {
     vector_ref<const PrecompiledTest> tests{bn256AddTests, sizeof(bn256AddTests) / sizeof(bn256AddTests[0])};
@@ -114,6 +114,42 @@ BOOST_AUTO_TEST_CASE(bCopyOperator)
 
 BOOST_AUTO_TEST_SUITE_END()
 
+BOOST_AUTO_TEST_CASE(bRollbackPending)
+{
+    TestBlockChain testBlockchain(TestBlockChain::defaultGenesisBlock());
+    TestBlock const& genesisBlock = testBlockchain.testGenesis();
+    OverlayDB const& genesisDB = genesisBlock.state().db();
+    BlockChain const& blockchain = testBlockchain.getInterface();
+
+    TestBlock testBlock;
+    TestTransaction transaction1 = TestTransaction::defaultTransaction(1);
+    testBlock.addTransaction(transaction1);
+    TestTransaction transaction2 = TestTransaction::defaultTransaction(2);
+    testBlock.addTransaction(transaction2);
+
+    ZeroGasPricer gp;
+    Block block = blockchain.genesisBlock(genesisDB);
+    block.sync(blockchain);
+    h256 const rootBefore = block.rootHash();
+    block.sync(blockchain, testBlock.transactionQueue(), gp);
+    BOOST_REQUIRE_EQUAL(block.pending().size(), 2);
+    h256 const rootAfter = block.rootHash();
+
+    BOOST_REQUIRE(block.rollbackPending(1));
+    BOOST_CHECK_EQUAL(block.pending().size(), 1);
+    BOOST_CHECK(!block.pendingHashes().count(transaction2.transaction().sha3()));
+    BOOST_CHECK(block.rootHash() != rootAfter);
+
+    // The dropped transaction is executed again by the next sync.
+    block.sync(blockchain, testBlock.transactionQueue(), gp);
+    BOOST_CHECK_EQUAL(block.pending().size(), 2);
+    BOOST_CHECK_EQUAL(block.rootHash(), rootAfter);
+
+    BOOST_REQUIRE(block.rollbackPending(0));
+    BOOST_CHECK(block.pending().empty());
+    BOOST_CHECK_EQUAL(block.rootHash(), rootBefore);
+}
+
 BOOST_AUTO_TEST_CASE(bGasPricer)
 {
     TestBlockChain testBlockchain(TestBlockChain::defaultGenesisBlock(63000));
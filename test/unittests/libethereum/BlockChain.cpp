@@ -6,11 +6,14 @@
 /// Blockchain test functions.
 #include <libethereum/Block.h>
 #include <libethereum/BlockChain.h>
+#include <libethereum/BulkImporter.h>
+#include <libethereum/ChainArchive.h>
 #include <libdevcore/DBFactory.h>
 #include <test/tools/libtesteth/TestHelper.h>
 #include <test/tools/libtesteth/BlockChainHelper.h>
 #include <libethereum/GenesisInfo.h>
 #include <libethereum/ChainParams.h>
+#include <boost/crc.hpp>
 
 using namespace std;
 using namespace dev;
@@ -55,6 +58,131 @@ BOOST_AUTO_TEST_CASE(opendb)
     setDatabaseKind(preDatabaseKind);
 }
 
+BOOST_AUTO_TEST_CASE(reindexExtras)
+{
+    auto const preDatabaseKind = databaseKind();
+    setDatabaseKind(DatabaseKind::LevelDB);
+
+    TestBlockChain bc(TestBlockChain::defaultGenesisBlock());
+    TestTransaction tr1 = TestTransaction::defaultTransaction(1);
+    TestBlock block1;
+    block1.addTransaction(tr1);
+    block1.mine(bc);
+    bc.addBlock(block1);
+    TestTransaction tr2 = TestTransaction::defaultTransaction(2);
+    TestBlock block2;
+    block2.addTransaction(tr2);
+    block2.mine(bc);
+    bc.addBlock(block2);
+
+    BlockChain& bcRef = bc.interfaceUnsafe();
+    h256 const hash2 = bcRef.numberHash(2);
+    u256 const totalDifficulty = bcRef.details().totalDifficulty;
+    bytes const receipts = bcRef.receipts(hash2).rlp();
+    LogBloom const bloom = bcRef.blockBloom(2);
+
+    bcRef.reopen(WithExisting::ReindexExtras);
+
+    BOOST_CHECK_EQUAL(bcRef.number(), 2);
+    BOOST_CHECK_EQUAL(bcRef.numberHash(2), hash2);
+    BOOST_CHECK_EQUAL(bcRef.details(bcRef.numberHash(1)).childHashes, h256s{hash2});
+    BOOST_CHECK_EQUAL(bcRef.details(hash2).totalDifficulty, totalDifficulty);
+    BOOST_CHECK(bcRef.receipts(hash2).rlp() == receipts);
+    BOOST_CHECK_EQUAL(bcRef.blockBloom(2), bloom);
+    BOOST_CHECK_EQUAL(bcRef.transactionLocation(tr2.transaction().sha3()).first, hash2);
+
+    setDatabaseKind(preDatabaseKind);
+}
+
+BOOST_AUTO_TEST_CASE(bulkImport)
+{
+    TestBlockChain bc(TestBlockChain::defaultGenesisBlock());
+    bytes exported;
+    for (unsigned i = 1; i <= 3; ++i)
+    {
+        TestBlock block;
+        block.addTransaction(TestTransaction::defaultTransaction(i));
+        block.mine(bc);
+        bc.addBlock(block);
+        exported += block.bytes();
+    }
+
+    TestBlockChain bc2(TestBlockChain::defaultGenesisBlock());
+    BulkImporter importer(bc2.interfaceUnsafe(), bc2.testGenesis().state().db(), 2);
+    unsigned reports = 0;
+    BulkImportProgress progress =
+        importer.import(&exported, 1, [&](BulkImportProgress const&) { ++reports; });
+    BOOST_CHECK_EQUAL(progress.imported, 3);
+    BOOST_CHECK_EQUAL(progress.lastNumber, 3);
+    BOOST_CHECK(progress.gasUsed >= 3 * 21000);
+    BOOST_CHECK_EQUAL(reports, 4);
+    BOOST_CHECK_EQUAL(bc2.getInterface().currentHash(), bc.getInterface().currentHash());
+
+    // The blocks imported are skipped when the import is resumed.
+    progress = importer.import(&exported, 0);
+    BOOST_CHECK_EQUAL(progress.imported, 0);
+    BOOST_CHECK_EQUAL(progress.alreadyKnown, 3);
+
+    // The blocks before a truncated one are imported.
+    TestBlockChain bc3(TestBlockChain::defaultGenesisBlock());
+    BulkImporter importer3(bc3.interfaceUnsafe(), bc3.testGenesis().state().db());
+    BOOST_CHECK_THROW(
+        importer3.import(bytesConstRef(&exported).cropped(0, exported.size() - 1), 0), BadRLP);
+    BOOST_CHECK_EQUAL(bc3.getInterface().number(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(chainArchive)
+{
+    TestBlockChain bc(TestBlockChain::defaultGenesisBlock());
+    bytes lastTwo;
+    for (unsigned i = 1; i <= 3; ++i)
+    {
+        TestBlock block;
+        block.addTransaction(TestTransaction::defaultTransaction(i));
+        block.mine(bc);
+        bc.addBlock(block);
+        if (i > 1)
+            lastTwo += block.bytes();
+    }
+
+    stringstream out;
+    exportChainArchive(bc.getInterface(), 1, 3, out, 2);
+    bytes archived = asBytes(out.str());
+    ChainArchive const archive(&archived);
+    BOOST_CHECK_EQUAL(archive.firstNumber(), 1);
+    BOOST_CHECK_EQUAL(archive.lastNumber(), 3);
+
+    bytes range;
+    archive.forEachSegment(2, 10, 1, [&](bytesConstRef _blocks) { range += _blocks.toBytes(); });
+    BOOST_CHECK(range == lastTwo);
+
+    TestBlockChain bc2(TestBlockChain::defaultGenesisBlock());
+    BulkImporter importer(bc2.interfaceUnsafe(), bc2.testGenesis().state().db());
+    BOOST_CHECK_EQUAL(importer.import(archive, 0).imported, 3);
+    BOOST_CHECK_EQUAL(bc2.getInterface().currentHash(), bc.getInterface().currentHash());
+
+    // An index entry leaving no room for the header of its segment before the next one.
+    bytes overlapping(archived.begin(), archived.begin() + 8);
+    overlapping += bytes(40);
+    uint64_t const indexOffset = overlapping.size();
+    RLPStream index(2);
+    index.appendList(3) << 1 << 1 << 8;
+    index.appendList(3) << 2 << 1 << 9;
+    overlapping += index.out();
+    boost::crc_32_type crc;
+    crc.process_bytes(index.out().data(), index.out().size());
+    for (auto const& field : {make_pair(indexOffset, 8u), make_pair(uint64_t(index.out().size()), 4u),
+             make_pair(uint64_t(crc.checksum()), 4u)})
+        for (unsigned i = field.second; i-- > 0;)
+            overlapping.push_back(static_cast<byte>(field.first >> (i * 8)));
+    overlapping += bytes(archived.begin(), archived.begin() + 8);
+    BOOST_CHECK_THROW(ChainArchive{&overlapping}, BadChainArchive);
+
+    archived[30] ^= 1;
+    ChainArchive const corrupted(&archived);
+    BOOST_CHECK_THROW(corrupted.segmentBlocks(0), BadChainArchive);
+}
+
 BOOST_AUTO_TEST_CASE(Mining_1_mineBlockWithTransaction)
 {
     TestBlockChain bc(TestBlockChain::defaultGenesisBlock());
@@ -384,8 +512,11 @@ BOOST_AUTO_TEST_CASE(updateStats)
     BOOST_CHECK_EQUAL(stat.memTotal(), totalExpected);
     BOOST_CHECK_EQUAL(stat.memTransactionAddresses, 0);
 
-    //memchache size 33554432 - 3500 blocks before cache to be cleared
-    bcRef.garbageCollect(true);
+    BlockChainCacheStats const cacheStats = bcRef.cacheStats();
+    BOOST_CHECK_EQUAL(cacheStats.blocks.entries, 1);
+    BOOST_CHECK_EQUAL(cacheStats.blocks.bytes, memBlocksExpected);
+    BOOST_CHECK_EQUAL(cacheStats.total().bytes, totalExpected);
+    BOOST_CHECK_EQUAL(cacheStats.total().evictions, 0);
 }
 
 BOOST_AUTO_TEST_CASE(invalidJsonThrows)
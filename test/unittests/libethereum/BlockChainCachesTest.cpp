@@ -0,0 +1,58 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#include <libethereum/BlockChainCaches.h>
+#include <boost/program_options.hpp>
+#include <gtest/gtest.h>
+
+#include <limits>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+namespace po = boost::program_options;
+
+namespace
+{
+class BlockChainCachesTest : public testing::Test
+{
+public:
+    ~BlockChainCachesTest() { setBlockChainCacheBudgets(m_budgets); }
+
+    void parse(vector<string> const& _args)
+    {
+        po::variables_map vm;
+        po::store(po::command_line_parser(_args).options(blockChainCacheProgramOptions()).run(), vm);
+        po::notify(vm);
+    }
+
+private:
+    BlockChainCacheBudgets const m_budgets = blockChainCacheBudgets();
+};
+}  // namespace
+
+TEST_F(BlockChainCachesTest, setsBudgetInMebibytes)
+{
+    parse({"--chain-cache", "blocks=3", "receipts=0"});
+    EXPECT_EQ(blockChainCacheBudgets().blocks, 3u * 1024 * 1024);
+    EXPECT_EQ(blockChainCacheBudgets().receipts, 0u);
+}
+
+TEST_F(BlockChainCachesTest, rejectsBudgetOverflowingSize)
+{
+    size_t const largest = numeric_limits<size_t>::max() >> 20;
+    parse({"--chain-cache", "blocks=" + to_string(largest)});
+    EXPECT_EQ(blockChainCacheBudgets().blocks, largest << 20);
+
+    size_t const details = blockChainCacheBudgets().details;
+    EXPECT_THROW(parse({"--chain-cache", "details=" + to_string(largest + 1)}), po::validation_error);
+    EXPECT_THROW(parse({"--chain-cache", "details=-1"}), po::validation_error);
+    EXPECT_EQ(blockChainCacheBudgets().details, details);
+}
+
+TEST_F(BlockChainCachesTest, rejectsUnknownCache)
+{
+    EXPECT_THROW(parse({"--chain-cache", "nothing=1"}), po::validation_error);
+    EXPECT_THROW(parse({"--chain-cache", "blocks=1MiB"}), po::validation_error);
+}
@@ -0,0 +1,62 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#include <libethereum/BlockDetails.h>
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace
+{
+Address const c_token{0x100};
+h256 const c_transfer{1};
+
+/// A block of token transfers between a few accounts, from before and after EIP-658.
+BlockReceipts transfers()
+{
+    BlockReceipts ret;
+    for (unsigned i = 0; i < 20; ++i)
+    {
+        LogEntries const logs{LogEntry{c_token, {c_transfer, h256(i % 3), h256(i % 4)}, bytes(32, i)}};
+        if (i % 5)
+            ret.receipts.emplace_back(uint8_t(i % 2), 21000 * (i + 1), logs);
+        else
+            ret.receipts.emplace_back(h256(i), 21000 * (i + 1), logs);
+    }
+    ret.receipts.emplace_back(uint8_t(0), 21000 * 21, LogEntries{});
+    return ret;
+}
+}  // namespace
+
+TEST(BlockReceipts, compactEncodingKeepsReceipts)
+{
+    BlockReceipts const original = transfers();
+    bytes const compact = original.compactRlp();
+    bytes const consensus = original.rlp();
+    EXPECT_LT(compact.size(), consensus.size() / 4);
+
+    BlockReceipts const decoded{RLP(compact)};
+    ASSERT_EQ(decoded.receipts.size(), original.receipts.size());
+    for (size_t i = 0; i < decoded.receipts.size(); ++i)
+    {
+        EXPECT_EQ(decoded.receipts[i].rlp(), original.receipts[i].rlp());
+        EXPECT_EQ(decoded.receipts[i].bloom(), original.receipts[i].bloom());
+    }
+    EXPECT_GT(decoded.size, 0u);
+}
+
+TEST(BlockReceipts, readsConsensusEncoding)
+{
+    BlockReceipts const original = transfers();
+    bytes const consensus = original.rlp();
+    BlockReceipts const decoded{RLP(consensus)};
+    EXPECT_EQ(decoded.rlp(), consensus);
+    EXPECT_EQ(decoded.size, consensus.size());
+
+    bytes const emptyCompact = BlockReceipts().compactRlp();
+    BlockReceipts const empty{RLP(emptyCompact)};
+    EXPECT_TRUE(empty.receipts.empty());
+}
@@ -0,0 +1,105 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#include <libethereum/CanonicalHashRing.h>
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace
+{
+/// The hashes of blocks @a _first to @a _last of the chain @a _chain.
+h256s chain(unsigned _chain, unsigned _first, unsigned _last)
+{
+    h256s ret;
+    for (unsigned n = _first; n <= _last; ++n)
+        ret.push_back(h256(_chain * 1000 + n));
+    return ret;
+}
+
+h256 find(CanonicalHashRing const& _ring, unsigned _number)
+{
+    uint64_t generation;
+    return _ring.find(_number, generation);
+}
+}  // namespace
+
+TEST(CanonicalHashRing, keepsRecentBlocks)
+{
+    CanonicalHashRing ring{8};
+    ring.reset(0, h256(1000));
+    ring.setHead(1, chain(1, 1, 10));
+
+    EXPECT_EQ(ring.head(), 10u);
+    EXPECT_EQ(find(ring, 10), h256(1010));
+    EXPECT_EQ(find(ring, 3), h256(1003));
+    // Older than the capacity, or above the head.
+    EXPECT_EQ(find(ring, 2), h256());
+    EXPECT_EQ(find(ring, 11), h256());
+}
+
+TEST(CanonicalHashRing, reorganisationReplacesBlocks)
+{
+    CanonicalHashRing ring{8};
+    ring.reset(0, h256(1000));
+    ring.setHead(1, chain(1, 1, 6));
+
+    // Chain 2 forks off after block 3 and becomes longer.
+    ring.rewind(3);
+    EXPECT_EQ(find(ring, 4), h256());
+    ring.setHead(4, chain(2, 4, 7));
+    EXPECT_EQ(find(ring, 3), h256(1003));
+    EXPECT_EQ(find(ring, 5), h256(2005));
+    EXPECT_EQ(find(ring, 7), h256(2007));
+}
+
+TEST(CanonicalHashRing, fillsOnlyWithCurrentGeneration)
+{
+    CanonicalHashRing ring{8};
+    ring.reset(10, h256(1010));
+
+    uint64_t generation;
+    EXPECT_EQ(ring.find(9, generation), h256());
+    ring.fill(9, h256(1009), generation);
+    EXPECT_EQ(find(ring, 9), h256(1009));
+
+    // A lookup which raced with a reorganisation is not kept.
+    EXPECT_EQ(ring.find(8, generation), h256());
+    ring.rewind(7);
+    ring.setHead(8, chain(2, 8, 10));
+    ring.fill(8, h256(1008), generation);
+    EXPECT_EQ(find(ring, 8), h256(2008));
+
+    // Appending blocks does not change the ones below.
+    EXPECT_EQ(ring.find(5, generation), h256());
+    ring.setHead(11, chain(2, 11, 11));
+    ring.fill(5, h256(1005), generation);
+    EXPECT_EQ(find(ring, 5), h256(1005));
+}
+
+TEST(CanonicalHashRing, readsPrecedingHashesOfOneChain)
+{
+    CanonicalHashRing ring{8};
+    ring.reset(0, h256(1000));
+    ring.setHead(1, chain(1, 1, 10));
+
+    uint64_t generation;
+    EXPECT_EQ(ring.preceding(10, h256(1010), 3, generation),
+        (h256s{h256(1010), h256(1009), h256(1008)}));
+    // The blocks older than the ring are null.
+    h256s const all = ring.preceding(10, h256(1010), 20, generation);
+    ASSERT_EQ(all.size(), 11u);
+    EXPECT_EQ(all[7], h256(1003));
+    EXPECT_EQ(all[8], h256());
+
+    // Nothing for a block which is not canonical, or no longer.
+    EXPECT_TRUE(ring.preceding(10, h256(2010), 3, generation).empty());
+    ring.rewind(5);
+    ring.setHead(6, chain(2, 6, 10));
+    EXPECT_TRUE(ring.preceding(10, h256(1010), 3, generation).empty());
+    EXPECT_EQ(ring.preceding(7, h256(2007), 3, generation),
+        (h256s{h256(2007), h256(2006), h256(1005)}));
+}
@@ -0,0 +1,107 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#include <libethereum/CodeCache.h>
+#include <libethereum/State.h>
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace
+{
+CodeCache::Code makeCode(size_t _size, byte _fill)
+{
+    return make_shared<bytes const>(_size, _fill);
+}
+}  // namespace
+
+TEST(CodeCache, insertReturnsFirstBlob)
+{
+    CodeCache cache;
+    h256 const hash{1};
+    auto const first = makeCode(10, 1);
+
+    EXPECT_EQ(cache.insert(hash, first), first);
+    EXPECT_EQ(cache.insert(hash, makeCode(10, 1)), first);
+    EXPECT_EQ(cache.find(hash), first);
+    EXPECT_EQ(cache.stats().entries, 1u);
+    EXPECT_EQ(cache.stats().bytes, 10u);
+}
+
+TEST(CodeCache, evictsLeastRecentlyUsed)
+{
+    CodeCache cache{30};
+    auto const evicted = makeCode(10, 4);
+    cache.insert(h256{1}, makeCode(10, 1));
+    cache.insert(h256{2}, makeCode(10, 2));
+    cache.insert(h256{3}, makeCode(10, 3));
+
+    // From the most recently used: 1, 3, 2.
+    EXPECT_TRUE(cache.find(h256{1}));
+    // Evicts 2: 4, 1, 3.
+    cache.insert(h256{4}, evicted);
+
+    EXPECT_FALSE(cache.find(h256{2}));
+    EXPECT_EQ(cache.stats().bytes, 30u);
+
+    // Keeps 4 only.
+    cache.setBudget(10);
+    EXPECT_FALSE(cache.find(h256{1}));
+    EXPECT_FALSE(cache.find(h256{3}));
+    EXPECT_EQ(cache.find(h256{4}), evicted);
+    EXPECT_EQ(cache.stats().entries, 1u);
+
+    // Evicted code stays valid for its users.
+    cache.setBudget(0);
+    EXPECT_FALSE(cache.find(h256{4}));
+    EXPECT_EQ(*evicted, bytes(10, 4));
+}
+
+TEST(CodeCache, statesShareCode)
+{
+    Address const contract{0x100};
+    bytes const code = {0x60, 0x00, 0x56};
+
+    State state{0};
+    state.createContract(contract);
+    state.setCode(contract, bytes{code}, 0);
+    state.commit(State::CommitBehaviour::KeepEmptyAccounts);
+
+    State other{0, state.db(), BaseState::PreExisting};
+    other.setRoot(state.rootHash());
+
+    EXPECT_EQ(other.code(contract), code);
+    EXPECT_EQ(other.codeSize(contract), code.size());
+    EXPECT_EQ(other.sharedCode(contract), CodeCache::instance().find(sha3(code)));
+}
+
+TEST(CodeCache, missingCodeIsNotCached)
+{
+    Address const contract{0x101};
+    bytes const code = {0x60, 0x01, 0x56};
+    h256 const codeHash = sha3(code);
+
+    State state{0};
+    state.createContract(contract);
+    state.setCode(contract, bytes{code}, 0);
+    state.commit(State::CommitBehaviour::KeepEmptyAccounts);
+    state.db().kill(codeHash);
+    state.db().purge();
+    CodeCache::instance().clear();
+
+    State other{0, state.db(), BaseState::PreExisting};
+    other.setRoot(state.rootHash());
+
+    EXPECT_FALSE(other.sharedCode(contract));
+    EXPECT_FALSE(CodeCache::instance().find(codeHash));
+
+    // Found once the code is in the backend.
+    state.db().insert(codeHash, &code);
+    State restored{0, state.db(), BaseState::PreExisting};
+    restored.setRoot(state.rootHash());
+    EXPECT_EQ(restored.code(contract), code);
+    EXPECT_EQ(restored.sharedCode(contract), CodeCache::instance().find(codeHash));
+}
@@ -0,0 +1,157 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#include <libethashseal/Ethash.h>
+#include <libethashseal/GenesisInfo.h>
+#include <libethereum/ChainParams.h>
+#include <libethereum/State.h>
+#include <test/tools/libtestutils/TestLastBlockHashes.h>
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <new>
+
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+
+namespace
+{
+thread_local bool t_counting = false;
+thread_local size_t t_allocations = 0;
+
+/// Counts the heap allocations made by the calling thread during its lifetime.
+class AllocationCounter
+{
+public:
+    AllocationCounter()
+    {
+        t_allocations = 0;
+        t_counting = true;
+    }
+    ~AllocationCounter() { t_counting = false; }
+
+    size_t count() const { return t_allocations; }
+};
+}  // namespace
+
+// Replaces the global allocation functions, only to count the allocations of the thread while an
+// AllocationCounter is alive. This file is built into its own test executable, so that the
+// replacement does not apply to the other tests.
+void* operator new(std::size_t _size)
+{
+    if (t_counting)
+        ++t_allocations;
+    if (void* p = std::malloc(_size ? _size : 1))
+        return p;
+    throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t _size)
+{
+    return ::operator new(_size);
+}
+
+void operator delete(void* _p) noexcept
+{
+    std::free(_p);
+}
+
+void operator delete[](void* _p) noexcept
+{
+    std::free(_p);
+}
+
+void operator delete(void* _p, std::size_t) noexcept
+{
+    std::free(_p);
+}
+
+void operator delete[](void* _p, std::size_t) noexcept
+{
+    std::free(_p);
+}
+
+class ExecutiveAllocationTest : public testing::Test
+{
+public:
+    ExecutiveAllocationTest()
+    {
+        ethash.setChainParams(ChainParams{genesisInfo(eth::Network::IstanbulTransitionTest)});
+        blockHeader.setNumber(10);
+        blockHeader.setGasLimit(10000000);
+
+        state.addBalance(sender, 1000000000);
+        state.addBalance(recipient, 1);
+        state.addBalance(blockHeader.author(), 1);
+
+        // A token contract keeping the balances in storage, keyed by the owner:
+        // amount = calldata[32:64]
+        // sstore(caller, sload(caller) - amount)
+        // sstore(calldata[0:32], sload(calldata[0:32]) + amount)
+        state.createContract(token);
+        state.setCode(token, fromHex("60203580335403335560003580548201905500"), 0);
+        state.setStorage(token, u256(u160(sender)), 1000000);
+        state.setStorage(token, u256(u160(recipient)), 1);
+        state.commit(State::CommitBehaviour::KeepEmptyAccounts);
+    }
+
+    EnvInfo envInfo() const
+    {
+        return {blockHeader, lastBlockHashes, 0, ethash.chainParams().chainID};
+    }
+
+    /// @returns a transaction from the sender with its next nonce.
+    Transaction transaction(Address const& _to, u256 const& _value, bytes const& _data) const
+    {
+        Transaction t(_value, 0, 100000, _to, _data, state.getNonce(sender));
+        t.forceSender(sender);
+        return t;
+    }
+
+    /// @returns the number of heap allocations made by executing a transaction, after the same
+    /// transaction with the previous nonce has warmed up the caches and pools.
+    size_t allocations(Address const& _to, u256 const& _value, bytes const& _data)
+    {
+        EnvInfo const env = envInfo();
+        auto const warmUp =
+            state.execute(env, ethash, transaction(_to, _value, _data), Permanence::Uncommitted);
+        EXPECT_EQ(warmUp.first.excepted, TransactionException::None);
+
+        Transaction const t = transaction(_to, _value, _data);
+        AllocationCounter counter;
+        auto const result = state.execute(env, ethash, t, Permanence::Uncommitted);
+        size_t const count = counter.count();
+        EXPECT_EQ(result.first.excepted, TransactionException::None);
+        return count;
+    }
+
+    Ethash ethash;
+    BlockHeader blockHeader;
+    TestLastBlockHashes lastBlockHashes{{}};
+    State state{0};
+
+    Address sender{"0xaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"};
+    Address recipient{"0xbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb"};
+    Address token{"0xa94f5374fce5edbc8e2a8697c15331677e6ebf0b"};
+};
+
+TEST_F(ExecutiveAllocationTest, valueTransfer)
+{
+    size_t const count = allocations(recipient, 1, {});
+
+    EXPECT_LE(count, 16u);
+}
+
+TEST_F(ExecutiveAllocationTest, tokenTransfer)
+{
+    bytes const data = h256(u256(u160(recipient))).asBytes() + h256(u256(1)).asBytes();
+    size_t const valueTransfer = allocations(recipient, 1, {});
+    size_t const tokenTransfer = allocations(token, 0, data);
+
+    EXPECT_EQ(state.storage(token, u256(u160(recipient))), 3);
+    EXPECT_LE(tokenTransfer, 24u);
+    // The frame running the contract takes its ExtVM, VM, code and memory buffers from the
+    // thread's pools.
+    EXPECT_LE(tokenTransfer, valueTransfer + 4);
+}
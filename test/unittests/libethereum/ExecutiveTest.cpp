@@ -5,6 +5,7 @@
 #include <libethashseal/Ethash.h>
 #include <libethashseal/GenesisInfo.h>
 #include <libethereum/ChainParams.h>
+#include <libethereum/CodeCache.h>
 #include <libethereum/Executive.h>
 #include <libethereum/ExtVM.h>
 #include <libethereum/State.h>
@@ -58,6 +59,26 @@ TEST_F(ExecutiveTest, callUsesAccountVersion)
     EXPECT_EQ(executive.extVM().version, version);
 }
 
+TEST_F(ExecutiveTest, callRunsNoCodeMissingFromDatabase)
+{
+    state.createContract(receiveAddress);
+    state.setCode(receiveAddress, bytes{code}, 0);
+    state.commit(State::CommitBehaviour::RemoveEmptyAccounts);
+    state.db().kill(sha3(code));
+    state.db().purge();
+    CodeCache::instance().clear();
+
+    State missing{0, state.db(), BaseState::PreExisting};
+    missing.setRoot(state.rootHash());
+    ASSERT_TRUE(missing.addressHasCode(receiveAddress));
+    Executive executive(missing, envInfo(), ethash);
+
+    bool done = executive.call(receiveAddress, txSender, txValue, gasPrice, txData, gas);
+
+    EXPECT_FALSE(done);
+    EXPECT_TRUE(executive.extVM().code.empty());
+}
+
 TEST_F(ExecutiveTest, createUsesLatestForkVersion)
 {
     // block in Istanbul fork
@@ -0,0 +1,176 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#include <libethereum/LogFilterIndex.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace
+{
+Address const c_token{0x100};
+Address const c_exchange{0x200};
+h256 const c_transfer{1};
+h256 const c_approval{2};
+h256 const c_alice{10};
+
+TransactionReceipt receipt(LogEntries const& _logs)
+{
+    return TransactionReceipt(uint8_t(1), 21000, _logs);
+}
+
+/// @returns the ids of the filters with a log of the receipt, testing all of them.
+h256Hash matchingAll(unordered_map<h256, LogFilter> const& _filters, TransactionReceipt const& _r)
+{
+    h256Hash ret;
+    for (auto const& f : _filters)
+        if (!f.second.matches(_r).empty())
+            ret.insert(f.first);
+    return ret;
+}
+
+/// @returns the ids of the filters with a log of the receipt, testing the candidates only.
+/// Adds the number of filters tested to @a io_tested.
+h256Hash matchingIndexed(unordered_map<h256, LogFilter> const& _filters,
+    LogFilterIndex const& _index, TransactionReceipt const& _r, size_t& io_tested)
+{
+    h256Hash ret;
+    for (auto const& id : _index.candidates(_r))
+    {
+        ++io_tested;
+        if (!_filters.at(id).matches(_r).empty())
+            ret.insert(id);
+    }
+    return ret;
+}
+
+/// Installs 10000 filters like those of many dapps: the transfers of a token, possibly of one
+/// account, or the events of a contract.
+void installTenThousandFilters(unordered_map<h256, LogFilter>& o_filters, LogFilterIndex& o_index)
+{
+    for (unsigned i = 0; i < 10000; ++i)
+    {
+        LogFilter f;
+        switch (i % 3)
+        {
+        case 0:
+            f = LogFilter().address(Address(i)).topic(0, c_transfer);
+            break;
+        case 1:
+            f = LogFilter().topic(0, c_transfer).topic(1, h256(i));
+            break;
+        default:
+            f = LogFilter().address(Address(i)).address(Address(i + 1));
+        }
+        o_filters.emplace(f.sha3(), f);
+        o_index.insert(f.sha3(), f);
+    }
+}
+
+/// @returns a block of transfers of the tokens and between the accounts with filters.
+vector<TransactionReceipt> transfersBlock()
+{
+    vector<TransactionReceipt> block;
+    for (unsigned i = 0; i < 50; ++i)
+        block.push_back(receipt({LogEntry{Address(i * 37), {c_transfer, h256(i * 53), h256(i)}, {}},
+            LogEntry{Address(i * 41 + 1), {c_approval}, {}}}));
+    return block;
+}
+}  // namespace
+
+TEST(LogFilterIndex, givesFiltersByAddressTopicAndRange)
+{
+    LogFilter const byToken = LogFilter().address(c_token).topic(0, c_transfer);
+    LogFilter const byApproval = LogFilter().topic(0, c_approval);
+    LogFilter const byAlice = LogFilter().topic(0, c_transfer).topic(0, c_approval).topic(1, c_alice);
+    LogFilter const range;
+
+    LogFilterIndex index;
+    index.insert(byToken.sha3(), byToken);
+    index.insert(byApproval.sha3(), byApproval);
+    index.insert(byAlice.sha3(), byAlice);
+    index.insert(range.sha3(), range);
+    EXPECT_EQ(index.size(), 4u);
+
+    EXPECT_EQ(index.candidates(receipt({LogEntry{c_token, {c_approval}, {}}})),
+        (h256Hash{byToken.sha3(), byApproval.sha3(), range.sha3()}));
+    EXPECT_EQ(index.candidates(receipt({LogEntry{c_exchange, {c_transfer, c_alice}, {}}})),
+        (h256Hash{byAlice.sha3(), range.sha3()}));
+    EXPECT_TRUE(index.candidates(receipt({})).empty());
+
+    index.erase(byAlice.sha3(), byAlice);
+    index.erase(range.sha3(), range);
+    EXPECT_EQ(index.size(), 2u);
+    EXPECT_TRUE(index.candidates(receipt({LogEntry{c_exchange, {c_transfer, c_alice}, {}}})).empty());
+}
+
+TEST(LogFilterIndex, logWithoutTopicAtPositionIsNotMatched)
+{
+    LogFilter const secondTopic = LogFilter().address(c_token).topic(1, c_alice);
+    EXPECT_TRUE(secondTopic.matches(receipt({LogEntry{c_token, {c_transfer}, {}}})).empty());
+}
+
+TEST(LogFilterIndex, dispatchesBlockLogsToTenThousandFilters)
+{
+    unordered_map<h256, LogFilter> filters;
+    LogFilterIndex index;
+    installTenThousandFilters(filters, index);
+    vector<TransactionReceipt> const block = transfersBlock();
+
+    vector<h256Hash> all;
+    for (auto const& r : block)
+        all.push_back(matchingAll(filters, r));
+
+    size_t matched = 0;
+    size_t tested = 0;
+    vector<h256Hash> indexed;
+    for (auto const& r : block)
+    {
+        indexed.push_back(matchingIndexed(filters, index, r, tested));
+        matched += indexed.back().size();
+    }
+
+    EXPECT_EQ(indexed, all);
+    EXPECT_GT(matched, 0u);
+    // Only the filters with a term of a log are tested, not all of them for each receipt.
+    RecordProperty("filtersTested", static_cast<int>(tested));
+    EXPECT_LE(tested, 4 * block.size());
+}
+
+// A benchmark, not run by default. Run it with --gtest_also_run_disabled_tests.
+TEST(LogFilterIndex, DISABLED_benchmarkTenThousandFilters)
+{
+    unordered_map<h256, LogFilter> filters;
+    LogFilterIndex index;
+    installTenThousandFilters(filters, index);
+    vector<TransactionReceipt> const block = transfersBlock();
+    unsigned const rounds = 20;
+
+    auto const perBlock = [&](function<void()> const& _dispatch) {
+        auto const start = chrono::steady_clock::now();
+        for (unsigned i = 0; i < rounds; ++i)
+            _dispatch();
+        auto const elapsed = chrono::steady_clock::now() - start;
+        return chrono::duration_cast<chrono::microseconds>(elapsed).count() / rounds;
+    };
+    size_t tested = 0;
+    auto const indexed = perBlock([&] {
+        for (auto const& r : block)
+            matchingIndexed(filters, index, r, tested);
+    });
+    auto const all = perBlock([&] {
+        for (auto const& r : block)
+            matchingAll(filters, r);
+    });
+
+    cout << "Dispatching the logs of " << block.size() << " receipts to " << filters.size()
+         << " filters: " << indexed << " us with the index, " << all << " us testing all\n";
+    RecordProperty("indexedMicroseconds", static_cast<int>(indexed));
+    RecordProperty("allMicroseconds", static_cast<int>(all));
+}
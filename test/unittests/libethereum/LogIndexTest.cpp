@@ -0,0 +1,120 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#include <libdevcore/DBFactory.h>
+#include <libethereum/LogIndex.h>
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::db;
+using namespace dev::eth;
+
+namespace
+{
+Address const c_token{0x100};
+Address const c_exchange{0x200};
+h256 const c_transfer{1};
+h256 const c_approval{2};
+h256 const c_alice{10};
+
+NumberedReceipts block(unsigned _number, LogEntries const& _logs)
+{
+    return {_number, {TransactionReceipt(uint8_t(1), 21000, _logs)}};
+}
+
+class LogIndexTest : public testing::Test
+{
+public:
+    void update(
+        vector<NumberedReceipts> const& _removed, vector<NumberedReceipts> const& _added)
+    {
+        auto batch = extrasDB->createWriteBatch();
+        auto const changes = index.update(*batch, _removed, _added);
+        extrasDB->commit(move(batch));
+        index.noteCommitted(changes);
+    }
+
+    std::unique_ptr<DatabaseFace> extrasDB = DBFactory::create(DatabaseKind::MemoryDB);
+    LogIndex index{*extrasDB, 1, 1024 * 1024};
+};
+}  // namespace
+
+TEST(LogIndexChunk, encodesSparseAndDenseChunks)
+{
+    LogIndexChunk sparse;
+    sparse.insert(5);
+    sparse.insert(1);
+    sparse.insert(65535);
+    sparse.insert(5);
+    bytes const sparseEncoded = sparse.encode();
+    EXPECT_EQ(sparseEncoded.size(), 7u);
+    EXPECT_EQ(LogIndexChunk{&sparseEncoded}.offsets(), (vector<uint16_t>{1, 5, 65535}));
+
+    LogIndexChunk dense;
+    for (unsigned i = 0; i < LogIndexChunk::c_blocks; i += 3)
+        dense.insert(i);
+    bytes const denseEncoded = dense.encode();
+    EXPECT_EQ(denseEncoded.size(), 1 + LogIndexChunk::c_blocks / 8);
+    EXPECT_EQ(LogIndexChunk{&denseEncoded}.offsets(), dense.offsets());
+}
+
+TEST_F(LogIndexTest, matchesAddressesAndTopicPositions)
+{
+    update({}, {block(1, {LogEntry{c_token, {c_transfer, c_alice}, {}}}),
+                   block(2, {LogEntry{c_token, {c_approval}, {}}}),
+                   block(3, {LogEntry{c_exchange, {c_alice, c_transfer}, {}}}),
+                   block(70000, {LogEntry{c_token, {c_transfer}, {}}})});
+
+    array<h256Hash, 4> transferTopic;
+    transferTopic[0] = {c_transfer};
+    EXPECT_EQ(index.matchingBlocks({c_token}, {}, 1, 100000), (vector<unsigned>{1, 2, 70000}));
+    EXPECT_EQ(index.matchingBlocks({}, transferTopic, 1, 100000), (vector<unsigned>{1, 70000}));
+    EXPECT_EQ(index.matchingBlocks({c_token, c_exchange}, transferTopic, 1, 3),
+        (vector<unsigned>{1}));
+
+    array<h256Hash, 4> aliceSecond;
+    aliceSecond[1] = {c_alice};
+    EXPECT_EQ(index.matchingBlocks({}, aliceSecond, 1, 100000), (vector<unsigned>{1}));
+
+    // The index is kept in the database.
+    LogIndex reopened{*extrasDB, 100, 1024};
+    EXPECT_EQ(reopened.firstBlock(), 1u);
+    EXPECT_EQ(reopened.matchingBlocks({c_exchange}, {}, 1, 100000), (vector<unsigned>{3}));
+}
+
+TEST_F(LogIndexTest, reorganisationReplacesBlocks)
+{
+    update({}, {block(1, {LogEntry{c_token, {c_transfer}, {}}}),
+                   block(2, {LogEntry{c_token, {c_transfer}, {}}})});
+
+    update({block(2, {LogEntry{c_token, {c_transfer}, {}}})},
+        {block(2, {LogEntry{c_exchange, {c_transfer}, {}}}),
+            block(3, {LogEntry{c_token, {c_approval}, {}}})});
+
+    EXPECT_EQ(index.matchingBlocks({c_token}, {}, 1, 10), (vector<unsigned>{1, 3}));
+    EXPECT_EQ(index.matchingBlocks({c_exchange}, {}, 1, 10), (vector<unsigned>{2}));
+
+    update({block(1, {LogEntry{c_token, {c_transfer}, {}}})}, {});
+    EXPECT_EQ(index.matchingBlocks({c_token}, {}, 1, 10), (vector<unsigned>{3}));
+}
+
+TEST_F(LogIndexTest, cachesChunksOnceCommitted)
+{
+    update({}, {block(1, {LogEntry{c_token, {c_transfer}, {}}})});
+    EXPECT_EQ(index.matchingBlocks({c_token}, {}, 1, 10), (vector<unsigned>{1}));
+
+    // A batch dropped without being committed leaves the index as it was.
+    auto batch = extrasDB->createWriteBatch();
+    index.update(*batch, {}, {block(2, {LogEntry{c_token, {c_transfer}, {}}})});
+    EXPECT_EQ(index.matchingBlocks({c_token}, {}, 1, 10), (vector<unsigned>{1}));
+    batch.reset();
+    EXPECT_EQ(index.matchingBlocks({c_token}, {}, 1, 10), (vector<unsigned>{1}));
+
+    batch = extrasDB->createWriteBatch();
+    auto const committed = index.update(*batch, {}, {block(3, {LogEntry{c_token, {c_transfer}, {}}})});
+    extrasDB->commit(move(batch));
+    index.noteCommitted(committed);
+    EXPECT_EQ(index.matchingBlocks({c_token}, {}, 1, 10), (vector<unsigned>{1, 3}));
+}
@@ -0,0 +1,88 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#include <libethereum/LogScanPool.h>
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace
+{
+/// Gives each block as many logs as its number modulo 3, numbered by their data.
+void scanBlock(unsigned _number, LocalisedLogEntries& o_logs)
+{
+    for (unsigned i = 0; i < _number % 3; ++i)
+    {
+        LocalisedLogEntry log{LogEntry{Address{}, {}, {static_cast<byte>(i)}}};
+        log.blockNumber = _number;
+        o_logs.push_back(log);
+    }
+}
+
+vector<unsigned> blockRange(unsigned _count)
+{
+    vector<unsigned> ret(_count);
+    for (unsigned i = 0; i < _count; ++i)
+        ret[i] = i;
+    return ret;
+}
+}  // namespace
+
+TEST(LogScanPool, keepsOrderOfBlocks)
+{
+    LogScanPool pool{4};
+    vector<unsigned> const blocks = blockRange(1000);
+
+    LocalisedLogEntries expected;
+    for (auto n : blocks)
+        scanBlock(n, expected);
+
+    LocalisedLogEntries logs;
+    pool.scan(blocks, scanBlock, 0, chrono::steady_clock::time_point::max(), logs);
+
+    ASSERT_EQ(logs.size(), expected.size());
+    for (size_t i = 0; i < logs.size(); ++i)
+    {
+        EXPECT_EQ(logs[i].blockNumber, expected[i].blockNumber);
+        EXPECT_EQ(logs[i].data, expected[i].data);
+    }
+}
+
+TEST(LogScanPool, stopsAtResultLimit)
+{
+    LogScanPool pool{4};
+    atomic<unsigned> scanned{0};
+    auto const countingScan = [&](unsigned _number, LocalisedLogEntries& o_logs) {
+        ++scanned;
+        scanBlock(_number, o_logs);
+    };
+
+    LocalisedLogEntries logs;
+    EXPECT_THROW(pool.scan(blockRange(100000), countingScan, 10,
+                     chrono::steady_clock::time_point::max(), logs),
+        TooManyLogs);
+    EXPECT_TRUE(logs.empty());
+    EXPECT_LT(scanned, 100000u);
+
+    pool.scan(blockRange(10), scanBlock, 10, chrono::steady_clock::time_point::max(), logs);
+    EXPECT_EQ(logs.size(), 9u);
+
+    // The logs given count towards the limit, even once they reach it.
+    EXPECT_THROW(pool.scan({1}, scanBlock, 9, chrono::steady_clock::time_point::max(), logs),
+        TooManyLogs);
+    pool.scan({0, 3}, scanBlock, 9, chrono::steady_clock::time_point::max(), logs);
+    EXPECT_EQ(logs.size(), 9u);
+}
+
+TEST(LogScanPool, stopsAtDeadline)
+{
+    LogScanPool pool{2};
+    LocalisedLogEntries logs;
+    EXPECT_THROW(
+        pool.scan(blockRange(1000), scanBlock, 0,
+            chrono::steady_clock::now() - chrono::milliseconds(1), logs),
+        LogQueryTimeout);
+}
@@ -0,0 +1,166 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#include <libethashseal/Ethash.h>
+#include <libethashseal/GenesisInfo.h>
+#include <libethereum/ChainParams.h>
+#include <libethereum/ReadView.h>
+#include <test/tools/libtestutils/TestLastBlockHashes.h>
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+
+class ReadViewTest : public testing::Test
+{
+public:
+    ReadViewTest()
+    {
+        ethash.setChainParams(ChainParams{genesisInfo(eth::Network::IstanbulTransitionTest)});
+        blockHeader.setGasLimit(10000000);
+    }
+
+    EnvInfo envInfo() const
+    {
+        return {blockHeader, lastBlockHashes, 0, ethash.chainParams().chainID};
+    }
+
+    Transaction callTo(Address const& _to, u256 const& _gas = 1000000) const
+    {
+        Transaction t(0, 0, _gas, _to, bytes(), 0);
+        t.forceSender(sender);
+        return t;
+    }
+
+    Ethash ethash;
+    BlockHeader blockHeader;
+    TestLastBlockHashes lastBlockHashes{{}};
+    State state{0};
+
+    Address contract{"0xa94f5374fce5edbc8e2a8697c15331677e6ebf0b"};
+    Address sender{"0xaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"};
+};
+
+TEST_F(ReadViewTest, executeDiscardsChanges)
+{
+    // SSTORE(0, 1); MSTORE(0, 42); RETURN(0, 32)
+    state.createContract(contract);
+    state.setCode(contract, fromHex("6001600055602a60005260206000f3"), 0);
+    state.commit(State::CommitBehaviour::KeepEmptyAccounts);
+
+    ReadView const view{blockHeader, 0, state};
+    vector<ExecutionResult> results(4);
+    vector<thread> threads;
+    for (auto& result : results)
+        threads.emplace_back([&] { result = view.execute(envInfo(), ethash, callTo(contract)); });
+    for (auto& t : threads)
+        t.join();
+
+    for (auto const& result : results)
+    {
+        EXPECT_EQ(result.excepted, TransactionException::None);
+        EXPECT_EQ(u256(h256(result.output)), 42);
+    }
+    EXPECT_EQ(view.state().storage(contract, 0), 0);
+    EXPECT_EQ(view.state().getNonce(sender), 0);
+}
+
+TEST_F(ReadViewTest, executeTimesOut)
+{
+    // JUMPDEST; PUSH1 0; JUMP
+    state.createContract(contract);
+    state.setCode(contract, fromHex("5b600056"), 0);
+    state.commit(State::CommitBehaviour::KeepEmptyAccounts);
+
+    ReadView const view{blockHeader, 0, state};
+    auto const result = view.execute(envInfo(), ethash, callTo(contract, 9000000), 0,
+        chrono::steady_clock::now() - chrono::seconds(1));
+    EXPECT_EQ(result.excepted, TransactionException::ExecutionTimeout);
+
+    CallLimits limits;
+    limits.time = chrono::milliseconds(0);
+    EXPECT_EQ(callDeadline(limits), chrono::steady_clock::time_point::max());
+}
+
+TEST_F(ReadViewTest, executeTimesOutInNestedCall)
+{
+    // The callee loops; the caller ignores the result of the call and returns 42:
+    // CALL(GAS, callee, 0, 0, 0, 0, 0); POP; MSTORE(0, 42); RETURN(0, 32)
+    Address const callee{"0xbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb"};
+    state.createContract(callee);
+    state.setCode(callee, fromHex("5b600056"), 0);
+    state.createContract(contract);
+    state.setCode(contract,
+        fromHex("6000600060006000600073" + callee.hex() + "5af150602a60005260206000f3"), 0);
+    state.commit(State::CommitBehaviour::KeepEmptyAccounts);
+
+    // The timeout fails the whole call, not only the frame of the callee.
+    ReadView const view{blockHeader, 0, state};
+    auto const result = view.execute(envInfo(), ethash, callTo(contract, 9000000), 0,
+        chrono::steady_clock::now() - chrono::seconds(1));
+    EXPECT_EQ(result.excepted, TransactionException::ExecutionTimeout);
+    EXPECT_TRUE(result.output.empty());
+}
+
+TEST_F(ReadViewTest, estimateGasFindsLowestLimit)
+{
+    // SSTORE(0, 1); SSTORE(1, 1); SSTORE(1, 0), refunding part of the second store
+    state.createContract(contract);
+    state.setCode(contract, fromHex("600160005560016001556000600155"), 0);
+    state.commit(State::CommitBehaviour::KeepEmptyAccounts);
+
+    ReadView const view{blockHeader, 0, state};
+    auto const transactionWithGas = [&](int64_t _gas) { return callTo(contract, _gas); };
+    unsigned rounds = 0;
+    auto const estimate = view.estimateGas(lastBlockHashes, ethash, transactionWithGas, 21000,
+        5000000, chrono::steady_clock::time_point::max(),
+        [&](GasEstimationProgress const&) { ++rounds; });
+
+    EXPECT_EQ(estimate.second.excepted, TransactionException::None);
+    EXPECT_GT(rounds, 0u);
+    auto const gas = static_cast<int64_t>(estimate.first);
+    EnvInfo const enough{blockHeader, lastBlockHashes, 0, gas, ethash.chainParams().chainID};
+    EXPECT_EQ(view.execute(enough, ethash, callTo(contract, gas)).excepted,
+        TransactionException::None);
+    EnvInfo const insufficient{blockHeader, lastBlockHashes, 0, gas - 1, ethash.chainParams().chainID};
+    EXPECT_EQ(view.execute(insufficient, ethash, callTo(contract, gas - 1)).excepted,
+        TransactionException::OutOfGas);
+}
+
+TEST_F(ReadViewTest, estimateGasUpToLargestGasLimit)
+{
+    // Fails with a bad jump unless more than 1000000 gas is left, which is much more than it
+    // consumes: JUMPI(12, LT(1000000, GAS)); JUMP(0); 12: JUMPDEST; STOP
+    state.createContract(contract);
+    state.setCode(contract, fromHex("5a620f424010600c576000565b00"), 0);
+    state.commit(State::CommitBehaviour::KeepEmptyAccounts);
+
+    ReadView const view{blockHeader, 0, state};
+    auto const transactionWithGas = [&](int64_t _gas) { return callTo(contract, _gas); };
+    auto const estimate = view.estimateGas(
+        lastBlockHashes, ethash, transactionWithGas, 21000, numeric_limits<int64_t>::max());
+    auto const expected =
+        view.estimateGas(lastBlockHashes, ethash, transactionWithGas, 21000, 5000000);
+
+    EXPECT_EQ(estimate.second.excepted, TransactionException::None);
+    EXPECT_EQ(estimate.first, expected.first);
+}
+
+TEST_F(ReadViewTest, estimateGasTimesOut)
+{
+    // JUMPDEST; PUSH1 0; JUMP
+    state.createContract(contract);
+    state.setCode(contract, fromHex("5b600056"), 0);
+    state.commit(State::CommitBehaviour::KeepEmptyAccounts);
+
+    ReadView const view{blockHeader, 0, state};
+    auto const transactionWithGas = [&](int64_t _gas) { return callTo(contract, _gas); };
+    auto const estimate = view.estimateGas(lastBlockHashes, ethash, transactionWithGas, 21000,
+        5000000, chrono::steady_clock::now() - chrono::seconds(1));
+    EXPECT_EQ(estimate.first, 5000000);
+    EXPECT_EQ(estimate.second.excepted, TransactionException::ExecutionTimeout);
+}
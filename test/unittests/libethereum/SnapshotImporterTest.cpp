@@ -6,6 +6,8 @@
 #include <libethereum/StateImporter.h>
 #include <libethereum/BlockChainImporter.h>
 #include <libethereum/SnapshotStorage.h>
+#include <libdevcore/OverlayDB.h>
+#include <libdevcore/TrieDB.h>
 #include <test/tools/libtesteth/TestHelper.h>
 
 using namespace dev;
@@ -33,6 +35,18 @@ namespace
 				importedAccounts.emplace(std::make_pair(_addressHash, ImportedAccount{_nonce, _balance, _storage,  _codeHash}));
 		}
 
+		void importAccount(h256 const& _addressHash, u256 const& _nonce, u256 const& _balance, StorageTrie const& _storage, h256 const& _codeHash) override
+		{
+			StateCacheDB db;
+			for (auto const& node: _storage.nodes)
+				db.insert(node.first, &node.second);
+			std::map<h256, bytes> storage;
+			SpecificTrieDB<GenericTrieDB<StateCacheDB>, h256> trie(&db, _storage.root);
+			for (auto const& keyValue: trie)
+				storage.emplace(keyValue.first, keyValue.second.toBytes());
+			importAccount(_addressHash, _nonce, _balance, storage, _codeHash);
+		}
+
 		h256 importCode(bytesConstRef _code) override
 		{ 
 			importedCodes.push_back(_code.toBytes());
@@ -319,6 +333,28 @@ BOOST_AUTO_TEST_CASE(SnapshotImporterSuite_commitStateOnceEveryChunk)
 	BOOST_REQUIRE_EQUAL(stateImporter.commitCounter, 2);
 }
 
+BOOST_AUTO_TEST_CASE(SnapshotImporterSuite_storageTrieBuiltApartMatchesState)
+{
+	std::map<h256, bytes> storage;
+	for (unsigned i = 1; i <= 100; ++i)
+		storage.emplace(sha3(toBigEndian(u256(i))), rlp(i));
+
+	OverlayDB db1;
+	auto stateImporter1 = createStateImporter(db1);
+	stateImporter1->importAccount(sha3("456"), 1, 10, storage, EmptySHA3);
+
+	OverlayDB db2;
+	auto stateImporter2 = createStateImporter(db2);
+	StorageTrie const storageTrie = buildStorageTrie(storage);
+	stateImporter2->importAccount(sha3("456"), 1, 10, storageTrie, EmptySHA3);
+	stateImporter2->importAccount(sha3("789"), 1, 10, storageTrie, EmptySHA3);
+	stateImporter1->importAccount(sha3("789"), 1, 10, storage, EmptySHA3);
+
+	BOOST_CHECK_EQUAL(stateImporter2->stateRoot(), stateImporter1->stateRoot());
+	SpecificTrieDB<GenericTrieDB<OverlayDB>, h256> storageDB(&db2, storageTrie.root);
+	BOOST_CHECK_EQUAL(storageDB.at(sha3(toBigEndian(u256(7)))), asString(rlp(7)));
+}
+
 
 BOOST_AUTO_TEST_CASE(SnapshotImporterSuite_importEmptyBlock)
 {
@@ -75,6 +75,36 @@ BOOST_AUTO_TEST_CASE(SetEmptyCode)
     BOOST_CHECK(!s.db().exists(EmptySHA3));
 }
 
+BOOST_AUTO_TEST_CASE(CopyIsolation)
+{
+    Address addr{"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"};
+    State s{0};
+    s.addBalance(addr, 10);
+    s.setStorage(addr, 1, 1);
+    s.commit(State::CommitBehaviour::KeepEmptyAccounts);
+    BOOST_CHECK_EQUAL(s.balance(addr), 10);
+
+    // The copy shares the cached account; changes on either side stay private.
+    s.shareCaches();
+    State copy = s;
+    copy.addBalance(addr, 5);
+    copy.setStorage(addr, 1, 2);
+    BOOST_CHECK_EQUAL(copy.balance(addr), 15);
+    BOOST_CHECK_EQUAL(copy.storage(addr, 1), 2);
+    BOOST_CHECK_EQUAL(s.balance(addr), 10);
+    BOOST_CHECK_EQUAL(s.storage(addr, 1), 1);
+
+    s.subBalance(addr, 3);
+    copy.commit(State::CommitBehaviour::KeepEmptyAccounts);
+    BOOST_CHECK_EQUAL(copy.balance(addr), 15);
+    BOOST_CHECK_EQUAL(s.balance(addr), 7);
+
+    State other = copy;
+    other = s;
+    BOOST_CHECK_EQUAL(other.balance(addr), 7);
+    BOOST_CHECK_EQUAL(other.storage(addr, 1), 1);
+}
+
 BOOST_AUTO_TEST_CASE(CodeVersionZero)
 {
     Address addr{"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"};
@@ -8,6 +8,7 @@
 #include "test/tools/libtesteth/TestHelper.h"
 #include <libethcore/Exceptions.h>
 #include <libethcore/Common.h>
+#include <libethcore/SenderCache.h>
 #include <libevm/VMFace.h>
 using namespace dev;
 using namespace eth;
@@ -103,6 +104,29 @@ BOOST_AUTO_TEST_CASE(TransactionReplayProtected)
     BOOST_REQUIRE(txRlpStream.out() == txRlp);
 }
 
+BOOST_AUTO_TEST_CASE(TransactionSenderCached)
+{
+    // The EIP-155 example transaction
+    auto txRlp = fromHex(
+        "0xf86c098504a817c800825208943535353535353535353535353535353535353535880de0b6b3a76400008025"
+        "a028ef61340bd939bc2195fe537567866003e1a15d3c71ff63e1590620aa636276a067cbe9d8997f761aecb703"
+        "304b3800ccf555c9f3dc64214b297fb1966a3b6d83");
+    Address const sender{"9d8a62f656a8d1615c1294fd71e9cfb3e4855a4f"};
+
+    auto& senderCache = SenderCache::instance();
+    senderCache.clear();
+
+    Transaction tx(txRlp, CheckTransaction::Everything);
+    BOOST_CHECK_EQUAL(tx.sender(), sender);
+    BOOST_REQUIRE(senderCache.lookup(tx.sha3()));
+    BOOST_CHECK_EQUAL(*senderCache.lookup(tx.sha3()), sender);
+
+    // Another copy of the transaction gets the sender from the cache.
+    senderCache.insert(tx.sha3(), Address{1});
+    BOOST_CHECK_EQUAL(Transaction(txRlp, CheckTransaction::None).sender(), Address{1});
+    senderCache.clear();
+}
+
 BOOST_AUTO_TEST_CASE(ExecutionResultOutput)
 {
     std::stringstream buffer;
@@ -4,7 +4,11 @@
 
 /// @file
 /// TransactionQueue test functions.
+#include <libdevcore/OverlayDB.h>
+#include <libethereum/BlockQueue.h>
+#include <libethereum/EthereumCapability.h>
 #include <libethereum/TransactionQueue.h>
+#include <libp2p/CapabilityHost.h>
 #include <test/tools/libtesteth/TestHelper.h>
 #include <test/tools/libtesteth/BlockChainHelper.h>
 
@@ -12,6 +16,33 @@ using namespace std;
 using namespace dev;
 using namespace dev::eth;
 using namespace dev::test;
+namespace utf = boost::unit_test;
+
+namespace
+{
+/// Capability host that drops every message.
+class NullCapabilityHost : public p2p::CapabilityHostFace
+{
+public:
+    boost::optional<p2p::PeerSessionInfo> peerSessionInfo(p2p::NodeID const&) const override
+    {
+        return {};
+    }
+    void disconnect(p2p::NodeID const&, p2p::DisconnectReason) override {}
+    void disableCapability(p2p::NodeID const&, string const&, string const&) override {}
+    RLPStream& prep(p2p::NodeID const&, string const&, RLPStream& _s, unsigned, unsigned) override
+    {
+        return _s;
+    }
+    void sealAndSend(p2p::NodeID const&, RLPStream&) override {}
+    void addNote(p2p::NodeID const&, string const&, string const&) override {}
+    void updateRating(p2p::NodeID const&, int) override {}
+    void setRude(p2p::NodeID const&, string const&) override {}
+    bool isRude(p2p::NodeID const&, string const&) const override { return false; }
+    void foreachPeer(string const&, function<bool(p2p::NodeID const&)>) const override {}
+    void postWork(function<void()>) override {}
+};
+}  // namespace
 
 BOOST_FIXTURE_TEST_SUITE(TransactionQueueSuite, TestOutputHelperFixture)
 
@@ -88,28 +119,31 @@ BOOST_AUTO_TEST_CASE(tqPriority)
     BOOST_CHECK((Transactions { tx0_1, tx1 }) == txq.topTransactions(256));
     txq.import(tx2);
     BOOST_CHECK((Transactions { tx2, tx0_1, tx1 }) == txq.topTransactions(256));
+    // The senders are merged by gas price, each sender's transactions staying in nonce order:
+    // tx3 is more expensive than tx1 and comes first, tx4 waits for tx1 of its sender.
     txq.import(tx3);
-    BOOST_CHECK((Transactions { tx2, tx0_1, tx1, tx3 }) == txq.topTransactions(256));
+    BOOST_CHECK((Transactions { tx2, tx0_1, tx3, tx1 }) == txq.topTransactions(256));
     txq.import(tx4);
-    BOOST_CHECK((Transactions { tx2, tx0_1, tx1, tx3, tx4 }) == txq.topTransactions(256));
+    BOOST_CHECK((Transactions { tx2, tx0_1, tx3, tx1, tx4 }) == txq.topTransactions(256));
     txq.import(tx5);
-    BOOST_CHECK((Transactions { tx2, tx0_1, tx1, tx3, tx5, tx4 }) == txq.topTransactions(256));
+    BOOST_CHECK((Transactions { tx2, tx0_1, tx3, tx5, tx1, tx4 }) == txq.topTransactions(256));
 
     txq.drop(tx0_1.sha3());
-    BOOST_CHECK((Transactions { tx2, tx1, tx3, tx5, tx4 }) == txq.topTransactions(256));
+    BOOST_CHECK((Transactions { tx2, tx3, tx5, tx1, tx4 }) == txq.topTransactions(256));
+    // tx4 is now the first transaction of its sender, as expensive as tx2 but with a higher nonce.
     txq.drop(tx1.sha3());
-    BOOST_CHECK((Transactions { tx2, tx3, tx5, tx4 }) == txq.topTransactions(256));
+    BOOST_CHECK((Transactions { tx2, tx4, tx3, tx5 }) == txq.topTransactions(256));
     txq.drop(tx5.sha3());
-    BOOST_CHECK((Transactions { tx2, tx3, tx4 }) == txq.topTransactions(256));
+    BOOST_CHECK((Transactions { tx2, tx4, tx3 }) == txq.topTransactions(256));
 
     Transaction tx6(0, gasCostMed, gas, dest, bytes(), 20, sender1 );
     txq.import(tx6);
-    BOOST_CHECK((Transactions { tx2, tx3, tx4, tx6 }) == txq.topTransactions(256));
+    BOOST_CHECK((Transactions { tx2, tx4, tx6, tx3 }) == txq.topTransactions(256));
 
     Transaction tx7(0, gasCostMed, gas, dest, bytes(), 2, sender2 );
     txq.import(tx7);
     // deterministic signature: hash of tx5 and tx7 will be same
-    BOOST_CHECK((Transactions { tx2, tx3, tx4, tx6 }) == txq.topTransactions(256));
+    BOOST_CHECK((Transactions { tx2, tx4, tx6, tx3 }) == txq.topTransactions(256));
 
 }
 
@@ -168,6 +202,93 @@ BOOST_AUTO_TEST_CASE(tqLimits)
     BOOST_CHECK((Transactions { tx5, tx0, tx1 }) == txq.topTransactions(256));
 }
 
+BOOST_AUTO_TEST_CASE(tqPriceOrder)
+{
+    dev::eth::TransactionQueue txq;
+    const u256 gas = 25000;
+    Address dest = Address("0x095e7baea6a6c7c4c2dfeb977efac326af552d87");
+    Secret sender1 = Secret("0x3333333333333333333333333333333333333333333333333333333333333333");
+    Secret sender2 = Secret("0x4444444444444444444444444444444444444444444444444444444444444444");
+    Transaction tx0(0, 10 * szabo, gas, dest, bytes(), 0, sender1);
+    Transaction tx1(1, 40 * szabo, gas, dest, bytes(), 1, sender1);
+    Transaction tx2(2, 20 * szabo, gas, dest, bytes(), 0, sender2);
+    Transaction tx3(3, 30 * szabo, gas, dest, bytes(), 1, sender2);
+
+    txq.import(tx1);
+    txq.import(tx3);
+    txq.import(tx2);
+    txq.import(tx0);
+    // The senders are ordered by gas price, the transactions of a sender by nonce.
+    BOOST_CHECK((Transactions{tx2, tx3, tx0, tx1}) == txq.topTransactions(256));
+    BOOST_CHECK((Transactions{tx2, tx3}) == txq.topTransactions(2));
+    BOOST_CHECK((Transactions{tx2, tx0, tx1}) == txq.topTransactions(256, h256Hash{tx3.sha3()}));
+}
+
+BOOST_AUTO_TEST_CASE(tqEvictCheapest)
+{
+    dev::eth::TransactionQueue txq(3, 3);
+    const u256 gas = 25000;
+    Address dest = Address("0x095e7baea6a6c7c4c2dfeb977efac326af552d87");
+    Secret sender1 = Secret("0x3333333333333333333333333333333333333333333333333333333333333333");
+    Secret sender2 = Secret("0x4444444444444444444444444444444444444444444444444444444444444444");
+    Transaction tx0(0, 20 * szabo, gas, dest, bytes(), 0, sender1);
+    Transaction tx1(1, 20 * szabo, gas, dest, bytes(), 1, sender1);
+    Transaction tx2(2, 10 * szabo, gas, dest, bytes(), 0, sender2);
+    Transaction tx3(3, 30 * szabo, gas, dest, bytes(), 1, sender2);
+    Transaction tx4(4, 30 * szabo, gas, dest, bytes(), 2, sender1);
+
+    txq.import(tx0);
+    txq.import(tx1);
+    txq.import(tx2);
+    txq.import(tx3);
+    // The last transaction of sender2 is the more expensive one, so sender1 loses its last one.
+    BOOST_CHECK((Transactions{tx0, tx2, tx3}) == txq.topTransactions(256));
+    BOOST_CHECK(txq.knownTransactions() == (h256Hash{tx0.sha3(), tx2.sha3(), tx3.sha3()}));
+
+    // The import succeeds, the limits then evicting the transaction at once.
+    BOOST_CHECK(txq.import(tx4) == ImportResult::Success);
+    BOOST_CHECK(!txq.knownTransactions().count(tx4.sha3()));
+    BOOST_CHECK(txq.status().current == 3);
+    BOOST_CHECK_EQUAL(txq.waiting(tx4.from()), 1);
+}
+
+BOOST_AUTO_TEST_CASE(tqBytesLimit)
+{
+    TestTransaction testTransaction = TestTransaction::defaultTransaction(1);
+    size_t const size = testTransaction.transaction().rlp().size();
+    TransactionQueue tq(TransactionQueue::Limits{1024, 1024, 3 * size});
+    Address from;
+    for (size_t i = 1; i < 6; i++)
+    {
+        // The transactions past the limit are the last ones of their sender and evicted at once.
+        TestTransaction testTransaction = TestTransaction::defaultTransaction(i);
+        BOOST_REQUIRE(tq.import(testTransaction.transaction()) == ImportResult::Success);
+        from = testTransaction.transaction().from();
+    }
+    BOOST_CHECK_EQUAL(tq.waiting(from), 3);
+    BOOST_CHECK_EQUAL(tq.maxNonce(from), 4);
+    BOOST_CHECK_EQUAL(tq.limits().bytes, 3 * size);
+}
+
+BOOST_AUTO_TEST_CASE(tqBatchImport)
+{
+    TransactionQueue tq;
+    TestTransaction testTransaction1 = TestTransaction::defaultTransaction(1);
+    TestTransaction testTransaction2 = TestTransaction::defaultTransaction(2);
+    TestTransaction testTransaction3 = TestTransaction::defaultTransaction(2, 0);
+    tq.import(testTransaction1.transaction());
+
+    vector<ImportResult> results = tq.import(Transactions{testTransaction1.transaction(),
+        testTransaction2.transaction(), testTransaction3.transaction(),
+        testTransaction2.transaction()});
+    BOOST_REQUIRE_EQUAL(results.size(), 4);
+    BOOST_CHECK(results[0] == ImportResult::AlreadyKnown);
+    BOOST_CHECK(results[1] == ImportResult::Success);
+    BOOST_CHECK(results[2] == ImportResult::OverbidGasPrice);
+    BOOST_CHECK(results[3] == ImportResult::AlreadyKnown);
+    BOOST_CHECK_EQUAL(tq.topTransactions(10).size(), 2);
+}
+
 BOOST_AUTO_TEST_CASE(tqImport)
 {
     TestTransaction testTransaction = TestTransaction::defaultTransaction();
@@ -288,4 +409,64 @@ BOOST_AUTO_TEST_CASE(tqEqueue)
     BOOST_REQUIRE(topTr.size() == 1);
 }
 
+BOOST_AUTO_TEST_CASE(tqBenchPeerTransactions, *utf::label("perf"))
+{
+    if (!Options::get().all)
+    {
+        cout << "Skipping test TransactionQueueSuite/tqBenchPeerTransactions. Use --all to run it.\n";
+        return;
+    }
+
+    size_t const senderCount = 100;
+    size_t const transactionsPerSender = 100;
+    size_t const packetSize = 256;
+    Address dest = Address("0x095e7baea6a6c7c4c2dfeb977efac326af552d87");
+
+    vector<bytes> transactions;
+    for (size_t i = 0; i < senderCount; ++i)
+    {
+        KeyPair const sender = KeyPair::create();
+        for (size_t nonce = 0; nonce < transactionsPerSender; ++nonce)
+            transactions.push_back(
+                Transaction(0, 20 * szabo + i, 25000, dest, bytes(), nonce, sender.secret()).rlp());
+    }
+    vector<bytes> packets;
+    for (size_t i = 0; i < transactions.size(); i += packetSize)
+    {
+        size_t const count = min(packetSize, transactions.size() - i);
+        RLPStream packet(count);
+        for (size_t j = i; j < i + count; ++j)
+            packet.appendRaw(transactions[j]);
+        packets.push_back(packet.out());
+    }
+
+    TestBlockChain blockchain;
+    OverlayDB db;
+    BlockQueue bq;
+    TransactionQueue tq(transactions.size(), transactions.size());
+    atomic<size_t> processed{0};
+    auto importHandler =
+        tq.onImport([&](ImportResult, h256 const&, h512 const&) { ++processed; });
+    EthereumCapability capability{
+        make_shared<NullCapabilityHost>(), blockchain.getInterface(), db, tq, bq, 1};
+    p2p::NodeID const peer{1};
+    capability.onConnect(peer, capability.protocolVersion());
+
+    Timer timer;
+    for (auto const& packet : packets)
+    {
+        // Transactions that don't fit into the verification queue would be dropped.
+        while (tq.status().unverified > 4096)
+            this_thread::yield();
+        capability.interpretCapabilityPacket(peer, TransactionsPacket, RLP(packet));
+    }
+    while (processed < transactions.size())
+        this_thread::sleep_for(chrono::milliseconds(1));
+    double const elapsed = timer.elapsed();
+
+    BOOST_CHECK_EQUAL(tq.status().current, transactions.size());
+    cout << transactions.size() << " transactions in " << elapsed * 1000 << " ms, "
+         << transactions.size() / elapsed << " tx/s\n";
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,59 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#include <libevm/VMMemoryPool.h>
+#include <gtest/gtest.h>
+
+using namespace dev;
+using namespace dev::eth;
+
+TEST(VMMemoryPool, releasedBufferIsReused)
+{
+    VMMemoryPool pool;
+
+    bytes buffer = pool.acquire();
+    pool.resize(buffer, 1024);
+    EXPECT_EQ(pool.stats().frames, 1u);
+    EXPECT_EQ(pool.stats().reused, 0u);
+    EXPECT_EQ(pool.stats().allocations, 1u);
+
+    auto const data = buffer.data();
+    pool.release(std::move(buffer));
+
+    bytes reused = pool.acquire();
+    EXPECT_TRUE(reused.empty());
+    pool.resize(reused, 512);
+    EXPECT_EQ(reused.data(), data);
+    EXPECT_EQ(pool.stats().frames, 2u);
+    EXPECT_EQ(pool.stats().reused, 1u);
+    EXPECT_EQ(pool.stats().allocations, 1u);
+}
+
+TEST(VMMemoryPool, reusedBufferIsZeroed)
+{
+    VMMemoryPool pool;
+
+    bytes buffer = pool.acquire();
+    pool.assign(buffer, bytes(64, 0xff).data(), 64);
+    pool.release(std::move(buffer));
+
+    bytes reused = pool.acquire();
+    pool.resize(reused, 64);
+    EXPECT_EQ(reused, bytes(64, 0));
+}
+
+TEST(VMMemoryPool, statsDifference)
+{
+    VMMemoryPool pool;
+    auto const before = pool.stats();
+
+    bytes buffer = pool.acquire();
+    pool.resize(buffer, 32);
+    pool.resize(buffer, 16);
+
+    auto const diff = pool.stats() - before;
+    EXPECT_EQ(diff.frames, 1u);
+    EXPECT_EQ(diff.reused, 0u);
+    EXPECT_EQ(diff.allocations, 1u);
+}
@@ -6,6 +6,7 @@
 #include <libethereum/LastBlockHashesFace.h>
 #include <libevm/EVMC.h>
 #include <libevm/LegacyVM.h>
+#include <libevm/VMProfiler.h>
 #include <test/tools/jsontests/vm.h>
 #include <test/tools/libtesteth/BlockChainHelper.h>
 #include <test/tools/libtesteth/TestOutputHelper.h>
@@ -1053,6 +1054,107 @@ public:
     LegacyVMCallFixture() : CallFixture{new LegacyVM} {};
 };
 
+class ProfilerFixture : public TestOutputHelperFixture
+{
+public:
+    explicit ProfilerFixture(VMFace* _vm) : vm{_vm}
+    {
+        VMProfiler::instance().reset();
+        VMProfiler::instance().setEnabled(true);
+    }
+    ~ProfilerFixture()
+    {
+        VMProfiler::instance().setEnabled(false);
+        VMProfiler::instance().reset();
+    }
+
+    void testProfileCountsOpcodesAndGas()
+    {
+        ExtVM extVm(state, envInfo, *se, address, address, address, value, gasPrice, {}, ref(code),
+            sha3(code), version, depth, isCreate, staticCall);
+
+        vm->exec(gas, extVm, OnOpFunc{});
+
+        VMProfiles const profiles = VMProfiler::instance().profiles();
+        BOOST_REQUIRE_EQUAL(profiles.size(), 1);
+        BOOST_REQUIRE(profiles.count(sha3(code)));
+        OpcodeProfile const& profile = profiles.at(sha3(code));
+
+        auto const counters = [&](Instruction _op) {
+            return profile[static_cast<size_t>(_op)];
+        };
+        BOOST_CHECK_EQUAL(counters(Instruction::PUSH1).count, 3);
+        BOOST_CHECK_EQUAL(counters(Instruction::PUSH1).gas, 9);
+        BOOST_CHECK_EQUAL(counters(Instruction::ADD).count, 1);
+        BOOST_CHECK_EQUAL(counters(Instruction::ADD).gas, 3);
+        // 3 for the instruction and 3 for expanding the memory to one word.
+        BOOST_CHECK_EQUAL(counters(Instruction::MSTORE).count, 1);
+        BOOST_CHECK_EQUAL(counters(Instruction::MSTORE).gas, 6);
+        BOOST_CHECK_EQUAL(counters(Instruction::STOP).count, 1);
+        BOOST_CHECK_EQUAL(counters(Instruction::STOP).gas, 0);
+
+        uint64_t total = 0;
+        for (auto const& c : profile)
+            total += c.count;
+        BOOST_CHECK_EQUAL(total, 6);
+    }
+
+    void testProfileExcludesGasForwardedByCall()
+    {
+        // pop(call(10000, 0x4, 0, 0, 0, 0, 0))
+        // stop
+        bytes const callCode = fromHex("600060006000600060006004612710f15000");
+        ExtVM extVm(state, envInfo, *se, address, address, address, value, gasPrice, {},
+            ref(callCode), sha3(callCode), version, depth, isCreate, staticCall);
+
+        vm->exec(gas, extVm, OnOpFunc{});
+
+        VMProfiles const profiles = VMProfiler::instance().profiles();
+        BOOST_REQUIRE(profiles.count(sha3(callCode)));
+        OpcodeCounters const& counters =
+            profiles.at(sha3(callCode))[static_cast<size_t>(Instruction::CALL)];
+        BOOST_CHECK_EQUAL(counters.count, 1);
+        // The 10000 gas forwarded to the precompile are not charged to the CALL.
+        BOOST_CHECK_EQUAL(counters.gas, 700);
+    }
+
+    BlockHeader blockHeader{initBlockHeader()};
+    LastBlockHashes lastBlockHashes;
+    Address address{KeyPair::create().address()};
+    State state{0};
+    std::unique_ptr<SealEngineFace> se{
+        ChainParams(genesisInfo(Network::IstanbulTest)).createSealEngine()};
+    EnvInfo envInfo{blockHeader, lastBlockHashes, 0, se->chainParams().chainID};
+
+    u256 value = 0;
+    u256 gasPrice = 1;
+    u256 version = IstanbulSchedule.accountVersion;
+    int depth = 0;
+    bool isCreate = false;
+    bool staticCall = false;
+    u256 gas = 1000000;
+
+    // mstore(0, add(2, 1))
+    // stop
+    bytes code = fromHex("600160020160005200");
+
+    std::unique_ptr<VMFace> vm;
+};
+
+class LegacyVMProfilerFixture : public ProfilerFixture
+{
+public:
+    LegacyVMProfilerFixture() : ProfilerFixture{new LegacyVM} {}
+};
+
+class AlethInterpreterProfilerFixture : public ProfilerFixture
+{
+public:
+    AlethInterpreterProfilerFixture()
+      : ProfilerFixture{new EVMC{evmc_create_aleth_interpreter(), {}}}
+    {}
+};
+
 }  // namespace
 
 BOOST_FIXTURE_TEST_SUITE(LegacyVMSuite, TestOutputHelperFixture)
@@ -1275,6 +1377,20 @@ BOOST_AUTO_TEST_CASE(LegacyVMTestDelegateCallSelfCorrectCost)
 
 BOOST_AUTO_TEST_SUITE_END()
 
+BOOST_FIXTURE_TEST_SUITE(LegacyVMProfilerSuite, LegacyVMProfilerFixture)
+
+BOOST_AUTO_TEST_CASE(LegacyVMProfileCountsOpcodesAndGas)
+{
+    testProfileCountsOpcodesAndGas();
+}
+
+BOOST_AUTO_TEST_CASE(LegacyVMProfileExcludesGasForwardedByCall)
+{
+    testProfileExcludesGasForwardedByCall();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_FIXTURE_TEST_SUITE(AlethInterpreterSuite, TestOutputHelperFixture)
@@ -1406,4 +1522,18 @@ BOOST_AUTO_TEST_CASE(AlethInterpreterSelfBalanceisInvalidBeforeIstanbul)
 }
 BOOST_AUTO_TEST_SUITE_END()
 
+BOOST_FIXTURE_TEST_SUITE(AlethInterpreterProfilerSuite, AlethInterpreterProfilerFixture)
+
+BOOST_AUTO_TEST_CASE(AlethInterpreterProfileCountsOpcodesAndGas)
+{
+    testProfileCountsOpcodesAndGas();
+}
+
+BOOST_AUTO_TEST_CASE(AlethInterpreterProfileExcludesGasForwardedByCall)
+{
+    testProfileExcludesGasForwardedByCall();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -91,3 +91,43 @@ TEST(OverlayDB, rollback)
     odb.rollback();
     EXPECT_TRUE(!odb.get().size());
 }
+
+TEST(OverlayDB, copyIsolation)
+{
+    std::unique_ptr<db::DatabaseFace> db = DBFactory::create(DatabaseKind::MemoryDB);
+    ASSERT_TRUE(db);
+
+    OverlayDB odb(std::move(db));
+    string const value = "\x43";
+    string const otherValue = "\x44";
+
+    odb.insert(h256(42), &value);
+    odb.freeze();
+    OverlayDB copy = odb;
+    EXPECT_EQ(copy.lookup(h256(42)), value);
+
+    // Writes after the copy are private to each side.
+    copy.insert(h256(43), &otherValue);
+    odb.insert(h256(44), &otherValue);
+    EXPECT_TRUE(copy.exists(h256(43)));
+    EXPECT_FALSE(copy.exists(h256(44)));
+    EXPECT_TRUE(odb.exists(h256(44)));
+    EXPECT_FALSE(odb.exists(h256(43)));
+
+    // Killing a shared node in the copy leaves the original intact.
+    {
+        EnforceRefs enforceRefs(copy, true);
+        copy.kill(h256(42));
+        EXPECT_FALSE(copy.exists(h256(42)));
+    }
+    EnforceRefs enforceRefs(odb, true);
+    EXPECT_TRUE(odb.exists(h256(42)));
+    EXPECT_EQ(odb.get().size(), 2);
+    EXPECT_EQ(odb.keys().size(), 2);
+
+    odb.commit();
+    EXPECT_TRUE(!odb.get().size());
+    EXPECT_EQ(odb.lookup(h256(42)), value);
+    EXPECT_EQ(odb.lookup(h256(44)), otherValue);
+    EXPECT_EQ(copy.lookup(h256(43)), otherValue);
+}
@@ -0,0 +1,16 @@
+{
+	// The outermost frame (no call data) repeats the recursion, nested frames
+	// call themselves until the call depth limit stops them, as in the
+	// callDepth state tests.
+	switch calldatasize()
+	case 0 {
+		for { let i := 0 } lt(i, 256) { i := add(i, 1) } {
+			mstore(0, 1)
+			pop(call(gas(), address(), 0, 0, 32, 0, 0))
+		}
+	}
+	default {
+		mstore(0, 1)
+		pop(call(gas(), address(), 0, 0, 32, 0, 0))
+	}
+}
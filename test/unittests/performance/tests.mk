@@ -3,6 +3,10 @@
 #
 #     make -f tests.mk SOLC=solc ETHVM=ethvm EVM=evm PARITY=parity-evm all
 #
+# or time the aleth interpreter on the operator tests (ALETHVM_VM selects the --vm option)
+#
+#     make -f tests.mk SOLC=solc ALETHVM=aleth-vm ops
+#
 # or build and run only a single test on a single VM
 #
 #     make -f tests.mk SOLC=solc ETHVM=ethvm pop.ran
@@ -27,6 +31,10 @@ endif
 ifdef ETHVM
 	ETHVM_ = $(call STATS,ethvm) $(ETHVM) $*.bin test; touch $*.ran
 endif
+ifdef ALETHVM
+	ALETHVM_ = $(call STATS,aleth-vm) $(ALETHVM) --vm $(ALETHVM_VM) --codefile $*.bin test; touch $*.ran
+endif
+ALETHVM_VM ?= interpreter
 ifdef EVM
 	EVM_ = $(call STATS,evm) $(EVM) --codefile $*.bin run; touch $*.ran
 endif
@@ -47,6 +55,7 @@ STATS = time -p
 # .ran files are just empty targets that indicate a program ran
 %.ran : %.bin
 	$(call ETHVM_)
+	$(call ALETHVM_)
 	$(call EVM_)
 	$(call PARITY_)
 
@@ -65,7 +74,7 @@ STATS = time -p
 %.bin : %.sol
 	$(call SOLC_SOL_)
 
-all : ops programs
+all : ops programs calls
 
 # EVM assembly programs for timing individual operators
 #
@@ -92,6 +101,10 @@ ops : \
 	div256.ran \
 	exp.ran
 
+# EVM assembly programs for timing deep CALL recursion up to the depth limit
+calls : \
+	depth.ran
+
 # C versions for comparison
 C : \
 	popincc.ran \